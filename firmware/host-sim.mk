@@ -0,0 +1,49 @@
+# Host simulator build. `make sim LEMLIB_DIR=path/to/LemLib` builds bin/sim/pushback-sim, which runs
+# src/main.cpp against the PROS shims in sim/ instead of the V5 kernel. Only the LemLib headers are vendored
+# in this project, so LEMLIB_DIR must point at a LemLib v0.5.6 source checkout.
+SIM_CXX?=g++
+SIM_LD?=ld
+SIM_OBJCOPY?=objcopy
+SIM_BINDIR=$(BINDIR)/sim
+SIM_CXXFLAGS=-std=$(CXX_STANDARD) -O2 -g -Wall -Wextra \
+	-D_PROS_INCLUDE_LIBLVGL_LLEMU_H -D_PROS_INCLUDE_LIBLVGL_LLEMU_HPP -I$(INCDIR) -I$(ROOT)/sim/include
+
+SIM_SRC=$(wildcard $(ROOT)/sim/src/*.cpp) $(call rwildcard,$(SRCDIR),*.cpp) \
+	$(if $(LEMLIB_DIR),$(shell find $(LEMLIB_DIR)/src/lemlib -name '*.cpp'))
+SIM_OBJ=$(patsubst %.cpp,$(SIM_BINDIR)/%.o,$(if $(LEMLIB_DIR),$(subst $(LEMLIB_DIR)/,lemlib/,$(SIM_SRC)),$(SIM_SRC)))
+# PATH_FILES is not defined yet, hot-cold-asset.mk is included after this file
+SIM_ASSET_OBJ=$(addprefix $(SIM_BINDIR)/,$(addsuffix .o,$(wildcard static/*))) \
+	$(addprefix $(SIM_BINDIR)/paths/,$(addsuffix .o,$(patsubst static/%.txt,static/%.path,$(wildcard static/*.txt))))
+
+.PHONY: sim
+sim: $(SIM_BINDIR)/pushback-sim
+
+$(SIM_BINDIR)/pushback-sim: $(SIM_OBJ) $(SIM_ASSET_OBJ)
+ifeq ($(LEMLIB_DIR),)
+	$(error LEMLIB_DIR must point at a LemLib v0.5.6 source checkout to build the simulator)
+endif
+	@echo "LINK $@"
+	$(VV)$(SIM_CXX) -o $@ $^ -lpthread
+
+$(SIM_BINDIR)/lemlib/%.o: $(LEMLIB_DIR)/%.cpp
+	$(VV)mkdir -p $(dir $@)
+	@echo "SIM $<"
+	$(VV)$(SIM_CXX) $(SIM_CXXFLAGS) -c -o $@ $<
+
+$(SIM_BINDIR)/%.o: %.cpp
+	$(VV)mkdir -p $(dir $@)
+	@echo "SIM $<"
+	$(VV)$(SIM_CXX) $(SIM_CXXFLAGS) -c -o $@ $<
+
+# the same symbols the firmware build gets from hot-cold-asset.mk, in the host object format
+$(SIM_BINDIR)/static/%.o: static/%
+	$(VV)mkdir -p $(dir $@)
+	@echo "SIM ASSET $@"
+	$(VV)$(SIM_LD) -r -z noexecstack -b binary -o $@ $<
+
+# compiled paths from hot-cold-asset.mk, which is included after this file
+$(SIM_BINDIR)/paths/static/%.path.o: $(BINDIR)/paths/static/%.path
+	$(VV)mkdir -p $(dir $@)
+	@echo "SIM ASSET $@"
+	$(VV)cd $(BINDIR)/paths && $(SIM_LD) -r -z noexecstack -b binary -o $(abspath $@) static/$(notdir $<)
+	$(VV)$(SIM_OBJCOPY) --set-section-alignment .data=4 $@
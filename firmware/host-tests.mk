@@ -0,0 +1,27 @@
+# Host tests and benchmarks. `make host-tests LEMLIB_DIR=path/to/LemLib` builds every sim/tests/*.cpp into
+# bin/tests/ and runs them one after the other. They link against the simulator's objects from host-sim.mk, which
+# is included before this file, so they need the same LemLib checkout. Each one prints what it measured and exits
+# with a non-zero status if one of its checks fails.
+TEST_BINDIR=$(BINDIR)/tests
+TEST_SRC=$(wildcard $(ROOT)/sim/tests/*.cpp)
+TEST_BIN=$(patsubst $(ROOT)/sim/tests/%.cpp,$(TEST_BINDIR)/%,$(TEST_SRC))
+# the simulator without either main(), as an archive so each test only links the objects it uses
+TEST_LIB=$(TEST_BINDIR)/libpushback-host.a
+
+.PHONY: host-tests
+host-tests: $(TEST_BIN)
+	$(VV)$(foreach test,$^,echo "RUN $(test)" && $(test) &&) true
+
+$(TEST_LIB): $(filter-out %/src/main.o,$(SIM_OBJ))
+ifeq ($(LEMLIB_DIR),)
+	$(error LEMLIB_DIR must point at a LemLib v0.5.6 source checkout to build the host tests)
+endif
+	$(VV)mkdir -p $(dir $@)
+	@echo "AR $@"
+	$(VV)rm -f $@
+	$(VV)ar rcs $@ $^
+
+$(TEST_BINDIR)/%: sim/tests/%.cpp $(TEST_LIB)
+	$(VV)mkdir -p $(dir $@)
+	@echo "TEST $<"
+	$(VV)$(SIM_CXX) $(SIM_CXXFLAGS) -o $@ $< $(TEST_LIB) -lpthread
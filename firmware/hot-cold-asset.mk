@@ -9,11 +9,32 @@ TEMPLATE_FILES+=$(wildcard static/*) $(wildcard firmware/hot-cold-asset.mk)
 
 ASSET_OBJ=$(addprefix $(BINDIR)/, $(addsuffix .o, $(ASSET_FILES)) )
 
-GETALLOBJ=$(sort $(call ASMOBJ,$1) $(call COBJ,$1) $(call CXXOBJ,$1)) $(ASSET_OBJ)
+# paths in static/ are also compiled to the binary format read by pushback::Path. objcopy runs inside
+# $(PATH_DIR) so the symbols match ASSET(), e.g. static/First_Long_Turn.txt becomes ASSET(First_Long_Turn_path)
+PYTHON?=python3
+PATH_DIR=$(BINDIR)/paths
+PATH_FILES=$(patsubst static/%.txt,static/%.path,$(wildcard static/*.txt))
+PATH_OBJ=$(addprefix $(PATH_DIR)/, $(addsuffix .o, $(PATH_FILES)) )
+PATH_FLAGS=--free-speed $(PATH_FREE_SPEED) --max-accel $(PATH_MAX_ACCEL) --max-lateral-accel $(PATH_MAX_LATERAL_ACCEL)
+
+GETALLOBJ=$(sort $(call ASMOBJ,$1) $(call COBJ,$1) $(call CXXOBJ,$1)) $(ASSET_OBJ) $(PATH_OBJ)
 
 .SECONDEXPANSION:
 $(ASSET_OBJ): $$(patsubst bin/%,%,$$(basename $$@))
 	$(VV)mkdir -p $(BINDIR)/static
 	$(VV)mkdir -p $(BINDIR)/static.lib
 	@echo "ASSET $@"
-	$(VV)$(OBJCOPY) -I binary -O elf32-littlearm -B arm $^ $@
\ No newline at end of file
+	$(VV)$(OBJCOPY) -I binary -O elf32-littlearm -B arm $^ $@
+
+.PRECIOUS: $(PATH_DIR)/static/%.path
+# the limits are set in the Makefile, so the paths are compiled again when it changes
+$(PATH_DIR)/static/%.path: static/%.txt tools/compile_path.py Makefile
+	$(VV)mkdir -p $(PATH_DIR)/static
+	@echo "PATH $@"
+	$(VV)$(PYTHON) tools/compile_path.py $(PATH_FLAGS) $< $@
+
+# compiled paths are read in place, so they must be aligned
+$(PATH_DIR)/static/%.path.o: $(PATH_DIR)/static/%.path
+	@echo "ASSET $@"
+	$(VV)cd $(PATH_DIR) && $(OBJCOPY) -I binary -O elf32-littlearm -B arm --set-section-alignment .data=4 \
+		static/$(notdir $<) static/$(notdir $@)
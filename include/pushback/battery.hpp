@@ -0,0 +1,112 @@
+#pragma once
+
+#include "pros/motor_group.hpp"
+#include "pushback/periodicTask.hpp"
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+
+namespace pushback {
+/**
+ * @brief Filtered battery voltage, sampled in a task
+ *
+ * The battery voltage sags by over a volt whenever the drivetrain accelerates, and recovers as soon as it stops. The
+ * reading is low-pass filtered so anything scaled by it follows the charge of the battery, not the load of the last
+ * few milliseconds. Scaling by the raw reading would feed back on itself: more voltage draws more current, which
+ * sags the battery, which asks for more voltage.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::BatteryMonitor battery;
+ *
+ * void initialize() {
+ *     battery.start();
+ * }
+ *
+ * void screen() {
+ *     pros::lcd::print(0, "Battery: %.2f V", battery.getVoltage() / 1000);
+ * }
+ * @endcode
+ */
+class BatteryMonitor {
+    public:
+        /**
+         * @brief Create a new BatteryMonitor
+         *
+         * @param period time between samples, in milliseconds. 20 by default
+         */
+        BatteryMonitor(std::uint32_t period = 20);
+        /**
+         * @brief Start sampling in a task
+         */
+        void start();
+        /**
+         * @brief Get the filtered battery voltage. Safe to call from any task
+         *
+         * @return float voltage in millivolts, 0 until the first sample
+         */
+        float getVoltage() const;
+        /**
+         * @brief Sample the battery once
+         *
+         * @param dt time since the last sample, in seconds
+         */
+        void update(float dt);
+    private:
+        std::uint32_t period;
+        PeriodicTask task;
+        std::atomic<float> voltage = 0;
+};
+
+/**
+ * @brief Motor group that drives move() at a fixed voltage instead of a fraction of the battery
+ *
+ * move() sets a duty cycle, so the same power drives the motors at a higher voltage on a fresh battery than on a
+ * drained one, and PID gains tuned in motor power only hold at the charge they were tuned at. This group turns the
+ * power into a fraction of the nominal voltage, and sends it with move_voltage, which the motor regulates.
+ *
+ * When the battery can not supply the nominal voltage any more, every command is scaled down by the same factor,
+ * taken from the shared BatteryMonitor. Both sides of the drivetrain slow down together, instead of the side
+ * commanded the most saturating first and the robot curving.
+ *
+ * Since lemlib drives the drivetrain through move(), using this group for the drivetrain compensates every lemlib
+ * motion and driver control. move_voltage() is passed through unchanged.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::BatteryMonitor battery;
+ * pushback::CompensatedMotorGroup leftMotors({-1, 2, -3}, pros::MotorGearset::blue, battery);
+ * pushback::CompensatedMotorGroup rightMotors({4, -5, 6}, pros::MotorGearset::blue, battery);
+ * lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, 10, lemlib::Omniwheel::NEW_325, 450, 2);
+ *
+ * void initialize() {
+ *     battery.start();
+ * }
+ * @endcode
+ */
+class CompensatedMotorGroup : public pros::MotorGroup {
+    public:
+        /**
+         * @brief Create a new CompensatedMotorGroup
+         *
+         * @param ports ports of the motors, negative for reversed motors
+         * @param gearset cartridge of the motors
+         * @param battery monitor the available voltage is read from. Should be started
+         * @param nominal voltage full power is mapped to, in millivolts. The lower it is, the longer into the
+         * discharge the robot behaves the same, at the cost of top speed. 12000 by default, the voltage
+         * pros::Motor::move maps full power to, so gains tuned with plain motor groups on a fresh battery still hold
+         */
+        CompensatedMotorGroup(std::initializer_list<std::int8_t> ports, pros::v5::MotorGears gearset,
+                              const BatteryMonitor& battery, float nominal = 12000);
+        /**
+         * @brief Drive the motors at a fraction of the nominal voltage
+         *
+         * @param power power from -127 to 127
+         * @return 1 if the operation was successful or PROS_ERR if the operation failed, setting errno
+         */
+        std::int32_t move(std::int32_t power) const override;
+    private:
+        const BatteryMonitor& battery;
+        float nominal;
+};
+} // namespace pushback
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace pushback {
+/**
+ * @brief What a ByteRing does with a write that does not fit
+ */
+enum class OverflowPolicy {
+    /** reject the write, keeping what is already queued */
+    DROP_NEWEST,
+    /** drop the oldest queued writes to make room, unless they are being drained */
+    OVERWRITE_OLDEST
+};
+
+/**
+ * @brief Bounded lock-free byte queue for one producer task and one consumer task
+ *
+ * Writes are copied in whole or not at all, and drained in at most two contiguous pieces per drain, one on each
+ * side of the wrap, without copying them out first.
+ *
+ * With OVERWRITE_OLDEST, the producer makes room by moving the read position forward past whole writes, so the
+ * consumer never sees part of a write. It remembers where its last Writes writes ended: with more than that queued,
+ * it may drop more than it needs to, and the writes before the remembered ones count as one. The consumer marks the
+ * read position while it drains, and the producer never overwrites a piece being drained: a write that would is
+ * dropped instead.
+ *
+ * @tparam N capacity in bytes. Must be a power of two, up to 2^30
+ * @tparam Writes number of writes remembered for OVERWRITE_OLDEST. N / 16 by default, enough for writes of 16 bytes
+ * or more
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::ByteRing<4096> ring(pushback::OverflowPolicy::OVERWRITE_OLDEST);
+ *
+ * // producer task
+ * ring.write(line.data(), line.size());
+ *
+ * // consumer task
+ * ring.drain([](const std::uint8_t* data, std::size_t size) { std::fwrite(data, 1, size, stdout); });
+ * @endcode
+ */
+template <std::size_t N, std::size_t Writes = std::max<std::size_t>(N / 16, 1)> class ByteRing {
+        static_assert(N > 0 && (N & (N - 1)) == 0 && N <= (std::size_t(1) << 30),
+                      "the capacity must be a power of two, up to 2^30");
+    public:
+        /**
+         * @brief Create a new ByteRing
+         *
+         * @param policy what to do with a write that does not fit. DROP_NEWEST by default
+         */
+        explicit ByteRing(OverflowPolicy policy = OverflowPolicy::DROP_NEWEST)
+            : policy(policy) {}
+
+        /**
+         * @brief Copy bytes to the back of the ring. Must only be called from the producer task
+         *
+         * @param data bytes to copy
+         * @param size number of bytes
+         * @return true the bytes were copied
+         * @return false the bytes were dropped, and counted
+         */
+        bool write(const void* data, std::size_t size) {
+            const std::uint32_t tail = this->tail.load(std::memory_order_relaxed);
+            if (size > N || !makeRoom(tail, size)) {
+                droppedWrites.fetch_add(1, std::memory_order_relaxed);
+                droppedBytes.fetch_add(size, std::memory_order_relaxed);
+                return false;
+            }
+            // copy in up to two pieces, around the wrap
+            const std::size_t offset = tail % N;
+            const std::size_t first = std::min(size, N - offset);
+            std::memcpy(&buffer[offset], data, first);
+            std::memcpy(&buffer[0], static_cast<const std::uint8_t*>(data) + first, size - first);
+            const std::uint32_t end = (tail + size) & POSITION_MASK;
+            ends[endCount++ % ends.size()] = end;
+            this->tail.store(end, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Pass everything written so far to a function, then free it. Must only be called from the consumer
+         * task
+         *
+         * @param consume called with a pointer to and the size of each contiguous piece, at most twice
+         * @return std::size_t number of bytes drained
+         */
+        template <typename F> std::size_t drain(F&& consume) {
+            // mark the read position, so the producer leaves the pieces alone until they are consumed
+            std::uint32_t head = this->head.load(std::memory_order_relaxed);
+            while (!this->head.compare_exchange_weak(head, head | DRAINING, std::memory_order_acquire,
+                                                     std::memory_order_relaxed)) {}
+            const std::uint32_t tail = this->tail.load(std::memory_order_acquire);
+            const std::size_t size = (tail - head) & POSITION_MASK;
+            const std::size_t offset = head % N;
+            const std::size_t first = std::min(size, N - offset);
+            if (first > 0) consume(&buffer[offset], first);
+            if (size > first) consume(&buffer[0], size - first);
+            this->head.store(tail, std::memory_order_release);
+            return size;
+        }
+
+        /**
+         * @brief Get the number of bytes queued. Exact only when called from the producer or consumer
+         *
+         * @return std::size_t
+         */
+        std::size_t size() const {
+            return (tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)) & POSITION_MASK;
+        }
+
+        /**
+         * @brief Get the number of writes dropped, either rejected or overwritten
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getDroppedWrites() const { return droppedWrites.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get the number of bytes dropped, either rejected or overwritten
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getDroppedBytes() const { return droppedBytes.load(std::memory_order_relaxed); }
+    private:
+        /** set in the read position while the consumer drains */
+        static constexpr std::uint32_t DRAINING = std::uint32_t(1) << 31;
+        /** positions wrap at 2^31, below the flag */
+        static constexpr std::uint32_t POSITION_MASK = DRAINING - 1;
+
+        /**
+         * @brief Make sure size bytes fit after tail, overwriting old writes if the policy allows it
+         */
+        bool makeRoom(std::uint32_t tail, std::size_t size) {
+            std::uint32_t head = this->head.load(std::memory_order_acquire);
+            while (true) {
+                const std::size_t used = (tail - (head & POSITION_MASK)) & POSITION_MASK;
+                if (used + size <= N) return true;
+                if (policy == OverflowPolicy::DROP_NEWEST || (head & DRAINING)) return false;
+                // drop whole writes, up to the oldest one that ends far enough along. The newest write ends at the
+                // tail, so there always is one
+                const std::uint32_t needed = used + size - N;
+                const auto along = [&](std::size_t write) { return (ends[write % Writes] - head) & POSITION_MASK; };
+                // skip the writes drained since the last overwrite, and the ones forgotten
+                std::size_t first = std::max(oldestWrite, endCount - std::min(endCount, Writes));
+                const bool forgotten = first > oldestWrite;
+                while (along(first) == 0 || along(first) > used) first++;
+                std::size_t last = first;
+                while (along(last) < needed) last++;
+                const std::uint32_t reach = along(last);
+                if (this->head.compare_exchange_weak(head, (head + reach) & POSITION_MASK, std::memory_order_acq_rel,
+                                                     std::memory_order_acquire)) {
+                    // forgotten writes that were still queued count as one
+                    droppedWrites.fetch_add(last - first + 1 + (forgotten && first == endCount - Writes),
+                                            std::memory_order_relaxed);
+                    droppedBytes.fetch_add(reach, std::memory_order_relaxed);
+                    oldestWrite = last + 1;
+                    return true;
+                }
+            }
+        }
+
+        std::array<std::uint8_t, N> buffer {};
+        OverflowPolicy policy;
+        /** position of the next byte to drain, and DRAINING while draining. Moved by the producer to overwrite */
+        std::atomic<std::uint32_t> head = 0;
+        /** position of the next byte to write, only written by the producer */
+        std::atomic<std::uint32_t> tail = 0;
+        /** where the last writes ended, newest at endCount - 1. Only used by the producer */
+        std::array<std::uint32_t, Writes> ends {};
+        std::size_t endCount = 0;
+        /** writes before this one are known to be drained or dropped. Only used by the producer */
+        std::size_t oldestWrite = 0;
+        std::atomic<std::uint32_t> droppedWrites = 0;
+        std::atomic<std::uint32_t> droppedBytes = 0;
+};
+} // namespace pushback
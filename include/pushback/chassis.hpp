@@ -0,0 +1,415 @@
+#pragma once
+
+#include "lemlib/asset.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "pushback/driveCurve.hpp"
+#include "pushback/feedforward.hpp"
+#include "pushback/motionPlan.hpp"
+#include "pushback/motionProfile.hpp"
+#include "pushback/pidTuner.hpp"
+#include "pushback/routine.hpp"
+#include "pushback/scheduledPid.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace pushback {
+/**
+ * @brief Parameters for Chassis::moveToPointProfiled
+ *
+ * We use a struct to simplify customization. Chassis::moveToPointProfiled has many
+ * parameters and specifying them all just to set one optional param harms
+ * readability. By passing a struct to the function, we can have named
+ * parameters, overcoming the c/c++ limitation
+ */
+struct MoveToPointProfiledParams {
+        /** whether the robot should move forwards or backwards. True by default */
+        bool forwards = true;
+        /** the maximum speed the robot can travel at, as a fraction of the velocity constraint in 0-127. 127 by
+         * default */
+        float maxSpeed = 127;
+        /** how far from the target the motion may end, in inches. 0 by default */
+        float earlyExitRange = 0;
+};
+
+/**
+ * @brief Parameters for Chassis::turnToHeadingProfiled
+ *
+ * We use a struct to simplify customization. Chassis::turnToHeadingProfiled has many
+ * parameters and specifying them all just to set one optional param harms
+ * readability. By passing a struct to the function, we can have named
+ * parameters, overcoming the c/c++ limitation
+ */
+struct TurnToHeadingProfiledParams {
+        /** the maximum speed the robot can turn at, as a fraction of the velocity constraint in 0-127. 127 by
+         * default */
+        float maxSpeed = 127;
+        /** how far from the target the motion may end, in degrees. 0 by default */
+        float earlyExitRange = 0;
+};
+
+/**
+ * @brief Parameters for Chassis::followTrajectory
+ *
+ * We use a struct to simplify customization. Chassis::followTrajectory has many
+ * parameters and specifying them all just to set one optional param harms
+ * readability. By passing a struct to the function, we can have named
+ * parameters, overcoming the c/c++ limitation
+ */
+struct FollowTrajectoryParams {
+        /** whether the robot should follow the path going forwards. True by default */
+        bool forwards = true;
+        /**
+         * how much faster than the compiled profile to run it. Paths are compiled well under the drivetrain's free
+         * speed, so there is headroom to spare. 1.2 by default
+         */
+        float speed = 1.2;
+        /** RAMSETE aggressiveness, like a proportional gain, in 1/inches squared. 0.03 by default */
+        float b = 0.03;
+        /** RAMSETE damping, between 0 and 1. 0.9 by default */
+        float zeta = 0.9;
+};
+
+/**
+ * @brief lemlib::Chassis with additional motion algorithms
+ *
+ * This is a drop-in replacement for lemlib::Chassis. Every lemlib motion is still available, and the motions added
+ * here use the same motion queue, so they can be mixed freely.
+ *
+ * The motions added here command wheel velocities instead of motor power. Each side of the drivetrain has a
+ * VelocityController that turns them into a voltage, so the motions take the same time regardless of battery level.
+ *
+ * Every motion returns a Motion, so a Routine can co_await it. Code that ignores it behaves exactly as with
+ * lemlib::Chassis.
+ */
+class Chassis : public lemlib::Chassis {
+    public:
+        /**
+         * @brief Chassis constructor
+         *
+         * @param drivetrain drivetrain to be used for the chassis
+         * @param lateralSettings settings for the lateral controller
+         * @param angularSettings settings for the angular controller
+         * @param sensors sensors to be used for odometry
+         * @param lateralConstraints limits for profiled lateral motions, in inches and seconds
+         * @param angularConstraints limits for profiled turns, in degrees and seconds
+         * @param feedforward drivetrain model and wheel velocity loop gains
+         * @param throttleCurve curve applied to throttle input during driver control
+         * @param steerCurve curve applied to steer input during driver control
+         */
+        Chassis(lemlib::Drivetrain drivetrain, lemlib::ControllerSettings lateralSettings,
+                lemlib::ControllerSettings angularSettings, lemlib::OdomSensors sensors,
+                ProfileConstraints lateralConstraints, ProfileConstraints angularConstraints,
+                FeedforwardSettings feedforward, lemlib::DriveCurve* throttleCurve = &lemlib::defaultDriveCurve,
+                lemlib::DriveCurve* steerCurve = &lemlib::defaultDriveCurve);
+        using lemlib::Chassis::tank;
+        /**
+         * @brief Control the robot during the driver using the tank drive control scheme, with a curve known at
+         * compile time
+         *
+         * Same as lemlib::Chassis::tank, except the curve is called directly instead of through the DriveCurve
+         * vtable, so it can be inlined into the driver control loop.
+         *
+         * @param left speed of the left side of the drivetrain. Takes an input from -127 to 127.
+         * @param right speed of the right side of the drivetrain. Takes an input from -127 to 127.
+         * @param curve curve applied to both sides
+         *
+         * @b Example
+         * @code {.cpp}
+         * pushback::LutDriveCurve throttleTable(throttleCurve);
+         *
+         * void opcontrol() {
+         *     while (true) {
+         *         chassis.tank(controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y),
+         *                      controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y), throttleTable);
+         *         pros::delay(10);
+         *     }
+         * }
+         * @endcode
+         */
+        template <typename Curve> void tank(int left, int right, const StaticDriveCurve<Curve>& curve) {
+            drivetrain.leftMotors->move(curve.evaluate(left));
+            drivetrain.rightMotors->move(curve.evaluate(right));
+        }
+        /**
+         * @brief Same as lemlib::Chassis::turnToPoint, awaitable from a Routine
+         */
+        Motion turnToPoint(float x, float y, int timeout, lemlib::TurnToPointParams params = {}, bool async = true);
+        /**
+         * @brief Same as lemlib::Chassis::turnToHeading, awaitable from a Routine
+         */
+        Motion turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params = {}, bool async = true);
+        /**
+         * @brief Same as lemlib::Chassis::swingToHeading, awaitable from a Routine
+         */
+        Motion swingToHeading(float theta, lemlib::DriveSide lockedSide, int timeout,
+                              lemlib::SwingToHeadingParams params = {}, bool async = true);
+        /**
+         * @brief Same as lemlib::Chassis::swingToPoint, awaitable from a Routine
+         */
+        Motion swingToPoint(float x, float y, lemlib::DriveSide lockedSide, int timeout,
+                            lemlib::SwingToPointParams params = {}, bool async = true);
+        /**
+         * @brief Same as lemlib::Chassis::moveToPose, awaitable from a Routine
+         */
+        Motion moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params = {},
+                          bool async = true);
+        /**
+         * @brief Same as lemlib::Chassis::moveToPoint, awaitable from a Routine
+         *
+         * @b Example
+         * @code {.cpp}
+         * pushback::Routine example() {
+         *     // start moving, and wait for the motion to finish
+         *     co_await chassis.moveToPoint(0, 48, 2000);
+         * }
+         * @endcode
+         */
+        Motion moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params = {}, bool async = true);
+        /**
+         * @brief Same as lemlib::Chassis::follow, awaitable from a Routine
+         */
+        Motion follow(const asset& path, float lookahead, int timeout, bool forwards = true, bool async = true);
+        /**
+         * @brief Move the chassis towards a point along a motion profile
+         *
+         * The robot drives in a straight line from where it starts. A jerk-limited velocity profile is computed for
+         * the distance before the motion starts, and followed with feedforward. The lateral PID only corrects the
+         * difference between where the profile says the robot should be and where it is, so it can be tuned much
+         * more aggressively than for Chassis::moveToPoint. Once the profile ends, the motion is done when the robot
+         * is within an inch of the target or has driven past it, or when the exit conditions of the lateral
+         * controller are met.
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // move to (0, 47) along a profile
+         * chassis.moveToPointProfiled(0, 47, 2000);
+         * // the timeout only needs to cover the profile and settling
+         * pros::lcd::print(0, "expected to finish in %f s", chassis.getProfileTimeLeft());
+         * @endcode
+         */
+        Motion moveToPointProfiled(float x, float y, int timeout, MoveToPointProfiledParams params = {},
+                                   bool async = true);
+        /**
+         * @brief Turn the chassis so it is facing the target heading along a motion profile
+         *
+         * The turn always takes the shortest direction. Once the profile ends, the motion is done when the robot
+         * is within a degree of the target heading or has turned past it, or when the exit conditions of the angular
+         * controller are met.
+         *
+         * @param theta heading location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // turn to face 90 degrees along a profile
+         * chassis.turnToHeadingProfiled(90, 1000);
+         * @endcode
+         */
+        Motion turnToHeadingProfiled(float theta, int timeout, TurnToHeadingProfiledParams params = {},
+                                     bool async = true);
+        /**
+         * @brief Drive a whole motion plan as one motion
+         *
+         * Lines are followed by steering towards a point ahead of the robot on the plan, so the robot rounds the
+         * corners between lines instead of stopping on them. The last line of the plan, and any line before a turn,
+         * ends at rest.
+         *
+         * @param plan the moves, turns and actions to run
+         * @param timeout longest time the robot can spend on the whole plan
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * pushback::MotionPlan plan;
+         * plan.moveTo(0, 24).moveTo(24, 48).turnTo(180);
+         * chassis.followPlan(plan, 5000);
+         * // wait until the plan is done
+         * chassis.waitUntilDone();
+         * @endcode
+         */
+        Motion followPlan(const MotionPlan& plan, int timeout, bool async = true);
+        /**
+         * @brief Follow a compiled path using pure pursuit
+         *
+         * Same as Chassis::follow, but reads the binary path compiled from the text file at build time instead of
+         * parsing the text when the motion starts. The robot drives at the velocity profile stored in the path,
+         * through the feedforward velocity layer. An asset that is not a compiled path is rejected with an error.
+         *
+         * @param path the compiled path asset, e.g. First_Long_Turn_path for static/First_Long_Turn.txt
+         * @param lookahead the lookahead distance, in inches. Larger values make the robot move faster but follow
+         * the path less accurately
+         * @param timeout the maximum time the robot can spend moving
+         * @param forwards whether the robot should follow the path going forwards. true by default
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * ASSET(First_Long_Turn_path);
+         *
+         * void autonomous() {
+         *     // follow the compiled path with a lookahead of 10 inches and a timeout of 4000ms
+         *     chassis.followPath(First_Long_Turn_path, 10, 4000);
+         * }
+         * @endcode
+         */
+        Motion followPath(const asset& path, float lookahead, int timeout, bool forwards = true, bool async = true);
+        /**
+         * @brief Follow a compiled path in time using a RAMSETE controller
+         *
+         * Pure pursuit chases a point ahead of the robot and finishes whenever it gets there. This follows the
+         * velocity profile stored in the path in time instead: at every odometry update the robot is compared to
+         * where the trajectory says it should be, and the RAMSETE controller corrects the error in position and
+         * heading on top of the trajectory's own velocity and turn rate. On the simulated robot (the "followers"
+         * scenario) it finishes each path about 30 ms sooner than followPath and stays closer to it on the way.
+         *
+         * @param path the compiled path asset, e.g. Goal_To_Goal_Turn_path for static/Goal_To_Goal_Turn.txt
+         * @param timeout the maximum time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * ASSET(Goal_To_Goal_Turn_path);
+         *
+         * void autonomous() {
+         *     chassis.setPose(30, 47.274, 135);
+         *     chassis.followTrajectory(Goal_To_Goal_Turn_path, 4000);
+         * }
+         * @endcode
+         */
+        Motion followTrajectory(const asset& path, int timeout, FollowTrajectoryParams params = {},
+                                bool async = true);
+        /**
+         * @brief Get the time left until the profile of the current motion ends
+         *
+         * @return float time in seconds, 0 if no profiled motion is running
+         */
+        float getProfileTimeLeft() const;
+        /**
+         * @brief Identify the lateral axis of the drivetrain, and suggest gains for the lateral controller
+         *
+         * The robot drives straight at a constant power from rest, until the timeout or maxDistance, while the
+         * velocity measured by odometry is recorded. A first order plus dead time model is fitted to the response,
+         * and the gains are chosen for it, see suggestGains. The suggestion and its predicted settle time and
+         * overshoot are logged to the info sink. The gains of the chassis are not changed.
+         *
+         * This blocks until the experiment is done. Leave at least maxDistance of room in front of the robot.
+         *
+         * @param params struct to simulate named parameters
+         * @return TuneResult the model, suggested settings and prediction
+         *
+         * @b Example
+         * @code {.cpp}
+         * void autonomous() {
+         *     const pushback::TuneResult lateral = chassis.tuneLateral({.power = 80, .maxDistance = 48});
+         *     pros::lcd::print(0, "kP %.2f kD %.2f", lateral.settings.kP, lateral.settings.kD);
+         * }
+         * @endcode
+         */
+        TuneResult tuneLateral(TuneParams params = {});
+        /**
+         * @brief Identify the angular axis of the drivetrain, and suggest gains for the angular controller
+         *
+         * Same as Chassis::tuneLateral, but the robot turns in place clockwise, and the model is in degrees.
+         * maxDistance is ignored.
+         *
+         * @param params struct to simulate named parameters
+         * @return TuneResult the model, suggested settings and prediction
+         */
+        TuneResult tuneAngular(TuneParams params = {});
+        /**
+         * @brief Use gain scheduled controllers instead of the constant gains in the motions added here
+         *
+         * The lemlib motions always use the gains of the ControllerSettings, since the lemlib PIDs are not
+         * replaceable. The gain tables are keyed on the distance left to the target of the motion, in inches for
+         * the lateral schedule and degrees for the angular one. When the angular controller steers a move, its
+         * distance left is the heading error. The speed tables are keyed on the speed of the robot in inches per
+         * second, and its turn rate in degrees per second.
+         *
+         * @param lateral controller for lateral corrections, nullptr for the lateral ControllerSettings
+         * @param angular controller for angular corrections, nullptr for the angular ControllerSettings
+         *
+         * @b Example
+         * @code {.cpp}
+         * constexpr auto turnGains = pushback::gainTable({{5, 3, 0, 15}, {45, 1.6, 0, 15}});
+         * pushback::ScheduledPID<turnGains> turnSchedule;
+         *
+         * void initialize() {
+         *     chassis.setGainSchedules(nullptr, &turnSchedule);
+         * }
+         * @endcode
+         */
+        void setGainSchedules(ScheduledController* lateral, ScheduledController* angular);
+    protected:
+        /**
+         * @brief Convert motor power to a wheel speed
+         *
+         * Lets the output of the lemlib PIDs, which are tuned in motor power, correct a wheel velocity
+         *
+         * @param power motor power, -127 to 127
+         * @return float wheel surface speed, in inches per second. 127 is the free speed of the drivetrain
+         */
+        float powerToSpeed(float power) const;
+        /**
+         * @brief Drive both sides of the drivetrain at a velocity
+         *
+         * If either side needs more than the battery can give, both sides are scaled down so the robot keeps its
+         * curvature.
+         *
+         * @param left velocity of the left wheels, in inches per second
+         * @param right velocity of the right wheels, in inches per second
+         * @param leftAcceleration acceleration of the left wheels, in inches per second squared
+         * @param rightAcceleration acceleration of the right wheels, in inches per second squared
+         */
+        void driveVelocity(float left, float right, float leftAcceleration = 0, float rightAcceleration = 0);
+        /**
+         * @brief Update the lateral controller, through the lateral schedule if there is one
+         *
+         * @param error lateral error, in inches
+         * @param remaining distance left to the target, in inches. The key of the lateral schedule
+         * @return float motor power
+         */
+        float updateLateral(float error, float remaining);
+        /**
+         * @brief Update the angular controller, through the angular schedule if there is one
+         *
+         * @param error angular error, in degrees
+         * @param remaining angle left to the target, in degrees. The key of the angular schedule
+         * @return float motor power
+         */
+        float updateAngular(float error, float remaining);
+        /**
+         * @brief Reset the lateral controller and its schedule
+         */
+        void resetLateral();
+        /**
+         * @brief Reset the angular controller and its schedule
+         */
+        void resetAngular();
+        /**
+         * @brief Run a step response experiment on one axis, see tuneLateral
+         *
+         * @param angular whether to turn in place instead of driving straight
+         * @param params struct to simulate named parameters
+         */
+        TuneResult tune(bool angular, TuneParams params);
+
+        ProfileConstraints lateralConstraints;
+        ProfileConstraints angularConstraints;
+        VelocityController leftVelocity;
+        VelocityController rightVelocity;
+        /** time the profile of the current motion ends, in milliseconds. 0 if no profiled motion is running */
+        std::atomic<std::uint32_t> profileEnd = 0;
+        /** gain scheduled controllers, nullptr to use lateralPID and angularPID */
+        ScheduledController* lateralSchedule = nullptr;
+        ScheduledController* angularSchedule = nullptr;
+};
+} // namespace pushback
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "pros/misc.hpp"
+#include "pushback/periodicTask.hpp"
+#include "pushback/seqlock.hpp"
+#include "pushback/spscQueue.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace pushback {
+/** number of buttons on a controller, L1 to A */
+constexpr int CONTROLLER_BUTTONS = 12;
+
+/**
+ * @brief State of every controller channel, sampled at the same time
+ */
+struct ControllerSnapshot {
+        /** joystick positions, -127 to 127, indexed by pros::controller_analog_e_t */
+        std::array<std::int8_t, 4> analog;
+        /** one bit per button, L1 is bit 0 */
+        std::uint16_t buttons;
+        /** time of the sample, in milliseconds */
+        std::uint32_t time;
+
+        /**
+         * @brief Whether a button is held down
+         */
+        bool isPressed(pros::controller_digital_e_t button) const {
+            return buttons & (1 << (button - pros::E_CONTROLLER_DIGITAL_L1));
+        }
+
+        /**
+         * @brief Get the position of a joystick axis, -127 to 127
+         */
+        int getAnalog(pros::controller_analog_e_t channel) const { return analog[channel]; }
+};
+
+/**
+ * @brief A button being pressed or released
+ */
+struct ButtonEvent {
+        pros::controller_digital_e_t button;
+        /** true when the button was pressed, false when it was released */
+        bool pressed;
+        /** time of the sample the change was seen in, in milliseconds */
+        std::uint32_t time;
+};
+
+/**
+ * @brief Samples a controller in its own task
+ *
+ * Every channel is read in one pass, faster than the driver control loop runs, so a press shorter than the loop is
+ * still seen. Each pass publishes a snapshot, and every button change is pushed to a queue of events with the time
+ * it was seen.
+ *
+ * Events can either be taken from the queue with poll(), from a single task, or handled by functions registered
+ * with onPress() and onRelease(). Handlers are called from the sampling task, so they should return quickly.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::ControllerInput input(controller);
+ *
+ * void initialize() {
+ *     input.onPress(pros::E_CONTROLLER_DIGITAL_A, [] { Loader.set_value(true); });
+ *     input.start();
+ * }
+ *
+ * void opcontrol() {
+ *     while (true) {
+ *         const pushback::ControllerSnapshot state = input.getSnapshot();
+ *         chassis.tank(state.getAnalog(pros::E_CONTROLLER_ANALOG_LEFT_Y),
+ *                      state.getAnalog(pros::E_CONTROLLER_ANALOG_RIGHT_Y));
+ *         pushback::ButtonEvent event;
+ *         while (input.poll(event)) {
+ *             if (event.button == pros::E_CONTROLLER_DIGITAL_DOWN && event.pressed) toggleLoader();
+ *         }
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class ControllerInput {
+    public:
+        /**
+         * @brief Create a new ControllerInput
+         *
+         * @param controller the controller to sample
+         * @param period time between samples, in milliseconds. 5 by default
+         */
+        explicit ControllerInput(pros::Controller& controller, std::uint32_t period = 5);
+        /**
+         * @brief Start sampling in a task
+         */
+        void start();
+        /**
+         * @brief Get the most recent sample. Safe to call from any task
+         *
+         * @return ControllerSnapshot
+         */
+        ControllerSnapshot getSnapshot() const;
+        /**
+         * @brief Take the oldest button event from the queue. Must only be called from one task
+         *
+         * @param event set to the event taken
+         * @return whether there was an event
+         */
+        bool poll(ButtonEvent& event);
+        /**
+         * @brief Call a function when a button is pressed. Must be called before start()
+         *
+         * @param button the button
+         * @param handler the function, called from the sampling task
+         */
+        void onPress(pros::controller_digital_e_t button, std::function<void()> handler);
+        /**
+         * @brief Call a function when a button is released. Must be called before start()
+         *
+         * @param button the button
+         * @param handler the function, called from the sampling task
+         */
+        void onRelease(pros::controller_digital_e_t button, std::function<void()> handler);
+        /**
+         * @brief Get the number of events dropped because the queue was full
+         */
+        std::uint32_t getDropped() const;
+        /**
+         * @brief Sample the controller once
+         */
+        void update();
+    private:
+        pros::Controller& controller;
+        std::uint32_t period;
+        PeriodicTask task;
+        SeqLock<ControllerSnapshot> snapshot;
+        SpscQueue<ButtonEvent, 64> events;
+        std::atomic<std::uint32_t> dropped = 0;
+        std::uint16_t lastButtons = 0;
+        /** handlers for each button, press then release */
+        std::array<std::array<std::function<void()>, 2>, CONTROLLER_BUTTONS> handlers;
+};
+} // namespace pushback
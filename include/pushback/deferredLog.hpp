@@ -0,0 +1,377 @@
+#pragma once
+
+#include "lemlib/logger/baseSink.hpp" // IWYU pragma: keep, includes fmt the way lemlib builds it
+#include "lemlib/logger/message.hpp"
+#include "lemlib/pose.hpp"
+#include "pros/rtos.hpp"
+#include "pushback/periodicTask.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Lowest level of the messages compiled in, as a lemlib::Level value: 0 INFO, 1 DEBUG, 2 WARN, 3 ERROR, 4 FATAL. The
+ * levels use the order of lemlib::BaseSink::setLowestLevel. Logs below it compile to nothing. `make COMPETITION=1`
+ * sets it to 2, leaving out INFO and DEBUG logs.
+ */
+#ifndef PUSHBACK_MIN_LOG_LEVEL
+#define PUSHBACK_MIN_LOG_LEVEL 0
+#endif
+
+/**
+ * @brief Log to a DeferredLog, evaluating the arguments only if the level is enabled
+ *
+ * The member functions of DeferredLog take their arguments after they are evaluated, even when the level is
+ * disabled. Use these for messages whose arguments are expensive, like a pose or a motor reading. Below
+ * PUSHBACK_MIN_LOG_LEVEL, the whole statement compiles to nothing. Otherwise it checks the level first, and only
+ * evaluates the arguments and logs when it is enabled. The check is marked as likely to skip, so a disabled log
+ * costs a load and a predicted branch. The level must be a constant.
+ *
+ * @b Example
+ * @code {.cpp}
+ * PUSHBACK_LOG_DEBUG(telemetry, "Left motors: {} mA", leftMotors.get_current_draw());
+ * @endcode
+ */
+#define PUSHBACK_LOG(sink, level, ...)                                                                                \
+    do {                                                                                                               \
+        if constexpr (pushback::isCompiledIn(level)) {                                                                 \
+            if ((sink).isEnabled(level)) [[unlikely]] (sink).log(level, __VA_ARGS__);                                  \
+        }                                                                                                              \
+    } while (false)
+#define PUSHBACK_LOG_DEBUG(sink, ...) PUSHBACK_LOG(sink, lemlib::Level::DEBUG, __VA_ARGS__)
+#define PUSHBACK_LOG_INFO(sink, ...) PUSHBACK_LOG(sink, lemlib::Level::INFO, __VA_ARGS__)
+#define PUSHBACK_LOG_WARN(sink, ...) PUSHBACK_LOG(sink, lemlib::Level::WARN, __VA_ARGS__)
+#define PUSHBACK_LOG_ERROR(sink, ...) PUSHBACK_LOG(sink, lemlib::Level::ERROR, __VA_ARGS__)
+#define PUSHBACK_LOG_FATAL(sink, ...) PUSHBACK_LOG(sink, lemlib::Level::FATAL, __VA_ARGS__)
+
+namespace pushback {
+/**
+ * @brief Check whether logs of a level are compiled in, see PUSHBACK_MIN_LOG_LEVEL
+ *
+ * @param level level of the log
+ * @return true logs of the level are compiled in
+ */
+constexpr bool isCompiledIn(lemlib::Level level) { return static_cast<int>(level) >= PUSHBACK_MIN_LOG_LEVEL; }
+
+/** most format strings a DeferredLog can tell apart */
+constexpr std::size_t DEFERRED_LOG_FORMATS = 128;
+/** most records a DeferredLog holds between drains. Records logged past it are dropped */
+constexpr std::size_t DEFERRED_LOG_RECORDS = 128;
+/** bytes of arguments one record carries. Arguments past it are left out */
+constexpr std::size_t DEFERRED_LOG_ARG_BYTES = 52;
+
+/**
+ * @brief Type tag of an argument in a deferred log record
+ *
+ * The values are part of the binary format read by tools/decode_log.py, so they must not change.
+ */
+enum class LogArg : std::uint8_t {
+    BOOL = 0, // 1 byte
+    INT = 1, // int32
+    UINT = 2, // uint32
+    INT64 = 3, // int64
+    UINT64 = 4, // uint64
+    FLOAT = 5, // float32
+    DOUBLE = 6, // float64
+    STRING = 7, // uint8 length, then the characters
+    POSE = 8, // x, y, theta as float32
+    CHAR = 9, // 1 byte
+};
+
+/**
+ * @brief Logger that stores the arguments of a message instead of formatting it
+ *
+ * lemlib::BaseSink::log formats every message on the brain, twice, allocating a string each time. A DeferredLog
+ * copies a small binary record instead: the id of the format string, the time, the level and the raw bytes of the
+ * arguments. A task drains the records to an output, such as the serial port, and tools/decode_log.py formats them
+ * on the computer. Each format string is sent before the first record that uses it, and sent again before a record
+ * once 2 seconds have passed, so a decoder started after the program can still read the records.
+ *
+ * Logging is safe from any task, and never blocks. When the records are not drained fast enough, new ones are
+ * dropped and counted. Arguments may be bools, chars, integers, enums, floats, doubles, strings and lemlib::Pose.
+ * Strings are copied, up to 255 characters.
+ *
+ * The output is a stream of frames, little endian:
+ *
+ *     sync      0xA5 0x5A
+ *     type      uint8, 0 for a format string, 1 for a record
+ *     length    uint8, bytes in the body
+ *     body      a format string: id (uint8), then the format string, cut to 254 bytes
+ *               a record: id (uint8), level (uint8, lemlib::Level), time (uint32, milliseconds), then the
+ *               arguments, each a LogArg tag (uint8) followed by its value
+ *     checksum  uint8, sum of the type, length and body bytes
+ *
+ * Text written to the same stream between frames is passed through by the decoder.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::DeferredLog telemetry([](const std::uint8_t* data, std::size_t size) {
+ *     std::fwrite(data, 1, size, stdout);
+ * });
+ *
+ * void initialize() {
+ *     telemetry.start();
+ * }
+ *
+ * void logPose() {
+ *     telemetry.info("Chassis pose: {}", chassis.getPose());
+ * }
+ * @endcode
+ *
+ * then, on the computer: pros terminal --raw | python3 tools/decode_log.py
+ */
+class DeferredLog {
+    public:
+        /**
+         * @brief Create a new DeferredLog
+         *
+         * @param write called by the drain with the encoded frames
+         * @param period time between drains, in milliseconds. 20 by default
+         */
+        DeferredLog(std::function<void(const std::uint8_t* data, std::size_t size)> write, std::uint32_t period = 20);
+        /**
+         * @brief Start draining in a task
+         */
+        void start();
+        /**
+         * @brief Drain every record logged so far to the output. Must only be called from one task
+         */
+        void drain();
+        /**
+         * @brief Set the lowest level. Messages below it are ignored
+         *
+         * @param level uses the order of lemlib::BaseSink::setLowestLevel
+         */
+        void setLowestLevel(lemlib::Level level);
+        /**
+         * @brief Turn the log on or off. A log that is off ignores every message. On by default
+         *
+         * @param enabled whether to log
+         */
+        void setEnabled(bool enabled);
+
+        /**
+         * @brief Check whether messages of a level are logged
+         *
+         * @param level level of the message
+         * @return true the level is compiled in, the log is on and the level is not below the lowest level
+         */
+        bool isEnabled(lemlib::Level level) const {
+            return isCompiledIn(level) && enabled.load(std::memory_order_relaxed) &&
+                   level >= lowestLevel.load(std::memory_order_relaxed);
+        }
+        /**
+         * @brief Get the number of records dropped since the log was created
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getDropped() const;
+
+        /**
+         * @brief Log a message at the given level
+         *
+         * Below PUSHBACK_MIN_LOG_LEVEL, this compiles to nothing, though the arguments are still evaluated if they
+         * have side effects. See PUSHBACK_LOG to skip them.
+         *
+         * @param level level of the message
+         * @param format format of the message, with "{}" as placeholders
+         * @param args values substituted into the placeholders by the decoder
+         */
+        template <typename... T> void log(lemlib::Level level, fmt::format_string<T...> format, T&&... args) {
+            if (!isEnabled(level)) return;
+            const int id = findFormat({format.get().data(), format.get().size()});
+            if (id < 0) {
+                // no room for another format string
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            std::uint32_t position = tail.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &slots[position % DEFERRED_LOG_RECORDS];
+                const std::int32_t lag = std::int32_t(slot->sequence.load(std::memory_order_acquire) - position);
+                if (lag == 0) {
+                    if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+                } else if (lag < 0) {
+                    // the drain has not caught up
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                } else position = tail.load(std::memory_order_relaxed);
+            }
+
+            slot->id = id;
+            slot->level = static_cast<std::uint8_t>(level);
+            slot->time = pros::millis();
+            slot->size = 0;
+            slot->full = false;
+            (encode(*slot, args), ...);
+            slot->sequence.store(position + 1, std::memory_order_release);
+        }
+
+        template <typename... T> void debug(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiledIn(lemlib::Level::DEBUG)) {
+                log(lemlib::Level::DEBUG, format, std::forward<T>(args)...);
+            }
+        }
+
+        template <typename... T> void info(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiledIn(lemlib::Level::INFO)) {
+                log(lemlib::Level::INFO, format, std::forward<T>(args)...);
+            }
+        }
+
+        template <typename... T> void warn(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiledIn(lemlib::Level::WARN)) {
+                log(lemlib::Level::WARN, format, std::forward<T>(args)...);
+            }
+        }
+
+        template <typename... T> void error(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiledIn(lemlib::Level::ERROR)) {
+                log(lemlib::Level::ERROR, format, std::forward<T>(args)...);
+            }
+        }
+
+        template <typename... T> void fatal(fmt::format_string<T...> format, T&&... args) {
+            if constexpr (isCompiledIn(lemlib::Level::FATAL)) {
+                log(lemlib::Level::FATAL, format, std::forward<T>(args)...);
+            }
+        }
+    private:
+        /**
+         * @brief One record, and the sequence number that hands it between the loggers and the drain
+         */
+        struct Slot {
+                /** position the slot is free for, plus one once the record at it is written */
+                std::atomic<std::uint32_t> sequence = 0;
+                std::uint8_t id = 0;
+                std::uint8_t level = 0;
+                std::uint8_t size = 0;
+                /** whether an argument was left out, so the ones after it are too */
+                bool full = false;
+                std::uint32_t time = 0;
+                std::array<std::uint8_t, DEFERRED_LOG_ARG_BYTES> args {};
+        };
+
+        /**
+         * @brief Get the slot a format string starts probing at
+         */
+        static std::size_t hashFormat(const char* format) {
+            const auto address = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(format));
+            return (address * 2654435761u >> 16) % DEFERRED_LOG_FORMATS;
+        }
+
+        /**
+         * @brief Get the id of a format string, registering it the first time it is seen
+         *
+         * Format strings are told apart by their address, so looking one up never reads the string.
+         *
+         * @return int the id, -1 if there is no room for another format string
+         */
+        int findFormat(std::string_view format) {
+            std::size_t index = hashFormat(format.data());
+            for (std::size_t probe = 0; probe < DEFERRED_LOG_FORMATS; probe++) {
+                const char* found = formats[index].load(std::memory_order_acquire);
+                if (found == format.data()) return index;
+                if (found == nullptr) return addFormat(format);
+                index = (index + 1) % DEFERRED_LOG_FORMATS;
+            }
+            return -1;
+        }
+
+        /**
+         * @brief Register a format string. Called the first time it is seen
+         */
+        int addFormat(std::string_view format);
+
+        /**
+         * @brief Append a tagged value to a record. Values that do not fit are left out
+         */
+        static void append(Slot& slot, LogArg tag, const void* value, std::size_t size) {
+            // leave the rest out too, so the decoder never pairs an argument with the wrong placeholder
+            if (slot.full || slot.size + 1 + size > DEFERRED_LOG_ARG_BYTES) {
+                slot.full = true;
+                return;
+            }
+            slot.args[slot.size] = static_cast<std::uint8_t>(tag);
+            std::memcpy(&slot.args[slot.size + 1], value, size);
+            slot.size += 1 + size;
+        }
+
+        static void appendString(Slot& slot, std::string_view value) {
+            if (slot.full || slot.size + 2u > DEFERRED_LOG_ARG_BYTES) {
+                slot.full = true;
+                return;
+            }
+            // strings are cut to the room left, rather than left out
+            std::size_t length = std::min(value.size(), std::size_t(255));
+            length = std::min(length, DEFERRED_LOG_ARG_BYTES - slot.size - 2);
+            slot.args[slot.size] = static_cast<std::uint8_t>(LogArg::STRING);
+            slot.args[slot.size + 1] = length;
+            std::memcpy(&slot.args[slot.size + 2], value.data(), length);
+            slot.size += 2 + length;
+        }
+
+        template <typename T> static void encode(Slot& slot, const T& arg) {
+            using Value = std::remove_cvref_t<T>;
+            if constexpr (std::is_same_v<Value, bool>) append(slot, LogArg::BOOL, &arg, 1);
+            else if constexpr (std::is_same_v<Value, char>) append(slot, LogArg::CHAR, &arg, 1);
+            else if constexpr (std::is_enum_v<Value>) encode(slot, static_cast<std::underlying_type_t<Value>>(arg));
+            else if constexpr (std::is_integral_v<Value> && sizeof(Value) <= 4) {
+                if constexpr (std::is_signed_v<Value>) {
+                    const std::int32_t value = arg;
+                    append(slot, LogArg::INT, &value, 4);
+                } else {
+                    const std::uint32_t value = arg;
+                    append(slot, LogArg::UINT, &value, 4);
+                }
+            } else if constexpr (std::is_integral_v<Value>) {
+                if constexpr (std::is_signed_v<Value>) {
+                    const std::int64_t value = arg;
+                    append(slot, LogArg::INT64, &value, 8);
+                } else {
+                    const std::uint64_t value = arg;
+                    append(slot, LogArg::UINT64, &value, 8);
+                }
+            } else if constexpr (std::is_same_v<Value, float>) append(slot, LogArg::FLOAT, &arg, 4);
+            else if constexpr (std::is_same_v<Value, double>) append(slot, LogArg::DOUBLE, &arg, 8);
+            else if constexpr (std::is_same_v<Value, lemlib::Pose>) {
+                const float values[3] = {arg.x, arg.y, arg.theta};
+                append(slot, LogArg::POSE, values, sizeof(values));
+            } else if constexpr (std::is_convertible_v<const Value&, std::string_view>) appendString(slot, arg);
+            else static_assert(sizeof(Value) == 0, "this type can not be logged by a DeferredLog");
+        }
+
+        std::function<void(const std::uint8_t* data, std::size_t size)> write;
+        std::uint32_t period;
+        PeriodicTask task;
+        std::atomic<lemlib::Level> lowestLevel = lemlib::Level::INFO;
+        std::atomic<bool> enabled = true;
+        std::atomic<std::uint32_t> dropped = 0;
+
+        std::array<Slot, DEFERRED_LOG_RECORDS> slots;
+        /** position of the next record to log, shared by the loggers */
+        std::atomic<std::uint32_t> tail = 0;
+        /** position of the next record to drain, only used by the drain */
+        std::uint32_t head = 0;
+
+        /** format strings by id, nullptr if the id is free. An id is the slot its format string hashes to */
+        std::array<std::atomic<const char*>, DEFERRED_LOG_FORMATS> formats {};
+        std::array<std::size_t, DEFERRED_LOG_FORMATS> formatSizes {};
+        /** held while registering a format string */
+        pros::Mutex formatMutex;
+        /** format strings sent since the last resend, only used by the drain */
+        std::bitset<DEFERRED_LOG_FORMATS> sent;
+        /** time of the last resend, only used by the drain */
+        std::uint32_t formatsSentAt = 0;
+};
+} // namespace pushback
@@ -0,0 +1,83 @@
+#pragma once
+
+// lemlib/driveCurve.hpp has no include guard, it is included through the chassis header which has one
+#include "lemlib/chassis/chassis.hpp"
+#include <algorithm>
+#include <array>
+
+namespace pushback {
+/**
+ * @brief Drive curve base that can be called without virtual dispatch
+ *
+ * A curve derives from this with itself as the template argument and implements evaluate(). lemlib sees an ordinary
+ * lemlib::DriveCurve, while code that knows the concrete type, like the Chassis::tank overload taking a
+ * StaticDriveCurve, calls evaluate() directly and lets the compiler inline it.
+ */
+template <typename Derived> class StaticDriveCurve : public lemlib::DriveCurve {
+    public:
+        /**
+         * @brief Curve an input. Called by lemlib through the DriveCurve vtable
+         *
+         * @param input the input to curve
+         * @return float the curved output
+         */
+        float curve(float input) override { return evaluate(input); }
+        /**
+         * @brief Curve an input without virtual dispatch
+         *
+         * @param input the input to curve
+         * @return float the curved output
+         */
+        float evaluate(float input) const { return static_cast<const Derived&>(*this).evaluate(input); }
+};
+
+/**
+ * @brief A drive curve baked into a lookup table
+ *
+ * The source curve is evaluated once for every controller input from -127 to 127 when the table is built, so the
+ * output for those inputs is exactly what the source curve returns, without any exp or pow at runtime. Inputs between
+ * two integers are interpolated, and inputs outside -127 to 127 are clamped.
+ *
+ * @b Example
+ * @code {.cpp}
+ * lemlib::ExpoDriveCurve throttleCurve(3, 10, 1.019);
+ * pushback::LutDriveCurve throttleTable(throttleCurve);
+ *
+ * void opcontrol() {
+ *     while (true) {
+ *         // the curve is inlined, no virtual call
+ *         chassis.tank(controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y),
+ *                      controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y), throttleTable);
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class LutDriveCurve final : public StaticDriveCurve<LutDriveCurve> {
+    public:
+        /**
+         * @brief Build the table from another curve
+         *
+         * @param source the curve to bake. It is only used by the constructor
+         */
+        explicit LutDriveCurve(lemlib::DriveCurve& source);
+        /**
+         * @brief Curve an input from the table
+         *
+         * Defined in the header so it can be inlined into the caller.
+         *
+         * @param input the input to curve
+         * @return float the curved output
+         */
+        float evaluate(float input) const {
+            const float position = std::clamp(input, -127.0f, 127.0f) + 127;
+            const int index = static_cast<int>(position);
+            const float fraction = position - index;
+            if (fraction == 0) return table[index];
+            return table[index] + fraction * (table[index + 1] - table[index]);
+        }
+    private:
+        /** output for every input from -127 to 127 */
+        std::array<float, 255> table;
+};
+} // namespace pushback
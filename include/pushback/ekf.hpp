@@ -0,0 +1,147 @@
+#pragma once
+
+#include "lemlib/pose.hpp"
+#include "pros/gps.hpp"
+#include "pushback/field.hpp"
+#include "pushback/matrix.hpp"
+#include "pushback/periodicTask.hpp"
+#include "pushback/seqlock.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace pushback {
+/**
+ * @brief Tuning for the extended Kalman filter
+ *
+ * The defaults are a reasonable starting point for a drivetrain with tracking wheels and a V5 IMU.
+ */
+struct EkfSettings {
+        /** field pose of the odometry origin, i.e. the pose passed to chassis.setPose() at the start of the run */
+        lemlib::Pose origin {0, 0, 0};
+        /** position variance added per inch traveled, in square inches */
+        float travelNoise = 0.03;
+        /** heading variance added per radian turned, in square radians */
+        float turnNoise = 0.0005;
+        /** random walk of the IMU heading, in degrees per square root of a second */
+        float driftNoise = 0.01;
+        /** standard deviation of a distance sensor reading, in inches, and as a fraction of the reading.
+         * The larger of the two is used. The V5 sensor is rated for 15mm below 200mm and 5% above */
+        float distanceNoise = 0.6;
+        float distanceNoiseRatio = 0.05;
+        /** distance readings with a lower confidence are ignored. The sensor reports 0-63 */
+        std::int32_t minConfidence = 40;
+        /** distance readings further than this are ignored, in inches */
+        float maxDistance = 60;
+        /** GPS readings with a higher reported error are ignored, in inches */
+        float maxGpsError = 2;
+        /** innovations further than this many standard deviations away are rejected as outliers */
+        float gate = 3;
+        /** half the inside length of the field perimeter, in inches */
+        float fieldHalfWidth = FIELD_HALF_WIDTH;
+};
+
+/**
+ * @brief Extended Kalman filter that corrects lemlib odometry against the field perimeter
+ *
+ * Prediction uses the motion measured by lemlib odometry (tracking wheels and IMU). Distance sensor readings
+ * against the field walls, and optionally a GPS sensor, are used as corrections. The corrected pose is written
+ * back to lemlib through shiftPose, so the motion algorithms use it without any changes.
+ *
+ * The filter works in field coordinates: origin at the center of the field, +y away from the driver station.
+ * Odometry must stay anchored at EkfSettings::origin. If chassis.setPose() is called while the filter is running,
+ * the filter restarts from the new pose.
+ *
+ * All matrices are fixed size, so the filter does not allocate after it is constructed.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::Ekf ekf({.origin = {-48, -61, 0}}, {{&Back, 0, -7.5, 180}, {&Right, 7.5, 0, 90}});
+ *
+ * void autonomous() {
+ *     chassis.setPose(0, 0, 0);
+ *     ekf.start();
+ * }
+ * @endcode
+ */
+class Ekf {
+    public:
+        /**
+         * @brief Create a new Ekf
+         *
+         * @param settings filter tuning
+         * @param distanceSensors distance sensors used for corrections
+         * @param gps optional GPS sensor, nullptr if not used. The GPS offset must be set with set_offset()
+         */
+        Ekf(EkfSettings settings, std::vector<DistanceMount> distanceSensors, pros::Gps* gps = nullptr);
+        /**
+         * @brief Start running the filter in a task, every 10ms
+         */
+        void start();
+        /**
+         * @brief Run one step of the filter
+         */
+        void update();
+        /**
+         * @brief Get the estimated pose in field coordinates. Safe to call from any task
+         *
+         * @param radians true for theta in radians, false for degrees. False by default
+         * @return lemlib::Pose
+         */
+        lemlib::Pose getFieldPose(bool radians = false) const;
+        /**
+         * @brief Get the standard deviation of the estimate. Safe to call from any task
+         *
+         * @return lemlib::Pose x and y in inches, theta in degrees
+         */
+        lemlib::Pose getStdDev() const;
+        /**
+         * @brief Get the number of corrections that were applied and rejected as outliers
+         */
+        std::uint32_t getAccepted() const;
+        std::uint32_t getRejected() const;
+    private:
+        /**
+         * @brief The estimate, as other tasks read it
+         */
+        struct Estimate {
+                /** field pose, theta in radians */
+                lemlib::Pose pose;
+                /** x and y in inches, theta in degrees */
+                lemlib::Pose stdDev;
+        };
+
+        void reset(const lemlib::Pose& odom);
+        /**
+         * @brief Publish the state and covariance to other tasks
+         */
+        void publish();
+        void predict(const lemlib::Pose& delta);
+        /**
+         * @brief Apply a scalar measurement
+         *
+         * @return whether the measurement passed the outlier gate
+         */
+        bool correct(float innovation, const Matrix<1, 3>& H, float variance);
+        bool correctDistance(const DistanceMount& mount);
+        bool correctGps();
+        float expectedDistance(const Vector3& state, const DistanceMount& mount) const;
+
+        EkfSettings settings;
+        std::vector<DistanceMount> distanceSensors;
+        pros::Gps* gps;
+
+        /** field x, field y, heading in radians */
+        Vector3 state;
+        Matrix3 covariance;
+        /** odometry pose at the last update, in radians */
+        lemlib::Pose lastOdom {0, 0, 0};
+        bool initialized = false;
+        PeriodicTask task;
+        std::uint32_t lastUpdate = 0;
+        std::uint32_t ticks = 0;
+        std::atomic<std::uint32_t> accepted = 0;
+        std::atomic<std::uint32_t> rejected = 0;
+        SeqLock<Estimate> estimate;
+};
+} // namespace pushback
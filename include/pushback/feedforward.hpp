@@ -0,0 +1,82 @@
+#pragma once
+
+#include "pros/motor_group.hpp"
+#include "pushback/motorTelemetry.hpp"
+#include <cstdint>
+
+namespace pushback {
+/**
+ * @brief Drivetrain model and wheel velocity loop gains
+ *
+ * All gains output millivolts. Velocities are the surface speed of the wheels, in inches per second.
+ *
+ * kS, kV and kA can be measured by ramping the voltage slowly (kS is where the robot starts moving, kV is the slope
+ * of voltage against speed), then stepping it (kA is the leftover voltage divided by the acceleration).
+ */
+struct FeedforwardSettings {
+        /** voltage needed to overcome static friction */
+        float kS;
+        /** voltage per inch per second */
+        float kV;
+        /** voltage per inch per second squared */
+        float kA;
+        /** proportional gain of the velocity loop, voltage per inch per second of error */
+        float kP = 0;
+        /** integral gain of the velocity loop, voltage per inch of accumulated error */
+        float kI = 0;
+};
+
+/**
+ * @brief Drives one side of the drivetrain at a commanded wheel velocity
+ *
+ * The voltage is the sum of the feedforward model and a PI loop on the velocity measured by the motors. The output
+ * is sent with move_voltage, so unlike move it does not depend on how the motor's internal controller maps power
+ * to voltage, and stays the same as the battery drains.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::VelocityController left(&leftMotors, lemlib::Omniwheel::NEW_325, 450, {600, 150, 20, 30});
+ * // 40 inches per second, not accelerating
+ * leftMotors.move_voltage(left.update(40, 0));
+ * @endcode
+ */
+class VelocityController {
+    public:
+        /**
+         * @brief Create a new VelocityController
+         *
+         * @param motors motors on this side of the drivetrain
+         * @param wheelDiameter diameter of the wheels, in inches
+         * @param rpm rpm of the wheels
+         * @param settings model and loop gains
+         */
+        VelocityController(pros::MotorGroup* motors, float wheelDiameter, float rpm, FeedforwardSettings settings);
+        /**
+         * @brief Calculate the voltage for one control cycle
+         *
+         * @param velocity target velocity, in inches per second
+         * @param acceleration target acceleration, in inches per second squared
+         * @return float voltage, in millivolts. Not clamped
+         */
+        float update(float velocity, float acceleration);
+        /**
+         * @brief Reset the integral of the velocity loop
+         */
+        void reset();
+        /**
+         * @brief Get the average velocity of the wheels, measured by the motors
+         *
+         * @return float velocity, in inches per second
+         */
+        float getVelocity() const;
+    private:
+        pros::MotorGroup* motors;
+        /** reads the velocities without the allocation of get_actual_velocity_all */
+        MotorSampler sampler;
+        float wheelDiameter;
+        float rpm;
+        FeedforwardSettings settings;
+        float integral = 0;
+        std::uint32_t lastTime = 0;
+};
+} // namespace pushback
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "lemlib/pose.hpp"
+#include "pros/distance.hpp"
+
+namespace pushback {
+/** half the inside length of the field perimeter, in inches */
+constexpr float FIELD_HALF_WIDTH = 70.2;
+
+/**
+ * @brief A distance sensor pointed at the field perimeter
+ *
+ * The mounting position is relative to the tracking center, with +y pointing forwards and +x pointing to the right.
+ */
+struct DistanceMount {
+        pros::Distance* sensor;
+        /** position of the sensor face, in inches */
+        float x;
+        float y;
+        /** direction the sensor faces, in degrees clockwise from the front of the robot */
+        float heading;
+};
+
+/**
+ * @brief Where a ray from inside the field hits the perimeter
+ */
+struct WallHit {
+        /** distance to the wall, in inches */
+        float distance;
+        /** false if the ray hits at a grazing angle or close to a corner, where a distance sensor is unreliable */
+        bool valid;
+};
+
+/**
+ * @brief Cast a ray from inside the field to the perimeter
+ *
+ * @param x ray origin, in field coordinates
+ * @param y ray origin, in field coordinates
+ * @param heading ray direction, in radians clockwise from +y
+ * @param halfWidth half the inside length of the perimeter
+ * @return WallHit
+ */
+WallHit castRay(float x, float y, float heading, float halfWidth = FIELD_HALF_WIDTH);
+
+/**
+ * @brief Convert an odometry pose to field coordinates
+ *
+ * @param origin field pose of the odometry origin, theta in degrees
+ * @param odom odometry pose, theta in radians
+ * @return lemlib::Pose field pose, theta in radians
+ */
+lemlib::Pose toField(const lemlib::Pose& origin, const lemlib::Pose& odom);
+
+/**
+ * @brief Convert a field pose to odometry coordinates
+ *
+ * @param origin field pose of the odometry origin, theta in degrees
+ * @param field field pose, theta in radians
+ * @return lemlib::Pose odometry pose, theta in radians
+ */
+lemlib::Pose toOdom(const lemlib::Pose& origin, const lemlib::Pose& field);
+} // namespace pushback
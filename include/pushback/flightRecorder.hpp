@@ -0,0 +1,252 @@
+#pragma once
+
+#include "pushback/chassis.hpp"
+#include "pushback/controllerInput.hpp"
+#include "pushback/motorTelemetry.hpp"
+#include "pushback/periodicTask.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pushback {
+/** size of each of the two blocks of a FlightRecorder, in bytes. Each write to the card is at most one block */
+constexpr std::size_t FLIGHT_RECORDER_BLOCK_SIZE = 8192;
+static_assert(FLIGHT_RECORDER_BLOCK_SIZE >= 4096 && FLIGHT_RECORDER_BLOCK_SIZE <= 16384,
+              "blocks smaller than 4 KB make too many writes, larger ones lose too much at power off");
+
+/** "PBF1", the first four bytes of a flight recording */
+constexpr std::uint32_t FLIGHT_MAGIC = 0x31464250;
+
+/**
+ * @brief Header at the start of a flight recording
+ */
+struct FlightHeader {
+        std::uint32_t magic;
+        /** time between samples, in milliseconds */
+        std::uint16_t period;
+        /** number of motors in each record of each side */
+        std::uint8_t leftMotors;
+        std::uint8_t rightMotors;
+        /** ports of the left motors, then of the right motors. Negative if reversed */
+        std::array<std::int8_t, 2 * MAX_SAMPLED_MOTORS> ports;
+};
+
+/**
+ * @brief Type of a flight record
+ */
+enum class FlightRecordType : std::uint8_t {
+    /** a FlightPose */
+    POSE = 0,
+    /** a FlightMotor for each left drive motor */
+    LEFT_MOTORS = 1,
+    /** a FlightMotor for each right drive motor */
+    RIGHT_MOTORS = 2,
+    /** a FlightController */
+    CONTROLLER = 3,
+    /** a FlightMotion */
+    MOTION = 4,
+    /** the number of records dropped just before this one, as a std::uint32_t */
+    DROPPED = 5
+};
+
+/**
+ * @brief Start of every flight record, followed by size bytes of data
+ */
+struct FlightRecordHeader {
+        FlightRecordType type;
+        std::uint8_t reserved;
+        /** bytes of data after the header */
+        std::uint16_t size;
+        /** time of the sample, in milliseconds */
+        std::uint32_t time;
+};
+
+/**
+ * @brief Odometry in a flight record
+ */
+struct FlightPose {
+        /** position in inches, heading in degrees */
+        float x;
+        float y;
+        float theta;
+        /** global velocity in inches per second, angular velocity in degrees per second */
+        float xVelocity;
+        float yVelocity;
+        float thetaVelocity;
+};
+
+/**
+ * @brief One motor in a flight record
+ */
+struct FlightMotor {
+        /** position, in the encoder units of the motor */
+        float position;
+        /** velocity, in rpm at the output of the cartridge */
+        std::int16_t velocity;
+        /** current draw, in milliamps */
+        std::int16_t current;
+        /** voltage applied, in millivolts */
+        std::int16_t voltage;
+        /** temperature, in degrees celsius */
+        std::uint8_t temperature;
+        /** fault flags, a combination of pros::motor_fault_e_t */
+        std::uint8_t faults;
+};
+
+/**
+ * @brief Controller state in a flight record
+ */
+struct FlightController {
+        /** joystick positions, -127 to 127, indexed by pros::controller_analog_e_t */
+        std::array<std::int8_t, 4> analog;
+        /** one bit per button, L1 is bit 0 */
+        std::uint16_t buttons;
+        std::uint16_t reserved;
+};
+
+/**
+ * @brief Motion state in a flight record
+ */
+struct FlightMotion {
+        /** 1 while a motion is running */
+        std::uint8_t inMotion;
+        std::array<std::uint8_t, 3> reserved;
+        /** time until the running profiled motion should finish, in seconds */
+        float profileTimeLeft;
+};
+
+static_assert(sizeof(FlightHeader) == 24 && sizeof(FlightRecordHeader) == 8 && sizeof(FlightPose) == 24 &&
+                  sizeof(FlightMotor) == 12 && sizeof(FlightController) == 8 && sizeof(FlightMotion) == 8,
+              "must match tools/decode_flight.py");
+
+/**
+ * @brief Records the robot's state to the microSD card
+ *
+ * The tether is never connected during a match, so anything only sent over serial is lost. A FlightRecorder samples
+ * the pose, the drive motors, the controller and the motion state in its own task, and writes them to a new file on
+ * the card, /usd/flight000.bin, then flight001.bin and so on.
+ *
+ * Memory is fixed: records are copied into one of two blocks of FLIGHT_RECORDER_BLOCK_SIZE bytes, allocated with the
+ * recorder. When a block is full, or has been filling for a second, it is handed to a second task, of lower
+ * priority, which appends it to the file in one fwrite while the other block fills. The tasks only share two atomic
+ * flags, so neither ever waits for the other: if the card is too slow and both blocks are full, new records are
+ * dropped, and a DROPPED record counts them once there is room. The control tasks are never involved; the recorder
+ * reads the pose from the pose publisher, and the controller from a ControllerInput.
+ *
+ * The file is opened and closed around each write, so everything written survives the robot being turned off. At
+ * most the last second of records, plus the block being written, is lost.
+ *
+ * The file is a FlightHeader, followed by records. Each record is a FlightRecordHeader followed by its data, whose
+ * layout depends on the type. Everything is little endian, in the layout of the structs above. Records never span
+ * two blocks, so a file cut short by the card being pulled still ends on a whole record. tools/decode_flight.py
+ * turns a recording into CSV files.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::FlightRecorder recorder(leftMotors, rightMotors, input, chassis);
+ *
+ * void initialize() {
+ *     pushback::startPosePublisher();
+ *     input.start();
+ *     recorder.start();
+ * }
+ * @endcode
+ */
+class FlightRecorder {
+    public:
+        /**
+         * @brief Create a new FlightRecorder
+         *
+         * Motors after the first MAX_SAMPLED_MOTORS of each side are left out, and logged as an error.
+         *
+         * @param leftMotors left drive motors
+         * @param rightMotors right drive motors
+         * @param input the driver's controller, sampled by its own task
+         * @param chassis the chassis, for its motion state
+         * @param period time between samples, in milliseconds. 10 by default
+         */
+        FlightRecorder(const pros::MotorGroup& leftMotors, const pros::MotorGroup& rightMotors,
+                       const ControllerInput& input, const Chassis& chassis, std::uint32_t period = 10);
+        /**
+         * @brief Create a new file on the card and start recording to it
+         *
+         * @return true recording
+         * @return false no card is installed, or no file could be created. The error is logged
+         */
+        bool start();
+        /**
+         * @brief Sample everything once
+         *
+         * @param time time of the sample, in milliseconds
+         */
+        void sample(std::uint32_t time);
+        /**
+         * @brief Get the path of the file being recorded to, empty before start()
+         *
+         * @return const std::string&
+         */
+        const std::string& getPath() const;
+        /**
+         * @brief Get the number of bytes written to the card
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getBytesWritten() const;
+        /**
+         * @brief Get the number of records dropped because both blocks were full
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getDropped() const;
+        /**
+         * @brief Get the number of blocks that could not be written to the card
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getWriteErrors() const;
+    private:
+        struct Block {
+                std::array<std::uint8_t, FLIGHT_RECORDER_BLOCK_SIZE> data;
+                /** bytes used, only changed by the sampling task while the block is not full */
+                std::size_t size = 0;
+                /** set by the sampling task when the block is ready to write, cleared by the writing task */
+                std::atomic<bool> full = false;
+        };
+
+        /**
+         * @brief Copy a record to the filling block, handing it off first if it is out of room
+         */
+        void add(FlightRecordType type, std::uint32_t time, const void* data, std::size_t size);
+        /**
+         * @brief Hand the filling block to the writing task, and start filling the other one
+         *
+         * @return false the other block is still being written
+         */
+        bool handOff();
+        /**
+         * @brief Append every full block to the file
+         */
+        void writeBlocks();
+
+        MotorSampler leftSampler;
+        MotorSampler rightSampler;
+        const ControllerInput& input;
+        const Chassis& chassis;
+        std::uint32_t period;
+        PeriodicTask task;
+        std::string path;
+        std::array<Block, 2> blocks;
+        /** block being filled, only used by the sampling task */
+        std::size_t filling = 0;
+        /** time the first record of the filling block was sampled */
+        std::uint32_t fillStart = 0;
+        /** records dropped since the last DROPPED record */
+        std::uint32_t unreported = 0;
+        MotorTelemetry telemetry;
+        std::atomic<std::uint32_t> bytesWritten = 0;
+        std::atomic<std::uint32_t> dropped = 0;
+        std::atomic<std::uint32_t> writeErrors = 0;
+};
+} // namespace pushback
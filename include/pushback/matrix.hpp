@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace pushback {
+/**
+ * @brief Fixed size row-major matrix
+ *
+ * Storage is inline, so matrices can be created and combined inside control loops without touching the heap.
+ *
+ * @tparam R number of rows
+ * @tparam C number of columns
+ */
+template <std::size_t R, std::size_t C> class Matrix {
+    public:
+        std::array<float, R * C> data {};
+
+        /**
+         * @brief Create an identity matrix
+         *
+         * @return Matrix
+         */
+        static constexpr Matrix identity() {
+            static_assert(R == C, "only square matrices have an identity");
+            Matrix result;
+            for (std::size_t i = 0; i < R; i++) result(i, i) = 1;
+            return result;
+        }
+
+        constexpr float& operator()(std::size_t row, std::size_t col) { return data[row * C + col]; }
+
+        constexpr float operator()(std::size_t row, std::size_t col) const { return data[row * C + col]; }
+
+        constexpr Matrix operator+(const Matrix& other) const {
+            Matrix result;
+            for (std::size_t i = 0; i < R * C; i++) result.data[i] = data[i] + other.data[i];
+            return result;
+        }
+
+        constexpr Matrix operator-(const Matrix& other) const {
+            Matrix result;
+            for (std::size_t i = 0; i < R * C; i++) result.data[i] = data[i] - other.data[i];
+            return result;
+        }
+
+        constexpr Matrix operator*(float scalar) const {
+            Matrix result;
+            for (std::size_t i = 0; i < R * C; i++) result.data[i] = data[i] * scalar;
+            return result;
+        }
+
+        template <std::size_t K> constexpr Matrix<R, K> operator*(const Matrix<C, K>& other) const {
+            Matrix<R, K> result;
+            for (std::size_t i = 0; i < R; i++) {
+                for (std::size_t j = 0; j < K; j++) {
+                    float sum = 0;
+                    for (std::size_t k = 0; k < C; k++) sum += (*this)(i, k) * other(k, j);
+                    result(i, j) = sum;
+                }
+            }
+            return result;
+        }
+
+        constexpr Matrix<C, R> transpose() const {
+            Matrix<C, R> result;
+            for (std::size_t i = 0; i < R; i++) {
+                for (std::size_t j = 0; j < C; j++) result(j, i) = (*this)(i, j);
+            }
+            return result;
+        }
+};
+
+using Vector3 = Matrix<3, 1>;
+using Matrix3 = Matrix<3, 3>;
+} // namespace pushback
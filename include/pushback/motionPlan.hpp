@@ -0,0 +1,144 @@
+#pragma once
+
+#include "lemlib/pose.hpp"
+#include "pushback/motionProfile.hpp"
+#include <functional>
+#include <vector>
+
+namespace pushback {
+/**
+ * @brief Parameters for MotionPlan::moveTo
+ */
+struct PlanMoveParams {
+        /** whether the robot should move forwards or backwards. True by default */
+        bool forwards = true;
+        /** the maximum speed the robot can travel at, as a fraction of the velocity constraint in 0-127. 127 by
+         * default */
+        float maxSpeed = 127;
+};
+
+/**
+ * @brief Parameters for MotionPlan::turnTo
+ */
+struct PlanTurnParams {
+        /** the maximum speed the robot can turn at, as a fraction of the velocity constraint in 0-127. 127 by
+         * default */
+        float maxSpeed = 127;
+};
+
+/**
+ * @brief One segment of a planned motion, with the velocities it is entered and left at
+ */
+struct PlanSegment {
+        enum class Type { LINE, TURN };
+
+        Type type;
+        /** start and end of a line, in inches */
+        float startX;
+        float startY;
+        float endX;
+        float endY;
+        /** heading at the end of a turn, in degrees */
+        float endTheta;
+        /** length of a line in inches, or the planned angle of a turn in degrees. Never negative */
+        float length;
+        bool forwards;
+        /** velocity limits, in inches or degrees per second. Turns always start and end at rest */
+        float maxVelocity;
+        float entryVelocity;
+        float exitVelocity;
+        /** actions to run as soon as the segment starts */
+        std::vector<std::function<void()>> actions;
+};
+
+/**
+ * @brief A sequence of moves, turns and actions that the chassis runs as one motion
+ *
+ * Separate moveToPoint calls bring the robot to a full stop between every move. A plan knows the whole sequence
+ * ahead of time, so the robot carries its speed through consecutive moves, only slowing down as much as the corner
+ * between them requires. Turns in place still start and end at rest.
+ *
+ * Actions run when the robot reaches them in the plan, without stopping it. They are called from the motion task,
+ * so they should return quickly.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::MotionPlan plan;
+ * plan.moveTo(0, 24)
+ *     .action([] { Intake.move(127); })
+ *     .moveTo(24, 48)
+ *     .turnTo(90)
+ *     .moveTo(0, 48, {.forwards = false});
+ * chassis.followPlan(plan, 10000);
+ * @endcode
+ */
+class MotionPlan {
+    public:
+        /**
+         * @brief Drive to a point in a straight line
+         *
+         * @param x x location
+         * @param y y location
+         * @param params struct to simulate named parameters
+         * @return MotionPlan& this plan, so calls can be chained
+         */
+        MotionPlan& moveTo(float x, float y, PlanMoveParams params = {});
+        /**
+         * @brief Turn in place to a heading, taking the shortest direction
+         *
+         * @param theta heading, in degrees
+         * @param params struct to simulate named parameters
+         * @return MotionPlan& this plan, so calls can be chained
+         */
+        MotionPlan& turnTo(float theta, PlanTurnParams params = {});
+        /**
+         * @brief Run a function when the robot gets to this point in the plan
+         *
+         * @param action function to run
+         * @return MotionPlan& this plan, so calls can be chained
+         */
+        MotionPlan& action(std::function<void()> action);
+        /**
+         * @brief Plan the velocity of every segment
+         *
+         * The speed a line is left at is limited by the corner to the next line, and both lines must be driven in the
+         * same direction. A forward pass then limits speeds to what the robot can accelerate to, and a backward pass
+         * to what it can stop from.
+         *
+         * @param start pose of the robot when the plan starts, theta in degrees
+         * @param lateralConstraints limits for lines, in inches and seconds
+         * @param angularConstraints limits for turns, in degrees and seconds
+         * @return std::vector<PlanSegment> the segments to drive, in order
+         */
+        std::vector<PlanSegment> build(lemlib::Pose start, ProfileConstraints lateralConstraints,
+                                       ProfileConstraints angularConstraints) const;
+        /**
+         * @brief Get the actions added after the last move or turn
+         */
+        const std::vector<std::function<void()>>& getEndActions() const;
+    private:
+        struct Step {
+                PlanSegment::Type type;
+                float x;
+                float y;
+                float theta;
+                bool forwards;
+                float maxSpeed;
+                std::vector<std::function<void()>> actions;
+        };
+
+        std::vector<Step> steps;
+        /** actions waiting for the next move or turn */
+        std::vector<std::function<void()>> pending;
+};
+
+/**
+ * @brief Get the target velocity and acceleration partway through a line segment
+ *
+ * @param segment the segment
+ * @param traveled distance traveled along the segment, in inches
+ * @param maxAcceleration acceleration limit, in inches per second squared
+ * @return ProfileState speed and acceleration, position is the distance left
+ */
+ProfileState sampleSegment(const PlanSegment& segment, float traveled, float maxAcceleration);
+} // namespace pushback
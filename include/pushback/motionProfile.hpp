@@ -0,0 +1,92 @@
+#pragma once
+
+namespace pushback {
+/**
+ * @brief Limits used to generate a motion profile
+ *
+ * Units are up to the user, e.g. inches and seconds for lateral motions, or degrees and seconds for turns.
+ */
+struct ProfileConstraints {
+        /** maximum velocity */
+        float maxVelocity;
+        /** maximum acceleration */
+        float maxAcceleration;
+        /** maximum jerk. 0 for a trapezoidal profile */
+        float maxJerk = 0;
+};
+
+/**
+ * @brief The state of a motion profile at one point in time
+ */
+struct ProfileState {
+        float position;
+        float velocity;
+        float acceleration;
+};
+
+/**
+ * @brief Rest to rest motion profile
+ *
+ * With a jerk limit this is an S-curve: acceleration ramps up and down instead of stepping, which keeps the wheels
+ * from slipping at the start of a motion and the robot from rocking when it stops. Without one it is a trapezoid.
+ * If the distance is too short to reach the maximum velocity or acceleration, the peak is lowered so the profile
+ * stays symmetric.
+ *
+ * The profile is computed once when it is constructed, and sampled in constant time.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // 48 inches, at most 60 in/s, 120 in/s^2 and 600 in/s^3
+ * pushback::MotionProfile profile(48, {60, 120, 600});
+ * // how long the motion takes, in seconds
+ * const float duration = profile.getDuration();
+ * // where the robot should be after half a second
+ * const pushback::ProfileState state = profile.sample(0.5);
+ * @endcode
+ */
+class MotionProfile {
+    public:
+        /**
+         * @brief Create a new MotionProfile
+         *
+         * @param distance distance to travel. Negative distances are traveled backwards
+         * @param constraints limits of the profile
+         */
+        MotionProfile(float distance, ProfileConstraints constraints);
+        /**
+         * @brief Get the state of the profile at a point in time
+         *
+         * @param time time since the start of the profile, in seconds. Clamped to the duration of the profile
+         * @return ProfileState
+         */
+        ProfileState sample(float time) const;
+        /**
+         * @brief Get how long the profile takes, in seconds
+         *
+         * @return float
+         */
+        float getDuration() const;
+        /**
+         * @brief Get the distance the profile travels
+         *
+         * @return float
+         */
+        float getDistance() const;
+    private:
+        /**
+         * @brief Sample the acceleration phase, which the deceleration phase mirrors
+         */
+        ProfileState sampleAcceleration(float time) const;
+
+        float distance;
+        float sign;
+        /** peak velocity and acceleration actually reached */
+        float velocity = 0;
+        float acceleration = 0;
+        float jerk = 0;
+        /** duration of each jerk segment, of the whole acceleration phase, and of the cruise */
+        float jerkTime = 0;
+        float accelerationTime = 0;
+        float cruiseTime = 0;
+};
+} // namespace pushback
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "pros/motor_group.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pushback {
+/** most motors a MotorSampler can hold */
+constexpr std::size_t MAX_SAMPLED_MOTORS = 8;
+
+/**
+ * @brief Readings of every motor in a group, taken in one pass
+ *
+ * Each field is an array with one entry per motor, in the order of the group, so a logger can walk one quantity
+ * across the group without touching the others. Only the first count entries are valid. Reversed motors report
+ * position, velocity, voltage and torque reversed, the same as pros::MotorGroup.
+ *
+ * Unplugged motors report PROS_ERR or PROS_ERR_F, the same as the PROS getters.
+ */
+struct MotorTelemetry {
+        /** number of motors sampled */
+        std::size_t count = 0;
+        /** time of the sample, in milliseconds */
+        std::uint32_t time = 0;
+        /** position, in the encoder units of each motor */
+        std::array<double, MAX_SAMPLED_MOTORS> position {};
+        /** velocity, in rpm at the output of the cartridge */
+        std::array<double, MAX_SAMPLED_MOTORS> velocity {};
+        /** current draw, in milliamps */
+        std::array<std::int32_t, MAX_SAMPLED_MOTORS> current {};
+        /** voltage applied, in millivolts */
+        std::array<std::int32_t, MAX_SAMPLED_MOTORS> voltage {};
+        /** temperature, in degrees celsius */
+        std::array<double, MAX_SAMPLED_MOTORS> temperature {};
+        /** torque, in newton meters */
+        std::array<double, MAX_SAMPLED_MOTORS> torque {};
+        /** efficiency, in percent */
+        std::array<double, MAX_SAMPLED_MOTORS> efficiency {};
+        /** fault flags, a combination of pros::motor_fault_e_t */
+        std::array<std::uint32_t, MAX_SAMPLED_MOTORS> faults {};
+};
+
+/**
+ * @brief Reads a motor group without allocating
+ *
+ * Every *_all getter of pros::MotorGroup returns a new std::vector. A MotorSampler reads the ports of the group once,
+ * when it is created, and then reads each motor straight into a MotorTelemetry owned by the caller.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::MotorSampler leftSampler(leftMotors);
+ * pushback::MotorTelemetry left;
+ *
+ * void logDrive() {
+ *     leftSampler.snapshot(left);
+ *     for (std::size_t i = 0; i < left.count; i++) {
+ *         printf("%d: %.0f C %ld mA\n", leftSampler.getPort(i), left.temperature[i], left.current[i]);
+ *     }
+ * }
+ * @endcode
+ */
+class MotorSampler {
+    public:
+        /**
+         * @brief Create a new MotorSampler
+         *
+         * Motors after the first MAX_SAMPLED_MOTORS are left out, and logged as an error.
+         *
+         * @param motors the motor group. Motors added to it later are not sampled
+         */
+        explicit MotorSampler(const pros::MotorGroup& motors);
+        /**
+         * @brief Read every motor of the group
+         *
+         * @param telemetry filled with the readings
+         */
+        void snapshot(MotorTelemetry& telemetry) const;
+        /**
+         * @brief Get the number of motors sampled
+         */
+        std::size_t size() const;
+        /**
+         * @brief Get the port of a motor, negative if it is reversed
+         *
+         * @param index index of the motor in the group
+         */
+        std::int8_t getPort(std::size_t index) const;
+    private:
+        std::array<std::int8_t, MAX_SAMPLED_MOTORS> ports {};
+        std::size_t count = 0;
+};
+} // namespace pushback
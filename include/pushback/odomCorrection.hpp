@@ -0,0 +1,35 @@
+#pragma once
+
+#include "lemlib/pose.hpp"
+
+namespace pushback {
+/**
+ * @brief Get lemlib odometry, with the corrections that are queued but not written yet
+ *
+ * Code that corrects odometry must read it with this instead of lemlib::getPose, so that a correction it queued is
+ * part of the next reading whether or not the writer has run since.
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose getCorrectedPose(bool radians = false);
+
+/**
+ * @brief Queue a correction of lemlib odometry, computed from an earlier reading
+ *
+ * Odometry keeps running while a correction is computed, so rather than overwriting the pose, the difference between
+ * the corrected pose and the reading it was computed from is added to the current pose.
+ *
+ * The Ekf, the ParticleFilter and the SlipDetector all correct odometry from their own tasks, and lemlib's odom task
+ * moves it in between. Each read and write of the pose by one of them could undo a write by another. Instead, they
+ * queue corrections here, and one task writes them all, every 10ms. It runs above the odom task, so no odometry
+ * update can land between its read and its write. The first call starts it.
+ *
+ * A correction queued just before the pose is set, e.g. by Chassis::setPose, is dropped rather than applied to the
+ * new pose.
+ *
+ * @param measured the reading of getCorrectedPose the correction was computed from, theta in radians
+ * @param corrected the corrected odometry pose, theta in radians
+ */
+void shiftPose(const lemlib::Pose& measured, const lemlib::Pose& corrected);
+} // namespace pushback
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "pros/abstract_motor.hpp"
+#include "pros/adi.hpp"
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace pushback {
+/**
+ * @brief An output whose commands are held until the next flush
+ *
+ * Outputs count writes in device writes, one per motor in a group, so a MotorGroup of 3 motors counts 3 writes per
+ * command. getRequestedWrites() is what writing every command straight to the device would have cost, and
+ * getWrites() is what was actually sent.
+ */
+class Output {
+    public:
+        virtual ~Output() = default;
+        /**
+         * @brief Send the latest command if it differs from the last one sent, or the last one is getting old
+         *
+         * @param time current time, in milliseconds
+         */
+        virtual void flush(std::uint32_t time) = 0;
+        /**
+         * @brief Forget the last command sent, so the next flush sends the latest command
+         *
+         * Call this after the device was written to without going through the cache
+         */
+        virtual void invalidate() = 0;
+        /**
+         * @brief Get the number of device writes actually sent. Safe to call from any task
+         */
+        std::uint32_t getWrites() const { return writes.load(std::memory_order_relaxed); }
+        /**
+         * @brief Get the number of device writes the commands would have cost without the cache. Safe to call from any
+         * task
+         */
+        std::uint32_t getRequestedWrites() const { return requestedWrites.load(std::memory_order_relaxed); }
+    protected:
+        std::atomic<std::uint32_t> writes = 0;
+        std::atomic<std::uint32_t> requestedWrites = 0;
+};
+
+/**
+ * @brief Output that remembers the last command sent
+ *
+ * A command equal to the last one sent is only sent again once it is older than the refresh period, so a device that
+ * was unplugged and reset gets its command back.
+ *
+ * @tparam Command the command type, compared with ==
+ */
+template <typename Command> class CachedOutput : public Output {
+    public:
+        void flush(std::uint32_t time) override {
+            if (!pending) return;
+            pending = false;
+            if (sent && command == last && time - lastTime < REFRESH_PERIOD) return;
+            write(command);
+            writes.fetch_add(ports(), std::memory_order_relaxed);
+            last = command;
+            lastTime = time;
+            sent = true;
+        }
+
+        void invalidate() override { sent = false; }
+    protected:
+        /** time after which an unchanged command is sent again, in milliseconds */
+        static constexpr std::uint32_t REFRESH_PERIOD = 200;
+
+        /**
+         * @brief Store a command to send on the next flush
+         */
+        void request(Command command) {
+            this->command = command;
+            pending = true;
+            requestedWrites.fetch_add(ports(), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Send a command to the device
+         */
+        virtual void write(const Command& command) = 0;
+        /**
+         * @brief Get the number of device writes one command costs
+         */
+        virtual std::uint32_t ports() const = 0;
+    private:
+        Command command {};
+        Command last {};
+        std::uint32_t lastTime = 0;
+        bool pending = false;
+        bool sent = false;
+};
+
+/**
+ * @brief A command for a motor or motor group
+ */
+struct MotorCommand {
+        enum class Type { POWER, VOLTAGE };
+
+        Type type;
+        /** -127 to 127 for POWER, millivolts for VOLTAGE */
+        std::int32_t value;
+
+        bool operator==(const MotorCommand& other) const = default;
+};
+
+/**
+ * @brief Motor or motor group that only sends commands that changed
+ *
+ * @b Example
+ * @code {.cpp}
+ * pros::MotorGroup intakeMotors({7, -8});
+ * pushback::CachedMotor intake(intakeMotors);
+ *
+ * void opcontrol() {
+ *     while (true) {
+ *         intake.moveVoltage(12000); // sent on the first tick, then only to refresh it
+ *         intake.flush(pros::millis());
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class CachedMotor : public CachedOutput<MotorCommand> {
+    public:
+        /**
+         * @brief Create a new CachedMotor
+         *
+         * @param motor the motor or motor group to command
+         */
+        explicit CachedMotor(pros::AbstractMotor& motor);
+        /**
+         * @brief Same as pros::AbstractMotor::move, sent on the next flush
+         *
+         * @param power -127 to 127
+         */
+        void move(std::int32_t power);
+        /**
+         * @brief Same as pros::AbstractMotor::move_voltage, sent on the next flush
+         *
+         * @param voltage -12000 to 12000 millivolts
+         */
+        void moveVoltage(std::int32_t voltage);
+    protected:
+        void write(const MotorCommand& command) override;
+        std::uint32_t ports() const override;
+    private:
+        pros::AbstractMotor& motor;
+};
+
+/**
+ * @brief Digital output, like a solenoid, that only sends values that changed
+ */
+class CachedDigitalOut : public CachedOutput<bool> {
+    public:
+        /**
+         * @brief Create a new CachedDigitalOut
+         *
+         * @param output the digital output to command
+         */
+        explicit CachedDigitalOut(pros::adi::DigitalOut& output);
+        /**
+         * @brief Same as pros::adi::DigitalOut::set_value, sent on the next flush
+         *
+         * @param value the new value
+         */
+        void setValue(bool value);
+    protected:
+        void write(const bool& value) override;
+        std::uint32_t ports() const override;
+    private:
+        pros::adi::DigitalOut& output;
+};
+
+/**
+ * @brief Outputs that are flushed together, once per control tick
+ *
+ * Commands given during a tick only reach the devices on flush(), so a command that is overwritten later in the same
+ * tick is never sent, and the ones that are sent leave together. Every output must only be commanded from the task
+ * that flushes it.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::CachedMotor intake(Intake);
+ * pushback::CachedDigitalOut loader(Loader);
+ * pushback::OutputBatch outputs({&intake, &loader});
+ *
+ * void opcontrol() {
+ *     // autonomous wrote to the devices directly
+ *     outputs.invalidate();
+ *     while (true) {
+ *         intake.moveVoltage(controller.get_digital(pros::E_CONTROLLER_DIGITAL_L1) ? 12000 : 0);
+ *         outputs.flush();
+ *         pros::delay(10);
+ *     }
+ * }
+ * @endcode
+ */
+class OutputBatch {
+    public:
+        /**
+         * @brief Create a new OutputBatch
+         *
+         * @param outputs the outputs in the batch
+         */
+        OutputBatch(std::initializer_list<Output*> outputs);
+        /**
+         * @brief Flush every output in the batch
+         */
+        void flush();
+        /**
+         * @brief Invalidate every output in the batch
+         */
+        void invalidate();
+        /**
+         * @brief Get the device writes actually sent by the whole batch. Safe to call from any task
+         */
+        std::uint32_t getWrites() const;
+        /**
+         * @brief Get the device writes the whole batch would have cost without the cache. Safe to call from any task
+         */
+        std::uint32_t getRequestedWrites() const;
+    private:
+        std::vector<Output*> outputs;
+};
+} // namespace pushback
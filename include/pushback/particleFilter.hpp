@@ -0,0 +1,164 @@
+#pragma once
+
+#include "lemlib/pose.hpp"
+#include "pushback/field.hpp"
+#include "pushback/periodicTask.hpp"
+#include "pushback/seqlock.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pushback {
+/** particle count that fits comfortably in a 20ms tick on the brain */
+constexpr std::size_t BRAIN_PARTICLES = 300;
+/** particle count for the host simulator, where the filter is tuned */
+constexpr std::size_t HOST_PARTICLES = 2048;
+
+/**
+ * @brief Tuning for the particle filter
+ */
+struct ParticleFilterSettings {
+        /** field pose of the odometry origin, i.e. the pose passed to chassis.setPose() at the start of the run */
+        lemlib::Pose origin {0, 0, 0};
+        /** number of particles */
+        std::size_t particles = BRAIN_PARTICLES;
+        /** standard deviation of the odometry error, as a fraction of the distance traveled */
+        float travelNoise = 0.05;
+        /** standard deviation of the odometry heading error, as a fraction of the angle turned */
+        float turnNoise = 0.02;
+        /** standard deviation of a distance sensor reading, in inches, and as a fraction of the reading.
+         * The larger of the two is used */
+        float distanceNoise = 0.6;
+        float distanceNoiseRatio = 0.05;
+        /** chance that a reading hit a game element or another robot instead of the perimeter */
+        float outlierProbability = 0.1;
+        /** distance readings with a lower confidence are ignored. The sensor reports 0-63 */
+        std::int32_t minConfidence = 30;
+        /** distance readings further than this are ignored, in inches */
+        float maxDistance = 80;
+        /** odometry is only corrected while the particles agree to within this radius, in inches */
+        float maxSpread = 2;
+        /** odometry is only corrected if it is further than this from the estimate, in inches */
+        float minCorrection = 0.5;
+        /** half the inside length of the field perimeter, in inches */
+        float fieldHalfWidth = FIELD_HALF_WIDTH;
+};
+
+/**
+ * @brief Monte Carlo localization against the field perimeter
+ *
+ * Each particle is a guess of the robot's field pose. Particles are moved by the motion lemlib odometry measures,
+ * scored by ray-casting every distance sensor against the perimeter, and resampled when only a few particles carry
+ * most of the weight. Unlike the EKF, the particle filter can hold several hypotheses at once, so it recovers after
+ * a collision has thrown odometry off by more than a single Gaussian can represent.
+ *
+ * Particles are stored as separate arrays for x, y, heading and weight, so the scoring loop runs over contiguous
+ * floats and can be vectorized. All arrays are allocated by the constructor.
+ *
+ * When the particles agree, the x and y difference between the estimate and odometry is applied to lemlib
+ * odometry. Heading is left to the IMU. Do not run the particle filter and the EKF at the same time.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::ParticleFilter relocalizer({.origin = {-48, -61, 0}},
+ *                                      {{&Back, 0, -7.5, 180}, {&Right, 7.5, 0, 90}, {&Left, -7.5, 0, -90}});
+ *
+ * void autonomous() {
+ *     chassis.setPose(0, 0, 0);
+ *     relocalizer.start();
+ *     chassis.moveToPoint(0, 47, 2000, {}, false);
+ *     // the robot was pushed, search a wider area
+ *     relocalizer.scatter(12, 10);
+ * }
+ * @endcode
+ */
+class ParticleFilter {
+    public:
+        /**
+         * @brief Create a new ParticleFilter
+         *
+         * @param settings filter tuning
+         * @param distanceSensors distance sensors used to score the particles
+         */
+        ParticleFilter(ParticleFilterSettings settings, std::vector<DistanceMount> distanceSensors);
+        /**
+         * @brief Start running the filter in a task, every 20ms
+         */
+        void start();
+        /**
+         * @brief Run one step of the filter
+         */
+        void update();
+        /**
+         * @brief Spread the particles out around the current estimate, e.g. after a collision
+         *
+         * The particles are spread out on the next update, so this is safe to call from any task.
+         *
+         * @param radius radius of the area to search, in inches
+         * @param angle heading uncertainty, in degrees
+         */
+        void scatter(float radius, float angle);
+        /**
+         * @brief Get the estimated pose in field coordinates. Safe to call from any task
+         *
+         * @param radians true for theta in radians, false for degrees. False by default
+         * @return lemlib::Pose
+         */
+        lemlib::Pose getFieldPose(bool radians = false) const;
+        /**
+         * @brief Get how far the particles are spread around the estimate, in inches. Safe to call from any task
+         */
+        float getSpread() const;
+    private:
+        /**
+         * @brief The estimate, as other tasks read it
+         */
+        struct Estimate {
+                /** field pose, theta in radians */
+                lemlib::Pose pose;
+                /** in inches */
+                float spread;
+        };
+
+        void reset(const lemlib::Pose& center, float radius, float angle);
+        void predict(float forward, float lateral, float turn);
+        /**
+         * @brief Score the particles against the distance sensors
+         *
+         * @return whether any sensor had a usable reading
+         */
+        bool weigh();
+        void resample();
+        void estimate();
+        float uniform();
+        float gaussian();
+
+        ParticleFilterSettings settings;
+        std::vector<DistanceMount> distanceSensors;
+
+        // particle state, one entry per particle
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> theta;
+        std::vector<float> weight;
+        // scratch space for scoring and resampling
+        std::vector<float> sinTheta;
+        std::vector<float> cosTheta;
+        std::vector<float> nextX;
+        std::vector<float> nextY;
+        std::vector<float> nextTheta;
+
+        lemlib::Pose fieldPose {0, 0, 0};
+        float spread = 0;
+        lemlib::Pose lastOdom {0, 0, 0};
+        bool initialized = false;
+        PeriodicTask task;
+        std::uint32_t ticks = 0;
+        std::uint32_t seed = 0x9e3779b9;
+        /** pending scatter request, radius in inches and angle in degrees */
+        std::atomic<float> scatterRadius = 0;
+        std::atomic<float> scatterAngle = 0;
+        SeqLock<Estimate> published;
+};
+} // namespace pushback
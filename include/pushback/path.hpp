@@ -0,0 +1,89 @@
+#pragma once
+
+#include "lemlib/asset.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace pushback {
+/** "PBP1", the first four bytes of a compiled path */
+constexpr std::uint32_t PATH_MAGIC = 0x31504250;
+
+/**
+ * @brief Header of a compiled path
+ */
+struct PathHeader {
+        std::uint32_t magic;
+        /** number of points after the header */
+        std::uint32_t count;
+        /** arc length of the whole path, in inches */
+        float length;
+        std::uint32_t reserved;
+};
+
+/**
+ * @brief One point of a compiled path
+ */
+struct PathPoint {
+        /** position, in inches */
+        float x;
+        float y;
+        /** speed from the path file, 0-127 */
+        float speed;
+        /** arc length from the first point, in inches */
+        float distance;
+        /** signed curvature, in 1/inches. Positive turns right */
+        float curvature;
+        /** target velocity, in inches per second. Limited by curvature, and 0 at both ends */
+        float velocity;
+};
+
+static_assert(sizeof(PathHeader) == 16 && sizeof(PathPoint) == 24, "must match tools/compile_path.py");
+
+/**
+ * @brief Read-only view of a compiled path asset
+ *
+ * Paths in static/ are compiled at build time by tools/compile_path.py, which precomputes arc length, curvature and
+ * a velocity profile. The compiled asset has the same name as the text file with _path instead of _txt. The view
+ * points straight into the asset, so nothing is parsed or copied when a motion starts.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // static/First_Long_Turn.txt
+ * ASSET(First_Long_Turn_path);
+ *
+ * pushback::Path path(First_Long_Turn_path);
+ * if (path.isValid()) pros::lcd::print(0, "%f inches", path.getLength());
+ * @endcode
+ */
+class Path {
+    public:
+        /**
+         * @brief Create a view of a compiled path
+         *
+         * @param path the compiled path asset
+         */
+        explicit Path(const asset& path);
+        /**
+         * @brief Whether the asset is a compiled path with at least two points
+         *
+         * @return false if the asset is a text file, from a different version of the compiler, truncated, or not
+         * aligned
+         */
+        bool isValid() const;
+        /**
+         * @brief Get the number of points, 0 if the path is not valid
+         */
+        std::size_t size() const;
+        /**
+         * @brief Get the arc length of the path, in inches
+         */
+        float getLength() const;
+        const PathPoint& operator[](std::size_t index) const;
+        const PathPoint* begin() const;
+        const PathPoint* end() const;
+    private:
+        const PathPoint* points = nullptr;
+        std::size_t count = 0;
+        float length = 0;
+};
+} // namespace pushback
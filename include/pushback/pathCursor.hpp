@@ -0,0 +1,111 @@
+#pragma once
+
+#include "pushback/path.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pushback {
+/**
+ * @brief Tracks the robot's progress along a compiled path
+ *
+ * Finding the closest point and the lookahead point by scanning the whole path costs time proportional to its
+ * length every update. The cursor instead remembers where the robot was and only walks forward from there, so an
+ * update touches the few points the robot passed since the last one, however long the path is.
+ *
+ * A robot that is pushed off the path can end up closer to a part of the path the cursor would never walk to. With
+ * a grid, the cursor notices when the robot is further than one cell from the path and searches the cells around
+ * the robot instead, which again does not depend on the length of the path.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::Path path(First_Long_Turn_path);
+ * // re-acquire the path if the robot is more than 10 inches off it
+ * pushback::PathCursor cursor(path, 10);
+ * cursor.update(pose.x, pose.y);
+ * const pushback::PathPoint target = cursor.lookahead(pose.x, pose.y, 10);
+ * @endcode
+ */
+class PathCursor {
+    public:
+        /**
+         * @brief Create a new PathCursor at the start of a path
+         *
+         * @param path the path, which must be valid and outlive the cursor
+         * @param gridCellSize size of the cells of the re-acquisition grid, in inches. 0 to disable it
+         */
+        PathCursor(const Path& path, float gridCellSize = 0);
+        /**
+         * @brief Move the cursor to the point on the path closest to the robot
+         *
+         * The cursor never moves backwards.
+         *
+         * @param x x position of the robot
+         * @param y y position of the robot
+         */
+        void update(float x, float y);
+        /**
+         * @brief Find the point where the lookahead circle crosses the path ahead of the cursor
+         *
+         * If the robot is too far from the path for the circle to cross it, this is the point one lookahead
+         * distance along the path from the cursor.
+         *
+         * @param x x position of the robot
+         * @param y y position of the robot
+         * @param radius lookahead distance, in inches
+         * @return PathPoint interpolated point
+         */
+        PathPoint lookahead(float x, float y, float radius);
+        /**
+         * @brief Interpolate the path at an arc length
+         *
+         * @param distance arc length from the start of the path, in inches. Clamped to the path
+         * @return PathPoint
+         */
+        PathPoint sample(float distance) const;
+        /**
+         * @brief Get the arc length of the closest point on the path, in inches
+         */
+        float getDistance() const;
+        /**
+         * @brief Get the distance from the robot to the path at the last update, in inches
+         */
+        float getOffset() const;
+        /**
+         * @brief Get how many times the grid was used to find the path again
+         */
+        std::uint32_t getReacquisitions() const;
+    private:
+        /**
+         * @brief Distance from a point to a segment, and the fraction along the segment of the closest point
+         */
+        float segmentDistance(std::size_t segment, float x, float y, float& t) const;
+        /**
+         * @brief Find the closest segment at or after the cursor in the grid cells around a point
+         *
+         * @return whether a segment was found
+         */
+        bool reacquire(float x, float y);
+        /**
+         * @brief Get the index of the grid cell containing a point, clamped to the grid
+         */
+        std::size_t cellIndex(float x, float y) const;
+
+        const Path& path;
+        /** index of the segment the cursor is on, and how far along it, 0-1 */
+        std::size_t segment = 0;
+        float fraction = 0;
+        float offset = 0;
+        std::size_t lookaheadSegment = 0;
+        std::uint32_t reacquisitions = 0;
+
+        // grid of the segments overlapping each cell, stored as one array with an offset per cell
+        float cellSize;
+        float minX = 0;
+        float minY = 0;
+        std::size_t columns = 0;
+        std::size_t rows = 0;
+        std::vector<std::uint32_t> cellStart;
+        std::vector<std::uint32_t> cellSegments;
+};
+} // namespace pushback
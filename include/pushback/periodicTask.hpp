@@ -0,0 +1,44 @@
+#pragma once
+
+#include "pros/rtos.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace pushback {
+/**
+ * @brief A task that calls a function at a fixed period
+ *
+ * The period is kept with pros::Task::delay_until, so the calls do not drift by the time each one takes. Only the
+ * first call to start() creates the task; later ones have no effect.
+ *
+ * The classes that run in a PeriodicTask keep the function it calls public, so they can be run from a custom loop
+ * instead of their own task.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void BatteryMonitor::start() {
+ *     task.start(period, [this](std::uint32_t) { update(period / 1000.0f); });
+ * }
+ * @endcode
+ */
+class PeriodicTask {
+    public:
+        /**
+         * @brief Start calling a function in a task. Calling it again has no effect
+         *
+         * @param period time between calls, in milliseconds
+         * @param function called with the time the call is due, in milliseconds
+         * @param priority priority of the task. TASK_PRIORITY_DEFAULT by default
+         * @return true the task was started by this call
+         */
+        bool start(std::uint32_t period, std::function<void(std::uint32_t time)> function,
+                   std::uint32_t priority = TASK_PRIORITY_DEFAULT);
+        /**
+         * @brief Check whether the task has been started. Safe to call from any task
+         */
+        bool isStarted() const { return started.load(std::memory_order_relaxed); }
+    private:
+        std::atomic<bool> started = false;
+};
+} // namespace pushback
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "lemlib/chassis/chassis.hpp"
+#include <vector>
+
+namespace pushback {
+/**
+ * @brief First order plus dead time model of one axis of the drivetrain
+ *
+ * The velocity follows the motor power with a delay and a lag: after the dead time, it approaches gain * power with
+ * the time constant. Units are up to the axis, e.g. inches per second for lateral motions or degrees per second
+ * for turns.
+ */
+struct FopdtModel {
+        /** steady state velocity per unit of motor power */
+        float gain = 0;
+        /** time constant of the lag, in seconds */
+        float timeConstant = 0;
+        /** delay before the velocity starts to respond, in seconds */
+        float deadTime = 0;
+        /** root mean square error of the fit, in units of velocity */
+        float error = 0;
+};
+
+/**
+ * @brief Parameters for Chassis::tuneLateral and Chassis::tuneAngular
+ *
+ * We use a struct to simplify customization. The tuners have many
+ * parameters and specifying them all just to set one optional param harms
+ * readability. By passing a struct to the function, we can have named
+ * parameters, overcoming the c/c++ limitation
+ */
+struct TuneParams {
+        /** motor power of the step, 0-127. 60 by default */
+        float power = 60;
+        /** longest time the step is applied for, in milliseconds. 1500 by default */
+        int timeout = 1500;
+        /** distance after which a lateral step is cut short, in inches. 36 by default */
+        float maxDistance = 36;
+        /** closed loop time constant the gains are chosen for, in seconds. Smaller is more aggressive. 0, which uses
+         * the larger of the dead time and half the time constant, by default */
+        float closedLoopTime = 0;
+        /** size of the motion the settle time and overshoot are predicted for. 0, which predicts for 24 inches or
+         * 90 degrees, by default */
+        float target = 0;
+};
+
+/**
+ * @brief Suggested gains for one controller, and how they are predicted to perform
+ */
+struct TuneResult {
+        /** identified model of the axis */
+        FopdtModel model;
+        /** the current settings, with the suggested gains */
+        lemlib::ControllerSettings settings;
+        /** motion the prediction was made for, in inches or degrees */
+        float target;
+        /** predicted time until the error stays within the small error range, or 1 if it is not set, in seconds */
+        float settleTime;
+        /** predicted distance past the target, in inches or degrees */
+        float overshoot;
+};
+
+/**
+ * @brief Fit a first order plus dead time model to a recorded response
+ *
+ * The samples are fitted with a least squares model of the form v[k] = a * v[k - 1] + b * u[k - d], for every dead
+ * time d up to maxDeadTime, and the best fit is kept. Unlike reading the time to 63% off the curve, this does not
+ * need the response to reach its steady state, so a lateral step can be cut short before the robot runs out of
+ * room.
+ *
+ * @param power motor power at each sample
+ * @param velocity velocity at each sample, measured over the period its power was applied for
+ * @param period time between samples, in seconds
+ * @param maxDeadTime longest dead time considered, in seconds. 0.3 by default
+ * @return FopdtModel the fitted model, all zero if the response does not fit one
+ */
+FopdtModel fitFopdt(const std::vector<float>& power, const std::vector<float>& velocity, float period,
+                    float maxDeadTime = 0.3);
+
+/**
+ * @brief Suggest gains for a lemlib position controller, and predict how it will perform
+ *
+ * The position of the axis is the integral of the model's velocity. The gains follow the SIMC rule for an
+ * integrating process with a lag: kP = 1 / (gain * (closedLoopTime + deadTime)), with the derivative cancelling the
+ * lag. The integral gain is left at 0. The prediction runs the model in closed loop with the suggested gains, the
+ * way a lemlib motion updates the PID every 10ms, with the power clamped to 127.
+ *
+ * @param model identified model of the axis
+ * @param current current settings of the controller. Everything but the gains is kept
+ * @param closedLoopTime closed loop time constant, in seconds. 0 uses the larger of the dead time and half the time
+ * constant
+ * @param target size of the motion the prediction is made for
+ * @return TuneResult
+ */
+TuneResult suggestGains(const FopdtModel& model, const lemlib::ControllerSettings& current, float closedLoopTime,
+                        float target);
+} // namespace pushback
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "lemlib/pose.hpp"
+#include <cstdint>
+
+namespace pushback {
+/**
+ * @brief A record of the odometry state, published as one unit
+ *
+ * The pose, velocity and time are read from lemlib one after the other, not under a lock shared with the odom
+ * task, so the velocity can be from the odom update before or after the pose.
+ */
+struct PoseSnapshot {
+        /** position in inches, heading in degrees */
+        lemlib::Pose pose;
+        /** global velocity in inches per second, angular velocity in degrees per second */
+        lemlib::Pose velocity;
+        /** time the snapshot was taken, in milliseconds */
+        std::uint32_t time;
+};
+
+/**
+ * @brief Start publishing odometry snapshots
+ *
+ * The publisher samples lemlib odometry at the same 10ms period as the odom task, and stores the result in a
+ * lock-free buffer. Call this after chassis.calibrate().
+ *
+ * @b Example
+ * @code {.cpp}
+ * void initialize() {
+ *     chassis.calibrate();
+ *     pushback::startPosePublisher();
+ * }
+ * @endcode
+ */
+void startPosePublisher();
+
+/**
+ * @brief Get the latest odometry snapshot
+ *
+ * This never blocks, and never mixes fields from two different snapshots.
+ * Before the publisher has started the snapshot is all zeros.
+ *
+ * @return PoseSnapshot
+ *
+ * @b Example
+ * @code {.cpp}
+ * const pushback::PoseSnapshot snapshot = pushback::getPoseSnapshot();
+ * pros::lcd::print(0, "X: %f", snapshot.pose.x);
+ * pros::lcd::print(1, "Y: %f", snapshot.pose.y);
+ * @endcode
+ */
+PoseSnapshot getPoseSnapshot();
+} // namespace pushback
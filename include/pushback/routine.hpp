@@ -0,0 +1,307 @@
+#pragma once
+
+#include "lemlib/chassis/chassis.hpp"
+#include "pros/rtos.hpp"
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace pushback {
+class RoutineScheduler;
+
+/**
+ * @brief A step of an autonomous routine that can wait without blocking the others
+ *
+ * A Routine is a C++20 coroutine. It starts running when it is passed to runRoutine or awaited by another routine,
+ * and every co_await hands control back to the scheduler until what it waits for is done. Since every routine runs
+ * in the same task, they never run at the same time and do not need to lock anything they share.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::Routine scoreMiddle() {
+ *     co_await chassis.moveToPoint(0, 24, 1500);
+ *     Outtake.move_voltage(12000);
+ *     co_await pushback::wait(1000);
+ *     Outtake.move_voltage(0);
+ * }
+ * @endcode
+ */
+class Routine {
+    public:
+        struct promise_type {
+                /** scheduler that resumes the routine, set when it is started */
+                RoutineScheduler* scheduler = nullptr;
+                /** routine awaiting this one, resumed when it finishes */
+                std::coroutine_handle<> continuation = nullptr;
+
+                struct FinalAwaiter {
+                        bool await_ready() const noexcept { return false; }
+
+                        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                            if (handle.promise().continuation) return handle.promise().continuation;
+                            return std::noop_coroutine();
+                        }
+
+                        void await_resume() const noexcept {}
+                };
+
+                Routine get_return_object() { return Routine(Handle::from_promise(*this)); }
+
+                std::suspend_always initial_suspend() const noexcept { return {}; }
+
+                FinalAwaiter final_suspend() const noexcept { return {}; }
+
+                void return_void() const noexcept {}
+
+                void unhandled_exception() const { throw; }
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Routine(Routine&& other) noexcept;
+        Routine& operator=(Routine&& other) noexcept;
+        /**
+         * @brief Destroy the routine. If it has not finished, it is cancelled where it is waiting
+         */
+        ~Routine();
+        /**
+         * @brief Whether the routine has run to the end
+         */
+        bool isDone() const;
+        /**
+         * @brief Start the routine on a scheduler, running it until it first waits
+         *
+         * @param scheduler the scheduler that resumes it
+         */
+        void start(RoutineScheduler* scheduler);
+
+        bool await_ready() const { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(Handle awaiting) {
+            handle.promise().scheduler = awaiting.promise().scheduler;
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        void await_resume() const {}
+    private:
+        explicit Routine(Handle handle);
+
+        Handle handle;
+};
+
+/**
+ * @brief Resumes routines once what they wait for is done
+ *
+ * Every routine run by one scheduler runs in the task that called run(). Each period, every waiting routine's
+ * condition is checked, and the routines whose condition is true are resumed until they wait again.
+ */
+class RoutineScheduler {
+    public:
+        /**
+         * @brief Create a new RoutineScheduler
+         *
+         * @param period time between checks of the waiting routines, in milliseconds. 10 by default
+         */
+        explicit RoutineScheduler(std::uint32_t period = 10);
+        /**
+         * @brief Run a routine and everything it starts, until it finishes
+         *
+         * @param routine the routine to run
+         */
+        void run(Routine routine);
+        /**
+         * @brief Resume a routine once a condition is true
+         *
+         * @param handle the waiting routine
+         * @param condition checked every period, from the scheduler's task
+         */
+        void wait(std::coroutine_handle<> handle, std::function<bool()> condition);
+        /**
+         * @brief Stop waiting for a routine that is being destroyed
+         *
+         * @param handle the routine
+         */
+        void cancel(std::coroutine_handle<> handle);
+    private:
+        struct Waiter {
+                std::coroutine_handle<> handle;
+                std::function<bool()> condition;
+        };
+
+        /**
+         * @brief Resume every waiting routine whose condition is true
+         */
+        void update();
+
+        std::uint32_t period;
+        std::vector<Waiter> waiting;
+};
+
+/**
+ * @brief Awaitable that resumes once a condition is true or a timeout passes
+ *
+ * co_await gives whether the condition was true.
+ */
+class Condition {
+    public:
+        /**
+         * @brief Create a new Condition
+         *
+         * @param condition the condition
+         * @param timeout longest time to wait, in milliseconds
+         */
+        Condition(std::function<bool()> condition, std::uint32_t timeout);
+
+        bool await_ready();
+
+        void await_suspend(Routine::Handle awaiting);
+
+        bool await_resume() const { return met; }
+    private:
+        std::function<bool()> condition;
+        std::uint32_t timeout;
+        std::uint32_t start = 0;
+        bool met = false;
+};
+
+/**
+ * @brief Awaitable that resumes once the chassis has finished its motion
+ *
+ * Returned by every motion of pushback::Chassis. If the routine awaiting it is cancelled, e.g. by any(), the motion
+ * is cancelled as well.
+ */
+class Motion {
+    public:
+        /**
+         * @brief Create a new Motion
+         *
+         * @param chassis the chassis running the motion
+         */
+        explicit Motion(lemlib::Chassis& chassis);
+        ~Motion();
+
+        bool await_ready() const;
+
+        void await_suspend(Routine::Handle awaiting);
+
+        void await_resume() { waiting = false; }
+    private:
+        lemlib::Chassis& chassis;
+        /** whether a routine is suspended on this motion */
+        bool waiting = false;
+};
+
+/**
+ * @brief Awaitable that runs several routines at the same time
+ */
+class Group {
+    public:
+        /**
+         * @brief Create a new Group
+         *
+         * @param routines the routines to run
+         * @param waitForAll whether to wait for all of them, or only the first one to finish
+         */
+        Group(std::vector<Routine> routines, bool waitForAll);
+
+        bool await_ready() const;
+
+        bool await_suspend(Routine::Handle awaiting);
+
+        void await_resume();
+    private:
+        bool isDone() const;
+
+        std::vector<Routine> routines;
+        bool waitForAll;
+};
+
+/**
+ * @brief Wait until a condition is true
+ *
+ * @param condition checked every scheduler period
+ * @param timeout longest time to wait, in milliseconds. Forever by default
+ * @return Condition awaitable giving whether the condition was met before the timeout
+ *
+ * @b Example
+ * @code {.cpp}
+ * // drop the loader 12 inches before the robot gets to it
+ * chassis.moveToPoint(0, 48, 2000);
+ * co_await pushback::waitUntil([] { return chassis.getPose().distance({0, 48, 0}) < 12; });
+ * Loader.set_value(true);
+ * @endcode
+ */
+Condition waitUntil(std::function<bool()> condition, std::uint32_t timeout = TIMEOUT_MAX);
+
+/**
+ * @brief Wait for some time
+ *
+ * @param time time to wait, in milliseconds
+ * @return Condition awaitable
+ */
+Condition wait(std::uint32_t time);
+
+/**
+ * @brief Wrap anything that can be awaited in a routine
+ */
+template <typename Awaitable> Routine toRoutine(Awaitable awaitable) { co_await awaitable; }
+
+inline Routine toRoutine(Routine routine) { return routine; }
+
+/**
+ * @brief Run routines and awaitables at the same time, and wait until they have all finished
+ *
+ * @b Example
+ * @code {.cpp}
+ * // stay at the loader for at least 2.5 seconds
+ * co_await pushback::all(chassis.moveToPoint(-31.5, 4, 1500), pushback::wait(2500));
+ * @endcode
+ */
+template <typename... Awaitables> Group all(Awaitables&&... awaitables) {
+    std::vector<Routine> routines;
+    (routines.push_back(toRoutine(std::forward<Awaitables>(awaitables))), ...);
+    return Group(std::move(routines), true);
+}
+
+/**
+ * @brief Run routines and awaitables at the same time, and wait until one of them finishes
+ *
+ * The others are cancelled where they are waiting, along with any motion they are waiting for.
+ *
+ * @b Example
+ * @code {.cpp}
+ * // drive into the goal, but give up after a second
+ * co_await pushback::any(chassis.moveToPoint(0, 48, 5000), pushback::wait(1000));
+ * @endcode
+ */
+template <typename... Awaitables> Group any(Awaitables&&... awaitables) {
+    std::vector<Routine> routines;
+    (routines.push_back(toRoutine(std::forward<Awaitables>(awaitables))), ...);
+    return Group(std::move(routines), false);
+}
+
+/**
+ * @brief Run an autonomous routine in the calling task, until it finishes
+ *
+ * Only one motion can run at a time, so routines running at the same time should not start motions at the same
+ * time: starting a motion while another is running blocks every routine until the first one finishes.
+ *
+ * @param routine the routine
+ * @param period time between checks of the waiting routines, in milliseconds. 10 by default
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::Routine leftSide() {
+ *     Intake.move_voltage(12000);
+ *     co_await chassis.moveToPoint(-6, 45, 2500);
+ *     co_await pushback::all(chassis.turnToHeading(180, 500), pushback::wait(200));
+ * }
+ *
+ * void autonomous() { pushback::runRoutine(leftSide()); }
+ * @endcode
+ */
+void runRoutine(Routine routine, std::uint32_t period = 10);
+} // namespace pushback
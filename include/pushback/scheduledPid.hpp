@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+namespace pushback {
+/**
+ * @brief One row of a gain table
+ *
+ * In a distance table, the gains are used as they are. In a speed table, they are factors the gains from the
+ * distance table are multiplied by.
+ */
+struct GainPoint {
+        /** absolute distance left to the target, or absolute speed, the row applies at */
+        float key;
+        float kP;
+        float kI;
+        float kD;
+};
+
+/**
+ * @brief Build a gain table at compile time
+ *
+ * The table is checked while compiling: the keys must be strictly increasing.
+ *
+ * @param points the rows of the table
+ * @return std::array<GainPoint, N>
+ *
+ * @b Example
+ * @code {.cpp}
+ * // stiff close to the target, softer on long moves
+ * constexpr auto lateralGains = pushback::gainTable({
+ *     {2, 14, 0, 4},
+ *     {12, 10, 0, 3},
+ *     {48, 6, 0, 3},
+ * });
+ * @endcode
+ */
+template <std::size_t N> consteval std::array<GainPoint, N> gainTable(const GainPoint (&points)[N]) {
+    std::array<GainPoint, N> table {};
+    for (std::size_t i = 0; i < N; i++) {
+        // throwing is not allowed in a constant expression, so a bad table fails to compile
+        if (i > 0 && points[i].key <= points[i - 1].key) throw "gain table keys must be strictly increasing";
+        table[i] = points[i];
+    }
+    return table;
+}
+
+/** speed table that leaves the error gains as they are */
+inline constexpr std::array<GainPoint, 1> NO_SPEED_SCALES = gainTable({{0, 1, 1, 1}});
+
+/**
+ * @brief A PID controller with scheduled gains, whatever its tables are
+ *
+ * Lets the chassis hold any ScheduledPID without knowing its tables.
+ */
+class ScheduledController {
+    public:
+        /**
+         * @brief Update the controller
+         *
+         * @param error the error to correct, e.g. how far the robot is behind its motion profile
+         * @param remaining distance left to the target of the motion, in the units of the distance table
+         * @param speed how fast the system is moving, in the units of the speed table
+         * @return float output
+         */
+        virtual float update(float error, float remaining, float speed = 0) = 0;
+        /**
+         * @brief Reset the integral and derivative
+         */
+        virtual void reset() = 0;
+        virtual ~ScheduledController() = default;
+};
+
+/**
+ * @brief PID controller with gains interpolated from tables keyed on the distance left and the speed
+ *
+ * A single set of gains has to be soft enough for long moves, where the motors are close to saturating, and stiff
+ * enough to finish 2 inch corrections. The gains here are looked up by the absolute distance left to the target of
+ * the motion, linearly interpolated between rows and held at the first and last rows. They are then multiplied by
+ * the factors looked up by the absolute speed, e.g. to add damping when arriving fast.
+ *
+ * The distance left is passed apart from the error, because the two differ: a profiled motion corrects how far the
+ * robot is behind its profile, which is small on a long traverse and a short correction alike.
+ *
+ * The tables are template parameters, so every key and slope is a constant. A lookup counts the rows the key is
+ * past without branching, then interpolates along that segment. Gains that are the same in every row, and the integral
+ * when no row has a kI, cost nothing. update() does not allocate or divide.
+ *
+ * The derivative is taken per update, like lemlib::PID, so gains tuned for lemlib carry over.
+ *
+ * @tparam DistanceGains gains by absolute distance left, a constexpr table built with gainTable
+ * @tparam SpeedScales factors for the gains by absolute speed, a constexpr table built with gainTable.
+ * NO_SPEED_SCALES by default
+ *
+ * @b Example
+ * @code {.cpp}
+ * constexpr auto lateralGains = pushback::gainTable({{2, 14, 0, 4}, {12, 10, 0, 3}, {48, 6, 0, 3}});
+ * // more damping above 40 inches per second
+ * constexpr auto lateralSpeeds = pushback::gainTable({{20, 1, 1, 1}, {60, 1, 1, 2}});
+ * pushback::ScheduledPID<lateralGains, lateralSpeeds> lateralSchedule;
+ *
+ * void initialize() {
+ *     chassis.setGainSchedules(&lateralSchedule, nullptr);
+ * }
+ * @endcode
+ */
+template <const auto& DistanceGains, const auto& SpeedScales = NO_SPEED_SCALES>
+class ScheduledPID final : public ScheduledController {
+    public:
+        /**
+         * @brief Create a new ScheduledPID
+         *
+         * @param windupRange integral is reset when the absolute error is larger than this. 0 to disable
+         * @param signFlipReset whether to reset the integral when the error changes sign
+         */
+        ScheduledPID(float windupRange = 0, bool signFlipReset = false)
+            : windupRange(windupRange),
+              signFlipReset(signFlipReset) {}
+
+        float update(float error, float remaining, float speed = 0) override {
+            const GainPoint gains = lookup<DistanceGains>(std::fabs(remaining));
+            const GainPoint scales = lookup<SpeedScales>(std::fabs(speed));
+            const float derivative = error - prevError;
+            float output = error * gains.kP * scales.kP + derivative * gains.kD * scales.kD;
+
+            // a schedule without kI skips the integral
+            if constexpr (!isConstant<DistanceGains, &GainPoint::kI>() || DistanceGains.front().kI != 0) {
+                integral += error;
+                if (signFlipReset && std::signbit(error) != std::signbit(prevError)) integral = 0;
+                if (windupRange != 0 && std::fabs(error) > windupRange) integral = 0;
+                output += integral * gains.kI * scales.kI;
+            }
+            prevError = error;
+            return output;
+        }
+
+        void reset() override {
+            integral = 0;
+            prevError = 0;
+        }
+    private:
+        /**
+         * @brief A segment of a table: the gains at its start, and their slopes along it. Aligned to a power of two,
+         * so finding one is a shift
+         */
+        struct alignas(32) Segment {
+                float key;
+                float kP;
+                float kI;
+                float kD;
+                float slopeP;
+                float slopeI;
+                float slopeD;
+        };
+
+        /**
+         * @brief Split a table into segments while compiling. Segment i starts at row i - 1, the first and last hold
+         * the first and last rows
+         */
+        template <const auto& Table> static consteval auto segments() {
+            std::array<Segment, Table.size() + 1> result {};
+            result[0] = {Table.front().key, Table.front().kP, Table.front().kI, Table.front().kD, 0, 0, 0};
+            for (std::size_t i = 1; i < Table.size(); i++) {
+                const GainPoint& low = Table[i - 1];
+                const GainPoint& high = Table[i];
+                const float width = high.key - low.key;
+                result[i] = {low.key,
+                             low.kP,
+                             low.kI,
+                             low.kD,
+                             (high.kP - low.kP) / width,
+                             (high.kI - low.kI) / width,
+                             (high.kD - low.kD) / width};
+            }
+            result[Table.size()] = {Table.back().key, Table.back().kP, Table.back().kI, Table.back().kD, 0, 0, 0};
+            return result;
+        }
+
+        /**
+         * @brief Interpolate the gains of a table at a key, holding the first and last rows
+         */
+        template <const auto& Table> static GainPoint lookup(float key) {
+            if constexpr (Table.size() == 1) return Table.front();
+            else {
+                static constexpr auto SEGMENTS = segments<Table>();
+                // the segment is the number of rows the key is past, counted without branches
+                const std::size_t index = [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    return (std::size_t(key > Table[I].key) + ...);
+                }(std::make_index_sequence<Table.size()>());
+                const Segment& segment = SEGMENTS[index];
+                const float along = key - segment.key;
+                // gains that are the same in every row are constants
+                return {key,
+                        isConstant<Table, &GainPoint::kP>() ? Table.front().kP : segment.kP + along * segment.slopeP,
+                        isConstant<Table, &GainPoint::kI>() ? Table.front().kI : segment.kI + along * segment.slopeI,
+                        isConstant<Table, &GainPoint::kD>() ? Table.front().kD : segment.kD + along * segment.slopeD};
+            }
+        }
+
+        /**
+         * @brief Check whether a gain is the same in every row of a table
+         */
+        template <const auto& Table, float GainPoint::* Gain> static consteval bool isConstant() {
+            for (const GainPoint& row : Table) {
+                if (row.*Gain != Table.front().*Gain) return false;
+            }
+            return true;
+        }
+
+        float windupRange;
+        bool signFlipReset;
+        float integral = 0;
+        float prevError = 0;
+};
+} // namespace pushback
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pushback {
+/**
+ * @brief Single writer, multiple reader snapshot of a small trivially copyable value
+ *
+ * The value is stored in a ring of versioned slots. The writer fills the slot after the one readers are currently
+ * using and then publishes it, so a reader never has to wait for a write that was preempted halfway through. A
+ * plain seqlock would spin forever on the V5 if a high priority reader interrupted a low priority writer, since the
+ * writer never gets to run again while the reader is spinning.
+ *
+ * A read only retries if the writer wraps around the whole ring while the reader is copying, which means the reader
+ * itself was preempted for several write periods.
+ *
+ * @tparam T value type. Must be trivially copyable
+ * @tparam N number of slots
+ */
+template <typename T, std::size_t N = 4> class SeqLock {
+        static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied with memcpy");
+        static_assert(N >= 2, "the writer needs a slot that readers are not using");
+    public:
+        /**
+         * @brief Create a new SeqLock
+         *
+         * @param initial value returned by load() until the first store()
+         */
+        explicit SeqLock(const T& initial) {
+            write(slots[0], 0, initial);
+            latest.store(0, std::memory_order_release);
+        }
+
+        /**
+         * @brief Publish a new value. Must only be called from one task
+         *
+         * @param value the new value
+         */
+        void store(const T& value) {
+            const std::uint32_t sequence = latest.load(std::memory_order_relaxed) + 1;
+            write(slots[sequence % N], sequence, value);
+            latest.store(sequence, std::memory_order_release);
+        }
+
+        /**
+         * @brief Get the most recently published value. Safe to call from any task
+         *
+         * @return T
+         */
+        T load() const {
+            Words words;
+            while (true) {
+                const std::uint32_t sequence = latest.load(std::memory_order_acquire);
+                const Slot& slot = slots[sequence % N];
+                const std::uint32_t before = slot.version.load(std::memory_order_acquire);
+                for (std::size_t i = 0; i < WORDS; i++) words[i] = slot.data[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const std::uint32_t after = slot.version.load(std::memory_order_relaxed);
+                // the slot holds a complete copy of this sequence number and was not overwritten while copying
+                if (before == after && before == complete(sequence)) break;
+            }
+            std::array<unsigned char, sizeof(T)> bytes;
+            std::memcpy(bytes.data(), words.data(), sizeof(T));
+            return std::bit_cast<T>(bytes);
+        }
+
+        /**
+         * @brief Get the number of values stored so far
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t sequence() const { return latest.load(std::memory_order_acquire); }
+    private:
+        static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+        using Words = std::array<std::uint32_t, WORDS>;
+
+        struct Slot {
+                /** odd while the slot is being written */
+                std::atomic<std::uint32_t> version {0};
+                std::array<std::atomic<std::uint32_t>, WORDS> data {};
+        };
+
+        static constexpr std::uint32_t complete(std::uint32_t sequence) { return sequence * 2 + 2; }
+
+        static void write(Slot& slot, std::uint32_t sequence, const T& value) {
+            Words words {};
+            std::memcpy(words.data(), &value, sizeof(T));
+            slot.version.store(complete(sequence) - 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (std::size_t i = 0; i < WORDS; i++) slot.data[i].store(words[i], std::memory_order_relaxed);
+            slot.version.store(complete(sequence), std::memory_order_release);
+        }
+
+        std::array<Slot, N> slots;
+        std::atomic<std::uint32_t> latest {0};
+};
+} // namespace pushback
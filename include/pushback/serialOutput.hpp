@@ -0,0 +1,81 @@
+#pragma once
+
+#include "pros/rtos.hpp"
+#include "pushback/byteRing.hpp"
+#include "pushback/periodicTask.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace pushback {
+/** bytes a SerialOutput holds between drains. Writes that do not fit are dropped whole */
+constexpr std::size_t SERIAL_OUTPUT_SIZE = 8192;
+
+/**
+ * @brief Output shared by the binary streams, written from one task so logging never waits on the serial port
+ *
+ * Writing to stdout blocks the calling task while the kernel's serial buffer is full, and two streams writing to it
+ * from their own tasks take turns on its lock. A SerialOutput copies each write into a ByteRing instead, and its
+ * task hands what is queued to the output in at most two contiguous pieces, straight from the ring. Writers take a
+ * mutex only for the copy, which makes the single producer ring safe for any number of tasks. A write is queued
+ * whole or dropped whole, so a full ring loses frames rather than corrupting them.
+ *
+ * The kernel wraps everything written to stdout in its own COBS packets, which the decoders in tools/ do not
+ * expect. Turn that off with serctl(SERCTL_DISABLE_COBS) before the first write to stdout.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::SerialOutput serial([](const std::uint8_t* data, std::size_t size) {
+ *     std::fwrite(data, 1, size, stdout);
+ * });
+ * pushback::DeferredLog telemetry([](const std::uint8_t* data, std::size_t size) { serial.write(data, size); });
+ *
+ * void initialize() {
+ *     pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+ *     serial.start();
+ *     telemetry.start();
+ * }
+ * @endcode
+ */
+class SerialOutput {
+    public:
+        /**
+         * @brief Create a new SerialOutput
+         *
+         * @param output called by the drain with each contiguous piece of what was written
+         * @param period time between drains, in milliseconds. 10 by default
+         */
+        SerialOutput(std::function<void(const std::uint8_t* data, std::size_t size)> output,
+                     std::uint32_t period = 10);
+        /**
+         * @brief Start draining in a task
+         */
+        void start();
+        /**
+         * @brief Queue bytes for the output. Safe from any task
+         *
+         * @param data bytes to queue
+         * @param size number of bytes
+         * @return true the bytes were queued
+         * @return false the bytes were dropped, because the drain has not caught up
+         */
+        bool write(const std::uint8_t* data, std::size_t size);
+        /**
+         * @brief Pass everything queued so far to the output. Must only be called from one task
+         */
+        void drain();
+        /**
+         * @brief Get the number of writes dropped since the output was created
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getDropped() const;
+    private:
+        std::function<void(const std::uint8_t* data, std::size_t size)> output;
+        std::uint32_t period;
+        PeriodicTask task;
+        ByteRing<SERIAL_OUTPUT_SIZE> ring;
+        /** held by writers while they copy into the ring */
+        pros::Mutex mutex;
+};
+} // namespace pushback
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "lemlib/chassis/chassis.hpp"
+#include "pros/imu.hpp"
+#include "pushback/motorTelemetry.hpp"
+#include "pushback/periodicTask.hpp"
+#include "pushback/spscQueue.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace pushback {
+/**
+ * @brief Thresholds of a SlipDetector
+ */
+struct SlipSettings {
+        /** difference between the IMU and odometry accelerations that counts as an impact, in inches per second
+         * squared. 150 by default */
+        float impactThreshold = 150;
+        /** how much faster the drive wheels can turn than the IMU says the robot moves before they count as
+         * spinning, in inches per second. 15 by default */
+        float spinThreshold = 15;
+        /** how long a difference must last before it counts, in milliseconds. 30 by default */
+        std::uint32_t debounce = 30;
+        /** how long both signals must be back to normal before the event ends, in milliseconds. 200 by default */
+        std::uint32_t release = 200;
+        /** fraction of the odometry translation kept during an impact. 0, freezing the position, by default */
+        float odomWeight = 0;
+        /** angle from the front of the robot to the y axis of the IMU, clockwise in degrees. 0 by default */
+        float imuAngle = 0;
+        /** whether odometry has tracking wheels. Without them, odometry counts wheel spin as travel, so the
+         * translation is taken from the IMU instead while the wheels spin. false by default */
+        bool trackingWheels = false;
+};
+
+/**
+ * @brief Something odometry can not be trusted through, starting or ending
+ */
+struct SlipEvent {
+        enum class Type {
+            /** the robot accelerated differently from what odometry measured, e.g. it was hit, or a tracking wheel
+               bounced */
+            IMPACT,
+            /** the drive wheels turned faster than the robot moved, e.g. it is pushing against a goal */
+            WHEEL_SPIN
+        };
+
+        Type type;
+        /** true when the event starts, false when it ends */
+        bool started;
+        /** time the event started or ended, in milliseconds */
+        std::uint32_t time;
+};
+
+/**
+ * @brief Detects impacts and wheel spin by comparing the IMU against odometry and the drive motors
+ *
+ * The detector compares the acceleration the IMU measures with the acceleration of the odometry velocity. Gravity is
+ * learned while the robot is still and taken out of the IMU reading, so a tilted mounting does not read as
+ * acceleration. Both are compared as magnitudes in the plane of the field. A large enough difference is an impact,
+ * e.g. the robot was hit or a tracking wheel bounced. While the impact lasts, only odomWeight of the odometry
+ * translation is kept. The heading comes from the IMU, so it is always kept.
+ *
+ * Wheel spin can not be found by comparing the drive motors with odometry, because without tracking wheels odometry
+ * is the drive motors. Instead, they are compared with two references that only come from the IMU: the forward
+ * speed, integrated from the forward acceleration, and the turn rate of the gyro. The integrated speed is pulled
+ * towards the wheel speed while the wheels grip, so it does not drift, and runs on the IMU alone while they spin.
+ * Without tracking wheels, the odometry translation follows the integrated speed while the wheels spin.
+ *
+ * Setting the pose, e.g. with Chassis::setPose, is recognized as a jump no robot could make and not as an impact.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::SlipDetector slip(imu, drivetrain);
+ *
+ * pushback::Routine pushIntoGoal() {
+ *     // stop pushing as soon as the robot hits the goal
+ *     co_await pushback::any(chassis.moveToPoint(0, 48, 2000), pushback::waitUntil([] {
+ *         return slip.isActive(pushback::SlipEvent::Type::IMPACT);
+ *     }));
+ * }
+ * @endcode
+ */
+class SlipDetector {
+    public:
+        /**
+         * @brief Create a new SlipDetector
+         *
+         * @param imu the IMU
+         * @param drivetrain drivetrain the odometry belongs to
+         * @param settings thresholds
+         */
+        SlipDetector(pros::Imu& imu, const lemlib::Drivetrain& drivetrain, SlipSettings settings = {});
+        /**
+         * @brief Start checking in a task, at the odometry rate
+         */
+        void start();
+        /**
+         * @brief Whether an event of a type is going on. Safe to call from any task
+         *
+         * @param type the type of event
+         */
+        bool isActive(SlipEvent::Type type) const;
+        /**
+         * @brief Take the oldest event from the queue. Must only be called from one task
+         *
+         * @param event set to the event taken
+         * @return whether there was an event
+         */
+        bool poll(SlipEvent& event);
+        /**
+         * @brief Get the number of impacts since the detector started. Safe to call from any task
+         */
+        std::uint32_t getImpacts() const;
+        /**
+         * @brief Check the sensors once, and correct odometry during an impact
+         */
+        void update();
+    private:
+        /**
+         * @brief State of one kind of event, with debouncing
+         */
+        struct Detection {
+                /** time the signal last crossed over or under the threshold, in milliseconds */
+                std::uint32_t since = 0;
+                bool over = false;
+                std::atomic<bool> active = false;
+        };
+
+        /**
+         * @brief Update one detection, and push an event if it starts or ends
+         */
+        void detect(Detection& detection, SlipEvent::Type type, bool over, std::uint32_t now);
+        /**
+         * @brief Get the average surface speed of the drive wheels on one side, in inches per second
+         */
+        float wheelSpeed(const MotorSampler& sampler, const pros::MotorGroup& motors);
+        /**
+         * @brief Start comparing again from the current readings
+         */
+        void rebase(const lemlib::Pose& pose, const lemlib::Pose& speed, std::uint32_t now);
+
+        pros::Imu& imu;
+        lemlib::Drivetrain drivetrain;
+        SlipSettings settings;
+        MotorSampler leftSampler;
+        MotorSampler rightSampler;
+        MotorTelemetry telemetry;
+        PeriodicTask task;
+
+        Detection impact;
+        Detection spin;
+        SpscQueue<SlipEvent, 16> events;
+        std::atomic<std::uint32_t> impacts = 0;
+
+        /** filtered accelerations, in inches per second squared */
+        float imuAcceleration = 0;
+        float odomAcceleration = 0;
+        /** gravity as the IMU measures it while the robot is still, in g. Straight down until the robot is still */
+        float gravity[3] = {0, 0, 1};
+        /** time the robot was last seen moving, in milliseconds */
+        std::uint32_t stillSince = 0;
+        /** forward speed integrated from the IMU, in inches per second */
+        float imuSpeed = 0;
+        /** time until which readings are only used as a new baseline, after the pose was set */
+        std::uint32_t rebaseUntil = 0;
+        lemlib::Pose lastSpeed {0, 0, 0};
+        lemlib::Pose lastPose {0, 0, 0};
+        std::uint32_t lastTime = 0;
+};
+} // namespace pushback
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pushback {
+/**
+ * @brief Bounded lock-free queue for one producer task and one consumer task
+ *
+ * Each index is only written by one side, so pushing and popping never block or disable interrupts, and a
+ * preempted producer can never hold up the consumer. When the queue is full, push() fails instead of overwriting.
+ *
+ * @tparam T value type
+ * @tparam N capacity. Must be a power of two
+ */
+template <typename T, std::size_t N> class SpscQueue {
+        static_assert(N > 0 && (N & (N - 1)) == 0, "the capacity must be a power of two");
+    public:
+        /**
+         * @brief Add a value to the back of the queue. Must only be called from the producer task
+         *
+         * @param value the value to add
+         * @return true the value was added
+         * @return false the queue is full
+         */
+        bool push(const T& value) {
+            const std::uint32_t tail = this->tail.load(std::memory_order_relaxed);
+            if (tail - head.load(std::memory_order_acquire) == N) return false;
+            items[tail % N] = value;
+            this->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Take the value at the front of the queue. Must only be called from the consumer task
+         *
+         * @param value set to the value taken
+         * @return true a value was taken
+         * @return false the queue is empty
+         */
+        bool pop(T& value) {
+            const std::uint32_t head = this->head.load(std::memory_order_relaxed);
+            if (head == tail.load(std::memory_order_acquire)) return false;
+            value = items[head % N];
+            this->head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Get the number of values in the queue. Exact only when called from the producer or consumer
+         *
+         * @return std::size_t
+         */
+        std::size_t size() const {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+    private:
+        std::array<T, N> items {};
+        /** index of the next value to pop, only written by the consumer */
+        std::atomic<std::uint32_t> head = 0;
+        /** index of the next value to push, only written by the producer */
+        std::atomic<std::uint32_t> tail = 0;
+};
+} // namespace pushback
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "pushback/periodicTask.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace pushback {
+/** most channels a TelemetryStream can carry */
+constexpr std::size_t MAX_TELEMETRY_CHANNELS = 32;
+
+/**
+ * @brief Binary stream of sampled values, sending only what changed
+ *
+ * Streaming telemetry as text at 100 Hz needs more than the serial link can carry. A TelemetryStream reads its
+ * channels at a fixed rate, rounds each value to the resolution of its channel, and sends the difference from the
+ * previous sample, for the channels that changed. tools/decode_telemetry.py turns the stream back into a table.
+ *
+ * The channels are declared once, in a schema frame, with their names and resolutions. The schema is sent again
+ * every 2 seconds, so a decoder can join late. Every 50 samples, a key frame carries every value in full, so a
+ * lost frame only corrupts the samples until the next key frame. The decoder notices lost frames, by their
+ * sequence number or checksum, and skips ahead to the next key frame.
+ *
+ * Each frame is checked with a CRC-16/CCITT-FALSE, COBS encoded, and written with a 0x00 before and after it. Text
+ * never contains 0x00, so frames can share a serial stream with text. Before COBS, a frame is:
+ *
+ *     type      uint8, 0 for a schema, 1 for a key frame, 2 for a delta frame
+ *     sequence  uint8, one more than the previous frame's
+ *     body      a schema: channel count (uint8), then for each channel its resolution (float32), name length
+ *               (uint8) and name
+ *               a key frame: time in milliseconds, then every channel's value in units of its resolution
+ *               a delta frame: milliseconds since the previous sample, a bit mask of the channels that changed,
+ *               then the change of each of them, in units of its resolution
+ *     crc       uint16 over the type, sequence and body
+ *
+ * Multi-byte numbers are little endian. Times and masks are unsigned LEB128 varints. Values and changes are signed,
+ * zigzag encoded, then varints. A value that is not a number counts as unchanged.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::TelemetryStream telemetry([](const std::uint8_t* data, std::size_t size) {
+ *     std::fwrite(data, 1, size, stdout);
+ * });
+ *
+ * void initialize() {
+ *     telemetry.addChannel("x", 0.01, [] { return chassis.getPose().x; });
+ *     telemetry.addChannel("y", 0.01, [] { return chassis.getPose().y; });
+ *     telemetry.start();
+ * }
+ * @endcode
+ *
+ * then, on the computer: pros terminal --raw | python3 tools/decode_telemetry.py -o run.csv
+ */
+class TelemetryStream {
+    public:
+        /**
+         * @brief Create a new TelemetryStream
+         *
+         * @param write called with the encoded frames
+         * @param period time between samples, in milliseconds. 10 by default
+         */
+        TelemetryStream(std::function<void(const std::uint8_t* data, std::size_t size)> write,
+                        std::uint32_t period = 10);
+        /**
+         * @brief Declare a channel. Must be called before start()
+         *
+         * Channels after the first MAX_TELEMETRY_CHANNELS are left out, and logged as an error.
+         *
+         * @param name name of the column in the decoded table
+         * @param resolution values are rounded to a multiple of this. The coarser it is, the smaller the stream
+         * @param read called by the stream's task for the value of each sample
+         * @return int index of the channel, -1 if it was left out
+         */
+        int addChannel(std::string_view name, float resolution, std::function<float()> read);
+        /**
+         * @brief Start sampling in a task
+         */
+        void start();
+        /**
+         * @brief Read every channel and send the sample
+         *
+         * @param time time of the sample, in milliseconds
+         */
+        void sample(std::uint32_t time);
+        /**
+         * @brief Get the number of bytes written since the stream was created
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getBytesWritten() const;
+    private:
+        struct Channel {
+                std::string name;
+                float resolution = 1;
+                std::function<float()> read;
+                /** value of the last sample, in units of the resolution */
+                std::int32_t last = 0;
+        };
+
+        /**
+         * @brief Check, encode and write one frame
+         */
+        void send(const std::uint8_t* frame, std::size_t size);
+
+        std::function<void(const std::uint8_t* data, std::size_t size)> write;
+        std::uint32_t period;
+        PeriodicTask task;
+        std::array<Channel, MAX_TELEMETRY_CHANNELS> channels;
+        std::size_t channelCount = 0;
+        std::uint32_t samples = 0;
+        std::uint32_t lastTime = 0;
+        std::uint8_t sequence = 0;
+        std::atomic<std::uint32_t> bytesWritten = 0;
+};
+} // namespace pushback
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "pros/motor_group.hpp"
+#include "pushback/motorTelemetry.hpp"
+#include "pushback/periodicTask.hpp"
+#include "pushback/seqlock.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace pushback {
+/** most motors a ThermalGovernor can watch */
+constexpr std::size_t MAX_THERMAL_MOTORS = 2 * MAX_SAMPLED_MOTORS;
+
+/**
+ * @brief Thermal model of a motor, and the limits it is kept under
+ *
+ * The motor is modeled as a single thermal mass: it heats up with the square of its current, and cools towards the
+ * ambient temperature. The defaults are for an 11W V5 motor.
+ */
+struct ThermalSettings {
+        /** heating, in degrees celsius per second per amp squared */
+        float heating = 0.1;
+        /** cooling, as the fraction of the difference to ambient lost per second */
+        float cooling = 1.0 / 600;
+        /** ambient temperature, in degrees celsius */
+        float ambient = 25;
+        /** temperature the firmware starts throttling the motor at, in degrees celsius */
+        float cutoff = 55;
+        /** temperature at which the current limit starts to be lowered, in degrees celsius */
+        float softLimit = 50;
+        /** how far ahead the temperature is predicted, in seconds */
+        float horizon = 20;
+        /** current limit when the motors are cool, in milliamps */
+        float maxCurrent = 2500;
+        /** lowest fraction of maxCurrent the limit is lowered to */
+        float minScale = 0.5;
+};
+
+/**
+ * @brief State of a ThermalGovernor, for telemetry
+ */
+struct ThermalState {
+        /** number of motors watched */
+        std::size_t count;
+        /** estimated temperature of each motor, in degrees celsius */
+        std::array<float, MAX_THERMAL_MOTORS> temperature;
+        /** time until each motor reaches the cutoff at its current draw, in seconds. Infinite if it never does */
+        std::array<float, MAX_THERMAL_MOTORS> timeToCutoff;
+        /** current limit applied to every motor, in milliamps */
+        float currentLimit;
+        /** time of the update, in milliseconds */
+        std::uint32_t time;
+};
+
+/**
+ * @brief Lowers the current limit of motor groups before they overheat
+ *
+ * The V5 firmware halves the current of a motor once it reaches its cutoff temperature, which makes the robot
+ * suddenly lose half its power. The governor estimates the temperature of every motor from its current draw,
+ * corrected by the coarse temperature sensor, and predicts where it will be after the horizon at the same draw. As
+ * the hottest prediction goes from the soft limit to the cutoff, the current limit of every motor is lowered from
+ * maxCurrent to minScale of it, so the robot slows down gradually and evenly on both sides.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::ThermalGovernor thermal({&leftMotors, &rightMotors});
+ *
+ * void initialize() {
+ *     thermal.start();
+ * }
+ *
+ * void screen() {
+ *     const pushback::ThermalState state = thermal.getState();
+ *     pros::lcd::print(4, "Drive limit: %.0f mA", state.currentLimit);
+ * }
+ * @endcode
+ */
+class ThermalGovernor {
+    public:
+        /**
+         * @brief Create a new ThermalGovernor
+         *
+         * @param groups the motor groups to watch. Motors after the first MAX_THERMAL_MOTORS are left out
+         * @param settings thermal model and limits
+         * @param period time between updates, in milliseconds. 100 by default
+         */
+        ThermalGovernor(std::initializer_list<pros::MotorGroup*> groups, ThermalSettings settings = {},
+                        std::uint32_t period = 100);
+        /**
+         * @brief Start updating in a task
+         */
+        void start();
+        /**
+         * @brief Get the latest state. Safe to call from any task
+         *
+         * @return ThermalState
+         */
+        ThermalState getState() const;
+        /**
+         * @brief Update the model and the current limit once
+         *
+         * @param dt time since the last update, in seconds
+         */
+        void update(float dt);
+    private:
+        /**
+         * @brief Predict the temperature of a motor after some time at a constant current
+         *
+         * @param temperature temperature now, in degrees celsius
+         * @param current current draw, in amps
+         * @param time time ahead, in seconds
+         * @return float
+         */
+        float predict(float temperature, float current, float time) const;
+        /**
+         * @brief Get how long a motor takes to reach the cutoff at a constant current, in seconds
+         */
+        float timeToCutoff(float temperature, float current) const;
+
+        std::vector<pros::MotorGroup*> groups;
+        std::vector<MotorSampler> samplers;
+        ThermalSettings settings;
+        std::uint32_t period;
+        PeriodicTask task;
+        /** estimated temperatures, 0 until the first reading */
+        std::array<float, MAX_THERMAL_MOTORS> estimates {};
+        MotorTelemetry telemetry;
+        /** current limit last sent to the motors, in milliamps */
+        float currentLimit;
+        SeqLock<ThermalState> state;
+};
+} // namespace pushback
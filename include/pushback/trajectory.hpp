@@ -0,0 +1,69 @@
+#pragma once
+
+#include "pushback/path.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace pushback {
+/**
+ * @brief Where a trajectory says the robot should be at one point in time
+ */
+struct TrajectoryState {
+        /** position, in inches */
+        float x;
+        float y;
+        /** heading of the path, in radians, clockwise from +y */
+        float theta;
+        /** arc length from the start of the path, in inches */
+        float distance;
+        /** velocity along the path, in inches per second */
+        float velocity;
+        /** acceleration along the path, in inches per second squared */
+        float acceleration;
+        /** rate the path turns, in radians per second, clockwise */
+        float angularVelocity;
+};
+
+/**
+ * @brief A compiled path parameterized by time
+ *
+ * The time to reach each point is integrated from the velocity profile stored in the path when the trajectory is
+ * created. Sampling walks a cursor forward, so sampling at increasing times costs the same however long the path
+ * is.
+ *
+ * @b Example
+ * @code {.cpp}
+ * pushback::Path path(Goal_To_Goal_Turn_path);
+ * pushback::Trajectory trajectory(path);
+ * // where the robot should be a second into the path
+ * const pushback::TrajectoryState state = trajectory.sample(1);
+ * @endcode
+ */
+class Trajectory {
+    public:
+        /**
+         * @brief Create a new Trajectory
+         *
+         * @param path the path, which must be valid and outlive the trajectory
+         */
+        explicit Trajectory(const Path& path);
+        /**
+         * @brief Get the state of the trajectory at a point in time
+         *
+         * @param time time since the start of the trajectory, in seconds. Clamped to the duration
+         * @return TrajectoryState
+         */
+        TrajectoryState sample(float time);
+        /**
+         * @brief Get how long the trajectory takes, in seconds
+         */
+        float getDuration() const;
+    private:
+        const Path& path;
+        /** time each point is reached, in seconds */
+        std::vector<float> times;
+        /** heading of the path at each point, in radians */
+        std::vector<float> headings;
+        std::size_t cursor = 0;
+};
+} // namespace pushback
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief A tracking wheel mounted on a rotation sensor
+ *
+ * The offset follows the LemLib convention, so the same number that is passed to
+ * lemlib::TrackingWheel in src/main.cpp can be used here.
+ */
+struct TrackingWheelConfig {
+        /** rotation sensor port. Negative if the sensor is reversed in src/main.cpp */
+        std::int8_t port;
+        /** wheel diameter, in inches */
+        float diameter;
+        /** offset from the tracking center, in inches */
+        float offset;
+        /** true for a wheel that measures forwards travel, false for sideways travel */
+        bool vertical;
+};
+
+/**
+ * @brief A distance sensor mounted on the robot
+ *
+ * Mounting positions are relative to the tracking center, with +y pointing forwards
+ * and +x pointing to the right of the robot.
+ */
+struct DistanceSensorConfig {
+        std::uint8_t port;
+        float x;
+        float y;
+        /** direction the sensor faces, in degrees clockwise from the front of the robot */
+        float heading;
+};
+
+/**
+ * @brief Physical description of the simulated robot
+ *
+ * This mirrors the device declarations in src/main.cpp. If a port or dimension changes there, it needs to be
+ * changed in sim/src/robot.cpp as well.
+ */
+struct RobotConfig {
+        /** drivetrain motor ports, negative if the motor is reversed in src/main.cpp */
+        std::vector<std::int8_t> leftPorts;
+        std::vector<std::int8_t> rightPorts;
+        /** distance between the left and right wheels, in inches */
+        float trackWidth;
+        /** drive wheel diameter, in inches */
+        float wheelDiameter;
+        /** drive wheel rpm at full motor speed */
+        float wheelRpm;
+        /** free speed of the drive motor cartridge, in rpm */
+        float cartridgeRpm;
+        /** time constant of the loaded drivetrain, in seconds */
+        float driveTimeConstant;
+        /** length and width of the robot frame, in inches. Used for wall collisions */
+        float length;
+        float width;
+        std::uint8_t imuPort;
+        std::vector<TrackingWheelConfig> trackingWheels;
+        std::vector<DistanceSensorConfig> distanceSensors;
+};
+
+/**
+ * @brief Field-relative starting pose for an autonomous routine
+ *
+ * The field origin is the center of the field, matching path.jerryio and the paths in static/.
+ */
+struct StartPose {
+        float x;
+        float y;
+        /** heading in degrees, clockwise from +y */
+        float theta;
+};
+
+/**
+ * @brief Get the robot description used by the simulator
+ *
+ * @return RobotConfig
+ */
+RobotConfig robotConfig();
+
+/**
+ * @brief Get the default starting pose for an autonomous routine
+ *
+ * @param auton the value of selected_auton in src/main.cpp
+ * @return StartPose
+ */
+StartPose defaultStartPose(int auton);
+} // namespace sim
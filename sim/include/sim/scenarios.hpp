@@ -0,0 +1,18 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace sim {
+/**
+ * @brief Run a named scenario instead of autonomous()
+ *
+ * Scenarios exercise one part of the chassis code on the simulated robot, and print what they measured to stderr.
+ * They run after initialize(), on the competition task. Each one checks what it measured against what the code
+ * under test promises, and prints a line starting with FAIL for every check that does not hold.
+ *
+ * @param name name of the scenario
+ * @return whether every check passed, or std::nullopt if there is no scenario with that name
+ */
+std::optional<bool> runScenario(const std::string& name);
+} // namespace sim
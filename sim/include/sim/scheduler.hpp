@@ -0,0 +1,118 @@
+#pragma once
+
+#include "pros/rtos.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * @brief A simulated RTOS task
+ *
+ * Every task is backed by a host thread, but only the task holding the baton is allowed to run.
+ */
+struct Task {
+        enum class State { READY, SLEEPING, SUSPENDED, WAITING, DONE };
+
+        std::uint32_t id;
+        std::string name;
+        std::uint32_t priority;
+        State state = State::READY;
+        /** virtual time at which a sleeping or waiting task becomes ready, in milliseconds */
+        std::uint64_t wakeTime = 0;
+        std::uint32_t notifyValue = 0;
+};
+
+/**
+ * @brief Cooperative scheduler driving the virtual clock
+ *
+ * PROS tasks only give up the processor in delay(), blocking calls, or when they end. The simulator exploits this:
+ * exactly one task runs at a time, and when every task is sleeping the clock jumps straight to the next wake time,
+ * stepping the physics model on the way. A 60 second routine therefore finishes as fast as the host can run the
+ * user code, and two runs with the same inputs produce the same result.
+ */
+class Scheduler {
+    public:
+        /**
+         * @brief Get the scheduler
+         */
+        static Scheduler& get();
+        /**
+         * @brief Set the function used to advance the physics model
+         *
+         * @param step called once per millisecond of virtual time, with the time step in seconds
+         */
+        void onStep(std::function<void(double)> step);
+        /**
+         * @brief Create a task. The task starts running the next time the current task yields
+         *
+         * @return task handle, usable with the pros::c task functions
+         */
+        Task* create(pros::task_fn_t function, void* parameters, std::uint32_t prio, const char* name);
+        /**
+         * @brief Run the scheduler until stop() is called, every task has ended, or the time limit is reached
+         *
+         * @param timeLimit virtual time limit, in milliseconds
+         * @return true if the run ended before the time limit
+         */
+        bool run(std::uint64_t timeLimit);
+        /**
+         * @brief End the run. The current task does not run again
+         */
+        [[noreturn]] void stop();
+
+        /**
+         * @brief Get the current virtual time, in microseconds
+         */
+        std::uint64_t micros() const;
+        /**
+         * @brief Get the task that is currently running, or nullptr outside of the simulation
+         */
+        Task* current() const;
+        /**
+         * @brief Put the current task to sleep
+         *
+         * @param ms time to sleep, in milliseconds. 0 yields to other ready tasks
+         */
+        void sleep(std::uint32_t ms);
+        /**
+         * @brief Block the current task until it is notified or the timeout expires
+         *
+         * @param timeout timeout in milliseconds, or TIMEOUT_MAX
+         */
+        void wait(std::uint32_t timeout);
+        /**
+         * @brief Make a waiting or suspended task ready
+         */
+        void wake(Task* task);
+        void suspend(Task* task);
+        /**
+         * @brief Remove a task. If the current task removes itself, this call does not return
+         */
+        void remove(Task* task);
+        std::uint32_t count() const;
+        Task* find(const char* name) const;
+    private:
+        Scheduler() = default;
+        void switchAway(std::unique_lock<std::mutex>& lock, Task* self);
+        void waitForTurn(std::unique_lock<std::mutex>& lock, Task* self);
+        void finish(std::unique_lock<std::mutex>& lock, Task* self);
+        Task* pickNext();
+
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::unique_ptr<Task>> tasks;
+        std::deque<Task*> ready;
+        Task* running = nullptr;
+        std::uint64_t now = 0;
+        std::uint64_t limit = 0;
+        bool started = false;
+        bool stopped = false;
+        std::function<void(double)> step;
+};
+} // namespace sim
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "pros/abstract_motor.hpp"
+#include "sim/config.hpp"
+#include <array>
+#include <cstdint>
+#include <random>
+
+namespace sim {
+/** half the inside length of the field perimeter, in inches */
+constexpr double FIELD_HALF_WIDTH = 70.2;
+
+/**
+ * @brief How a motor is currently being driven
+ */
+enum class MotorMode {
+    POWER, /** open loop duty cycle of the battery voltage, from move() */
+    VOLTAGE, /** open loop regulated voltage, from move_voltage() */
+    VELOCITY, /** closed loop velocity, from move_velocity() */
+    POSITION, /** closed loop position, from move_absolute() or move_relative() */
+};
+
+/**
+ * @brief State of a simulated smart motor
+ *
+ * All quantities are physical, i.e. before the reversal implied by a negative port is applied.
+ * The pros::Motor and pros::MotorGroup shims apply the sign of the port they were constructed with.
+ */
+struct MotorState {
+        bool installed = false;
+        pros::MotorGears gearing = pros::MotorGears::green;
+        pros::MotorUnits units = pros::MotorUnits::degrees;
+        pros::MotorBrake brakeMode = pros::MotorBrake::coast;
+        MotorMode mode = MotorMode::VOLTAGE;
+        /** millivolts for VOLTAGE, millivolts out of 12000 for POWER, rpm for VELOCITY and POSITION */
+        double command = 0;
+        /** target in degrees for POSITION */
+        double target = 0;
+        std::int32_t currentLimit = 2500;
+        std::int32_t voltageLimit = 0;
+        /** output shaft speed, in rpm */
+        double velocity = 0;
+        /** output shaft position, in degrees */
+        double position = 0;
+        double zero = 0;
+        double voltage = 0;
+        double current = 0;
+        double torque = 0;
+        double temperature = 25;
+        /** number of commands received */
+        std::uint32_t writes = 0;
+
+        /**
+         * @brief Free speed of the cartridge, in rpm
+         */
+        double freeSpeed() const;
+        /**
+         * @brief Convert a position in degrees to the configured encoder units
+         */
+        double toUnits(double degrees) const;
+        /**
+         * @brief Convert a position in the configured encoder units to degrees
+         */
+        double fromUnits(double value) const;
+};
+
+/**
+ * @brief State of a simulated rotation sensor
+ */
+struct RotationState {
+        bool installed = false;
+        bool reversed = false;
+        /** physical position, in centidegrees */
+        double position = 0;
+        /** physical velocity, in centidegrees per second */
+        double velocity = 0;
+};
+
+/**
+ * @brief State of a simulated inertial sensor
+ */
+struct ImuState {
+        bool installed = false;
+        /** virtual time at which calibration finishes, in milliseconds */
+        std::uint32_t calibratedAt = 0;
+        /** offset applied to the rotation reading by tare/set_rotation */
+        double rotationOffset = 0;
+        double headingOffset = 0;
+        /** accumulated gyro drift, in degrees */
+        double drift = 0;
+};
+
+/**
+ * @brief State of a simulated distance sensor
+ */
+struct DistanceState {
+        bool installed = false;
+        /** last reading in millimeters, 9999 if nothing is in range */
+        std::int32_t distance = 9999;
+        std::int32_t confidence = 0;
+};
+
+/**
+ * @brief Virtual controller. Inputs can be scripted by the simulator harness
+ */
+struct ControllerState {
+        std::array<std::int32_t, 4> analog {};
+        std::array<bool, 32> digital {};
+        std::array<bool, 32> pressed {};
+        std::array<bool, 32> released {};
+};
+
+/**
+ * @brief Ground truth state of the simulated robot
+ */
+struct RobotState {
+        /** field-relative position in inches, origin at the center of the field */
+        double x = 0;
+        double y = 0;
+        /** heading in radians, clockwise from +y */
+        double theta = 0;
+        /** left and right wheel surface speeds, in inches per second */
+        double leftSpeed = 0;
+        double rightSpeed = 0;
+        /** ground speed of the tracking center, in inches per second */
+        double speed = 0;
+        /** angular velocity, in radians per second, clockwise positive */
+        double angularSpeed = 0;
+        /** acceleration in the robot frame, filtered like an IMU reading, in inches per second squared */
+        double localAccelX = 0;
+        double localAccelY = 0;
+        /** true while the robot is pushing against the field perimeter */
+        bool colliding = false;
+        /** number of times the robot has hit the field perimeter */
+        std::uint32_t collisions = 0;
+};
+
+/**
+ * @brief Differential drive physics model backing the PROS device shims
+ *
+ * The world is advanced in fixed steps by the scheduler whenever virtual time moves forwards.
+ * Only one task runs at a time, so the device shims can read and write the world without locking.
+ */
+class World {
+    public:
+        /**
+         * @brief Get the world
+         */
+        static World& get();
+        /**
+         * @brief Set up the robot and place it on the field
+         *
+         * @param config physical description of the robot
+         * @param start field-relative starting pose
+         * @param seed seed for sensor noise, 0 for noiseless sensors
+         */
+        void configure(const RobotConfig& config, StartPose start, std::uint32_t seed);
+        /**
+         * @brief Advance the physics model
+         *
+         * @param dt time step, in seconds
+         */
+        void step(double dt);
+        /**
+         * @brief Set the battery voltage at the start of the run
+         *
+         * @param millivolts open circuit voltage of the battery
+         */
+        void setBattery(double millivolts);
+        /**
+         * @brief Get the battery voltage under the current load, in millivolts
+         */
+        double batteryVoltage() const;
+        /**
+         * @brief Get the total current drawn by all motors, in milliamps
+         */
+        double batteryCurrent() const;
+
+        MotorState& motor(std::int8_t port);
+        RotationState& rotation(std::int8_t port);
+        ImuState& imu(std::uint8_t port);
+        DistanceState& distance(std::uint8_t port);
+        ControllerState& controller();
+        /**
+         * @brief Get or set the value of a three wire port
+         *
+         * @param port port number, 1-8 or 'A'-'H'
+         */
+        std::int32_t& adi(std::uint8_t port);
+        /**
+         * @brief Register a device on a smart port, warning if the port is already used by another kind of device
+         *
+         * @param port smart port, 1-21
+         * @param type kind of device, e.g. "motor"
+         */
+        void claim(std::uint8_t port, const char* type);
+
+        /**
+         * @brief Get the rotation reading of an IMU, in degrees
+         */
+        double imuRotation(std::uint8_t port) const;
+
+        const RobotState& robot() const;
+        const RobotConfig& config() const;
+        /**
+         * @brief Get the ground truth pose relative to the starting pose, in the same frame as lemlib odometry
+         *
+         * @param x output x position, in inches
+         * @param y output y position, in inches
+         * @param theta output heading, in degrees
+         */
+        void relativePose(double& x, double& y, double& theta) const;
+    private:
+        World() = default;
+        void stepMotor(MotorState& motor, double dt, double load);
+        void stepSensors(double dt, double dTheta, double dForward, double dLateral);
+        double castRay(double x, double y, double heading) const;
+
+        RobotConfig cfg;
+        StartPose start {0, 0, 0};
+        RobotState state;
+        std::array<MotorState, 22> motors {};
+        std::array<RotationState, 22> rotations {};
+        std::array<ImuState, 22> imus {};
+        std::array<DistanceState, 22> distances {};
+        std::array<std::int32_t, 9> adiPorts {};
+        std::array<const char*, 22> owners {};
+        ControllerState controllerState;
+        double batteryOpenCircuit = 12800;
+        bool noisy = false;
+        std::mt19937 rng;
+};
+} // namespace sim
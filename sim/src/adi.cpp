@@ -0,0 +1,41 @@
+#include "pros/adi.hpp"
+#include "sim/world.hpp"
+
+/**
+ * Host implementation of the three wire ports on the brain. Values are stored in sim::World so the harness can
+ * report pneumatics state; expanders are accepted but share the brain's ports.
+ */
+
+namespace pros {
+namespace adi {
+Port::Port(std::uint8_t adi_port, adi_port_config_e_t type) : _smart_port(INTERNAL_ADI_PORT), _adi_port(adi_port) {
+    set_config(type);
+}
+
+Port::Port(ext_adi_port_pair_t port_pair, adi_port_config_e_t type)
+    : _smart_port(port_pair.first), _adi_port(port_pair.second) {
+    set_config(type);
+}
+
+std::int32_t Port::get_config() const { return E_ADI_TYPE_UNDEFINED; }
+
+std::int32_t Port::get_value() const { return sim::World::get().adi(_adi_port); }
+
+std::int32_t Port::set_config(adi_port_config_e_t) const { return 1; }
+
+std::int32_t Port::set_value(std::int32_t value) const {
+    sim::World::get().adi(_adi_port) = value;
+    return 1;
+}
+
+ext_adi_port_tuple_t Port::get_port() const { return std::make_tuple(_smart_port, _adi_port, 0); }
+
+DigitalOut::DigitalOut(std::uint8_t adi_port, bool init_state) : Port(adi_port, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+DigitalOut::DigitalOut(ext_adi_port_pair_t port_pair, bool init_state) : Port(port_pair, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+} // namespace adi
+} // namespace pros
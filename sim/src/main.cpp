@@ -0,0 +1,183 @@
+#include "lemlib/chassis/odom.hpp"
+#include "main.h"
+#include "pushback/chassis.hpp"
+#include "sim/config.hpp"
+#include "sim/scenarios.hpp"
+#include "sim/scheduler.hpp"
+#include "sim/world.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <unistd.h>
+
+/**
+ * Simulator harness. Runs initialize() and autonomous() from src/main.cpp against the simulated robot and
+ * reports where the robot ended up.
+ *
+ * With --tune, runs the step response experiment of Chassis::tuneLateral or Chassis::tuneAngular instead of
+ * autonomous(), and reports the suggested gains. The sim is deterministic, so the same robot config and battery
+ * always give the same suggestion.
+ *
+ * With --scenario, runs one of the scenarios in sim/src/scenarios.cpp instead of autonomous(), and exits with 1 if
+ * any of its checks failed.
+ *
+ * The binary streams of src/main.cpp are written to stdout, for tools/decode_telemetry.py and tools/decode_log.py.
+ * When stdout is a terminal they are discarded instead, and only the --trace rows are printed.
+ *
+ * usage: pushback-sim [--auton N] [--start x,y,theta] [--duration ms] [--seed N] [--battery mV] [--trace ms]
+ *                     [--tune lateral|angular] [--scenario name]
+ */
+
+// defined in src/main.cpp
+extern int selected_auton;
+extern pushback::Chassis chassis;
+
+namespace {
+struct Options {
+        int auton = selected_auton;
+        bool customStart = false;
+        sim::StartPose start {0, 0, 0};
+        std::uint32_t duration = 0;
+        std::uint32_t seed = 0;
+        double battery = 12800;
+        std::uint32_t trace = 0;
+        /** axis to tune, empty to run autonomous() */
+        std::string tune;
+        /** scenario to run, empty to run autonomous() */
+        std::string scenario;
+};
+
+Options options;
+/** result of --tune, reported once the scheduler stops */
+std::optional<pushback::TuneResult> tuned;
+/** whether the checks of --scenario held, for the exit code */
+bool passed = true;
+/** where the --trace rows go, stdout unless that is a terminal */
+std::FILE* traceOutput = stdout;
+
+[[noreturn]] void usage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [--auton N] [--start x,y,theta] [--duration ms] [--seed N] [--battery mV] [--trace ms]"
+                 " [--tune lateral|angular] [--scenario name]\n",
+                 program);
+    std::exit(2);
+}
+
+Options parse(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) usage(argv[0]);
+        const char* value = argv[++i];
+        if (arg == "--auton") {
+            options.auton = std::atoi(value);
+        } else if (arg == "--start") {
+            if (std::sscanf(value, "%f,%f,%f", &options.start.x, &options.start.y, &options.start.theta) != 3) {
+                usage(argv[0]);
+            }
+            options.customStart = true;
+        } else if (arg == "--duration") {
+            options.duration = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--battery") {
+            options.battery = std::atof(value);
+        } else if (arg == "--trace") {
+            options.trace = std::strtoul(value, nullptr, 10);
+        } else if (arg == "--tune") {
+            options.tune = value;
+            if (options.tune != "lateral" && options.tune != "angular") usage(argv[0]);
+        } else if (arg == "--scenario") {
+            options.scenario = value;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    // match autons get the 15 second autonomous period, skills gets a full minute
+    if (options.duration == 0) options.duration = options.auton == 2 ? 60000 : 15000;
+    if (!options.customStart) options.start = sim::defaultStartPose(options.auton);
+    return options;
+}
+
+void printTrace(std::uint64_t time) {
+    const sim::RobotState& robot = sim::World::get().robot();
+    const lemlib::Pose odom = lemlib::getPose();
+    std::fprintf(traceOutput, "%llu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", static_cast<unsigned long long>(time), robot.x,
+                 robot.y, robot.theta * 180 / M_PI, odom.x, odom.y, odom.theta);
+}
+
+void competition(void*) {
+    initialize();
+    if (options.tune == "lateral") tuned = chassis.tuneLateral();
+    else if (options.tune == "angular") tuned = chassis.tuneAngular();
+    else if (options.scenario.empty()) autonomous();
+    else {
+        const std::optional<bool> result = sim::runScenario(options.scenario);
+        if (!result) std::fprintf(stderr, "unknown scenario %s\n", options.scenario.c_str());
+        passed = result.value_or(false);
+    }
+    sim::Scheduler::get().stop();
+}
+
+void printTune(const pushback::TuneResult& result) {
+    const pushback::FopdtModel& model = result.model;
+    std::fprintf(stderr, "%s model: gain %.3f, time constant %.3f s, dead time %.3f s, fit error %.2f\n",
+                 options.tune.c_str(), model.gain, model.timeConstant, model.deadTime, model.error);
+    std::fprintf(stderr, "suggested kP %.3f kI %.3f kD %.3f\n", result.settings.kP, result.settings.kI,
+                 result.settings.kD);
+    std::fprintf(stderr, "predicted on %.0f: settles in %.2f s, %.2f overshoot\n", result.target, result.settleTime,
+                 result.overshoot);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    options = parse(argc, argv);
+    selected_auton = options.auton;
+
+    // binary on a terminal is noise. The trace keeps the terminal, the streams go nowhere
+    if (isatty(STDOUT_FILENO)) {
+        traceOutput = fdopen(dup(STDOUT_FILENO), "w");
+        if (std::freopen("/dev/null", "w", stdout) == nullptr) traceOutput = stdout;
+    }
+
+    sim::World& world = sim::World::get();
+    world.configure(sim::robotConfig(), options.start, options.seed);
+    world.setBattery(options.battery);
+
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    std::uint64_t steps = 0;
+    if (options.trace > 0) std::fprintf(traceOutput, "time,x,y,theta,odom_x,odom_y,odom_theta\n");
+    scheduler.onStep([&](double dt) {
+        world.step(dt);
+        if (options.trace > 0 && ++steps % options.trace == 0) printTrace(steps);
+    });
+    scheduler.create(competition, nullptr, TASK_PRIORITY_DEFAULT, "competition");
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool finished = scheduler.run(options.duration);
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const sim::RobotState& robot = world.robot();
+    double maxTemperature = 0;
+    for (std::int8_t port : world.config().leftPorts) {
+        maxTemperature = std::max(maxTemperature, world.motor(port).temperature);
+    }
+    for (std::int8_t port : world.config().rightPorts) {
+        maxTemperature = std::max(maxTemperature, world.motor(port).temperature);
+    }
+    const double virtualTime = scheduler.micros() / 1e6;
+    std::fprintf(stderr, "auton %d %s after %.3f s (%.3f s wall, %.0fx real time)\n", options.auton,
+                 finished ? "finished" : "timed out", virtualTime, wall, virtualTime / std::max(wall, 1e-6));
+    std::fprintf(stderr, "pose: x %.2f y %.2f theta %.2f\n", robot.x, robot.y, robot.theta * 180 / M_PI);
+    std::fprintf(stderr, "collisions: %u, max drive temperature: %.1f C\n", robot.collisions, maxTemperature);
+    if (tuned) printTune(*tuned);
+    std::fflush(stdout);
+    std::fflush(traceOutput);
+    // task threads are still parked inside the scheduler, so skip static destructors
+    std::_Exit(passed ? 0 : 1);
+}
@@ -0,0 +1,228 @@
+#include "liblvgl/llemu.hpp"
+#include "pros/error.h"
+#include "pros/llemu.hpp"
+#include "pros/misc.h"
+#include "pros/misc.hpp"
+#include "sim/world.hpp"
+#include <array>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+/**
+ * Host implementation of the controller, battery, competition, LLEMU and SD card APIs.
+ * LLEMU output is kept in memory but not displayed.
+ */
+
+namespace {
+std::array<std::string, 8> screen;
+bool screenInitialized = false;
+
+sim::ControllerState& controllerState() { return sim::World::get().controller(); }
+
+bool validButton(pros::controller_digital_e_t button) {
+    return button >= 0 && std::size_t(button) < controllerState().digital.size();
+}
+} // namespace
+
+namespace pros {
+namespace c {
+uint8_t competition_get_status(void) { return COMPETITION_AUTONOMOUS; }
+
+uint8_t competition_is_disabled(void) { return 0; }
+
+uint8_t competition_is_connected(void) { return 0; }
+
+uint8_t competition_is_autonomous(void) { return 1; }
+
+uint8_t competition_is_field(void) { return 0; }
+
+uint8_t competition_is_switch(void) { return 0; }
+
+int32_t controller_is_connected(controller_id_e_t id) { return id == E_CONTROLLER_MASTER; }
+
+int32_t controller_get_analog(controller_id_e_t id, controller_analog_e_t channel) {
+    if (id != E_CONTROLLER_MASTER || channel < 0 || channel > 3) return 0;
+    return controllerState().analog[channel];
+}
+
+int32_t controller_get_battery_capacity(controller_id_e_t) { return 100; }
+
+int32_t controller_get_battery_level(controller_id_e_t) { return 100; }
+
+int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t button) {
+    if (id != E_CONTROLLER_MASTER || !validButton(button)) return 0;
+    return controllerState().digital[button];
+}
+
+int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
+    if (id != E_CONTROLLER_MASTER || !validButton(button)) return 0;
+    const bool pressed = controllerState().pressed[button];
+    controllerState().pressed[button] = false;
+    return pressed;
+}
+
+int32_t controller_get_digital_new_release(controller_id_e_t id, controller_digital_e_t button) {
+    if (id != E_CONTROLLER_MASTER || !validButton(button)) return 0;
+    const bool released = controllerState().released[button];
+    controllerState().released[button] = false;
+    return released;
+}
+
+int32_t controller_print(controller_id_e_t, uint8_t, uint8_t, const char*, ...) { return 1; }
+
+int32_t controller_set_text(controller_id_e_t, uint8_t, uint8_t, const char*) { return 1; }
+
+int32_t controller_clear_line(controller_id_e_t, uint8_t) { return 1; }
+
+int32_t controller_clear(controller_id_e_t) { return 1; }
+
+int32_t controller_rumble(controller_id_e_t, const char*) { return 1; }
+
+int32_t battery_get_voltage(void) { return sim::World::get().batteryVoltage(); }
+
+int32_t battery_get_current(void) { return sim::World::get().batteryCurrent(); }
+
+double battery_get_temperature(void) { return 25; }
+
+double battery_get_capacity(void) { return 100; }
+
+int32_t usd_is_installed(void) { return 0; }
+
+int32_t usd_list_files(const char*, char*, int32_t) { return PROS_ERR; }
+
+bool lcd_is_initialized(void) { return screenInitialized; }
+
+bool lcd_initialize(void) {
+    screenInitialized = true;
+    return true;
+}
+
+bool lcd_shutdown(void) {
+    screenInitialized = false;
+    return true;
+}
+
+bool lcd_print(int16_t line, const char* fmt, ...) {
+    if (line < 0 || std::size_t(line) >= screen.size()) return false;
+    char buffer[64];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    screen[line] = buffer;
+    return true;
+}
+
+bool lcd_set_text(int16_t line, const char* text) { return lcd_print(line, "%s", text); }
+
+bool lcd_clear(void) {
+    for (std::string& line : screen) line.clear();
+    return true;
+}
+
+bool lcd_clear_line(int16_t line) { return lcd_set_text(line, ""); }
+
+bool lcd_register_btn0_cb(lcd_btn_cb_fn_t) { return true; }
+
+bool lcd_register_btn1_cb(lcd_btn_cb_fn_t) { return true; }
+
+bool lcd_register_btn2_cb(lcd_btn_cb_fn_t) { return true; }
+
+uint8_t lcd_read_buttons(void) { return 0; }
+
+void lcd_set_text_align(text_align_e_t) {}
+} // namespace c
+
+namespace lcd {
+bool is_initialized(void) { return c::lcd_is_initialized(); }
+
+bool initialize(void) { return c::lcd_initialize(); }
+
+bool shutdown(void) { return c::lcd_shutdown(); }
+
+bool set_text(std::int16_t line, std::string text) { return c::lcd_set_text(line, text.c_str()); }
+
+bool clear(void) { return c::lcd_clear(); }
+
+bool clear_line(std::int16_t line) { return c::lcd_clear_line(line); }
+
+void register_btn0_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn0_cb(cb); }
+
+void register_btn1_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn1_cb(cb); }
+
+void register_btn2_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn2_cb(cb); }
+
+void set_text_align(Text_Align) {}
+
+std::uint8_t read_buttons(void) { return c::lcd_read_buttons(); }
+} // namespace lcd
+
+inline namespace v5 {
+Controller::Controller(controller_id_e_t id) : _id(id) {}
+
+std::int32_t Controller::is_connected(void) { return c::controller_is_connected(_id); }
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) { return c::controller_get_analog(_id, channel); }
+
+std::int32_t Controller::get_battery_capacity(void) { return c::controller_get_battery_capacity(_id); }
+
+std::int32_t Controller::get_battery_level(void) { return c::controller_get_battery_level(_id); }
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) { return c::controller_get_digital(_id, button); }
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+    return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::get_digital_new_release(controller_digital_e_t button) {
+    return c::controller_get_digital_new_release(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
+    return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+    return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) { return c::controller_clear_line(_id, line); }
+
+std::int32_t Controller::rumble(const char* rumble_pattern) { return c::controller_rumble(_id, rumble_pattern); }
+
+std::int32_t Controller::clear(void) { return c::controller_clear(_id); }
+} // namespace v5
+
+namespace battery {
+double get_capacity(void) { return c::battery_get_capacity(); }
+
+int32_t get_current(void) { return c::battery_get_current(); }
+
+double get_temperature(void) { return c::battery_get_temperature(); }
+
+int32_t get_voltage(void) { return c::battery_get_voltage(); }
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status(void) { return c::competition_get_status(); }
+
+std::uint8_t is_autonomous(void) { return c::competition_is_autonomous(); }
+
+std::uint8_t is_connected(void) { return c::competition_is_connected(); }
+
+std::uint8_t is_disabled(void) { return c::competition_is_disabled(); }
+
+std::uint8_t is_field_control(void) { return c::competition_is_field(); }
+
+std::uint8_t is_competition_switch(void) { return c::competition_is_switch(); }
+} // namespace competition
+
+namespace usd {
+std::int32_t is_installed(void) { return c::usd_is_installed(); }
+
+std::int32_t list_files(const char* path, char* buffer, std::int32_t len) {
+    return c::usd_list_files(path, buffer, len);
+}
+} // namespace usd
+} // namespace pros
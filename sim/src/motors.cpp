@@ -0,0 +1,738 @@
+#include "pros/error.h"
+#include "pros/motor_group.hpp"
+#include "pros/motors.h"
+#include "pros/motors.hpp"
+#include "sim/world.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+/**
+ * Host implementation of pros::Motor and pros::MotorGroup. Every call is forwarded to a port-level helper that
+ * applies the sign of the port, mirroring how the PROS kernel forwards to its C API.
+ */
+
+namespace {
+using sim::MotorMode;
+using sim::MotorState;
+
+MotorState& state(std::int8_t port) { return sim::World::get().motor(port); }
+
+double sign(std::int8_t port) { return port < 0 ? -1 : 1; }
+
+std::int32_t command(std::int8_t port, MotorMode mode, double value) {
+    MotorState& m = state(port);
+    m.mode = mode;
+    m.command = sign(port) * value;
+    m.writes++;
+    return 1;
+}
+
+std::int32_t moveVoltage(std::int8_t port, double millivolts) {
+    return command(port, MotorMode::VOLTAGE, std::clamp(millivolts, -12000.0, 12000.0));
+}
+
+std::int32_t movePower(std::int8_t port, std::int32_t power) {
+    return command(port, MotorMode::POWER, std::clamp(power, -127, 127) * 12000.0 / 127);
+}
+
+std::int32_t moveTo(std::int8_t port, double degrees, std::int32_t velocity) {
+    MotorState& m = state(port);
+    m.mode = MotorMode::POSITION;
+    m.target = degrees;
+    m.command = std::abs(velocity);
+    m.writes++;
+    return 1;
+}
+
+double position(std::int8_t port) {
+    const MotorState& m = state(port);
+    return sign(port) * m.toUnits(m.position - m.zero);
+}
+
+double targetPosition(std::int8_t port) {
+    const MotorState& m = state(port);
+    return sign(port) * m.toUnits(m.target - m.zero);
+}
+
+std::int32_t targetVelocity(std::int8_t port) {
+    const MotorState& m = state(port);
+    const bool open = m.mode == MotorMode::VOLTAGE || m.mode == MotorMode::POWER;
+    return open ? 0 : std::int32_t(sign(port) * m.command);
+}
+
+double efficiency(std::int8_t port) {
+    const MotorState& m = state(port);
+    if (std::fabs(m.voltage) < 1) return 0;
+    return 100 * std::clamp(12000 * m.velocity / m.freeSpeed() / m.voltage, 0.0, 1.0);
+}
+
+std::uint32_t faults(std::int8_t port) {
+    const MotorState& m = state(port);
+    std::uint32_t result = pros::E_MOTOR_FAULT_NO_FAULTS;
+    if (m.temperature >= 55) result |= pros::E_MOTOR_FAULT_MOTOR_OVER_TEMP;
+    if (std::fabs(m.current) >= m.currentLimit) result |= pros::E_MOTOR_FAULT_OVER_CURRENT;
+    return result;
+}
+
+std::uint32_t flags(std::int8_t port) {
+    const MotorState& m = state(port);
+    return std::fabs(m.velocity) < 1 ? pros::E_MOTOR_FLAGS_ZERO_VELOCITY : pros::E_MOTOR_FLAGS_NONE;
+}
+
+std::int32_t rawPosition(std::int8_t port, std::uint32_t* const timestamp) {
+    const MotorState& m = state(port);
+    if (timestamp != nullptr) *timestamp = pros::c::millis();
+    return std::int32_t(sign(port) * m.position * (1800 / m.freeSpeed()) / 360);
+}
+
+std::int32_t setZero(std::int8_t port, double value) {
+    MotorState& m = state(port);
+    m.zero = m.position - sign(port) * m.fromUnits(value);
+    return 1;
+}
+
+pros::MotorGears toGears(pros::motor_gearset_e_t gearset) { return static_cast<pros::MotorGears>(gearset); }
+
+pros::MotorUnits toUnits(pros::motor_encoder_units_e_t units) { return static_cast<pros::MotorUnits>(units); }
+
+pros::MotorBrake toBrake(pros::motor_brake_mode_e_t mode) { return static_cast<pros::MotorBrake>(mode); }
+
+template <typename F> auto collect(const std::vector<std::int8_t>& ports, F f) {
+    std::vector<decltype(f(std::int8_t()))> result;
+    result.reserve(ports.size());
+    for (std::int8_t port : ports) result.push_back(f(port));
+    return result;
+}
+
+template <typename F> std::int32_t forEach(const std::vector<std::int8_t>& ports, F f) {
+    for (std::int8_t port : ports) f(port);
+    return 1;
+}
+} // namespace
+
+namespace pros {
+inline namespace v5 {
+Motor::Motor(const std::int8_t port, const MotorGears gearset, const MotorUnits encoder_units)
+    : Device(std::abs(port), DeviceType::motor),
+      _port(port) {
+    sim::World::get().claim(std::abs(port), "motor");
+    state(port).installed = true;
+    if (gearset != MotorGears::invalid) set_gearing(gearset);
+    if (encoder_units != MotorUnits::invalid) set_encoder_units(encoder_units);
+}
+
+std::int32_t Motor::move(std::int32_t voltage) const { return movePower(_port, voltage); }
+
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const {
+    const MotorState& m = state(_port);
+    return moveTo(_port, m.zero + sign(_port) * m.fromUnits(position), velocity);
+}
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const {
+    const MotorState& m = state(_port);
+    return moveTo(_port, m.position + sign(_port) * m.fromUnits(position), velocity);
+}
+
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const {
+    return command(_port, MotorMode::VELOCITY, velocity);
+}
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const { return moveVoltage(_port, voltage); }
+
+std::int32_t Motor::brake(void) const { return moveVoltage(_port, 0); }
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const {
+    state(_port).command = std::abs(velocity);
+    return 1;
+}
+
+double Motor::get_target_position(const std::uint8_t) const { return targetPosition(_port); }
+
+std::int32_t Motor::get_target_velocity(const std::uint8_t) const { return targetVelocity(_port); }
+
+double Motor::get_actual_velocity(const std::uint8_t) const { return sign(_port) * state(_port).velocity; }
+
+std::int32_t Motor::get_current_draw(const std::uint8_t) const { return std::fabs(state(_port).current); }
+
+std::int32_t Motor::get_direction(const std::uint8_t) const { return get_actual_velocity() < 0 ? -1 : 1; }
+
+double Motor::get_efficiency(const std::uint8_t) const { return efficiency(_port); }
+
+std::uint32_t Motor::get_faults(const std::uint8_t) const { return faults(_port); }
+
+std::uint32_t Motor::get_flags(const std::uint8_t) const { return flags(_port); }
+
+double Motor::get_position(const std::uint8_t) const { return position(_port); }
+
+double Motor::get_power(const std::uint8_t) const {
+    const MotorState& m = state(_port);
+    return std::fabs(m.voltage * m.current) / 1e6;
+}
+
+std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t) const {
+    return rawPosition(_port, timestamp);
+}
+
+double Motor::get_temperature(const std::uint8_t) const { return state(_port).temperature; }
+
+double Motor::get_torque(const std::uint8_t) const { return std::fabs(state(_port).torque); }
+
+std::int32_t Motor::get_voltage(const std::uint8_t) const { return sign(_port) * state(_port).voltage; }
+
+std::int32_t Motor::is_over_current(const std::uint8_t) const {
+    return (faults(_port) & E_MOTOR_FAULT_OVER_CURRENT) != 0;
+}
+
+std::int32_t Motor::is_over_temp(const std::uint8_t) const {
+    return (faults(_port) & E_MOTOR_FAULT_MOTOR_OVER_TEMP) != 0;
+}
+
+MotorBrake Motor::get_brake_mode(const std::uint8_t) const { return state(_port).brakeMode; }
+
+std::int32_t Motor::get_current_limit(const std::uint8_t) const { return state(_port).currentLimit; }
+
+MotorUnits Motor::get_encoder_units(const std::uint8_t) const { return state(_port).units; }
+
+MotorGears Motor::get_gearing(const std::uint8_t) const { return state(_port).gearing; }
+
+std::int32_t Motor::get_voltage_limit(const std::uint8_t) const { return state(_port).voltageLimit; }
+
+std::int32_t Motor::is_reversed(const std::uint8_t) const { return _port < 0; }
+
+MotorType Motor::get_type(const std::uint8_t) const { return MotorType::v5; }
+
+std::int32_t Motor::set_brake_mode(const MotorBrake mode, const std::uint8_t) const {
+    state(_port).brakeMode = mode;
+    return 1;
+}
+
+std::int32_t Motor::set_brake_mode(const motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    return set_brake_mode(toBrake(mode), index);
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit, const std::uint8_t) const {
+    state(_port).currentLimit = std::clamp(limit, 0, 2500);
+    return 1;
+}
+
+std::int32_t Motor::set_encoder_units(const MotorUnits units, const std::uint8_t) const {
+    state(_port).units = units;
+    return 1;
+}
+
+std::int32_t Motor::set_encoder_units(const motor_encoder_units_e_t units, const std::uint8_t index) const {
+    return set_encoder_units(toUnits(units), index);
+}
+
+std::int32_t Motor::set_gearing(const MotorGears gearset, const std::uint8_t) const {
+    state(_port).gearing = gearset;
+    return 1;
+}
+
+std::int32_t Motor::set_gearing(const motor_gearset_e_t gearset, const std::uint8_t index) const {
+    return set_gearing(toGears(gearset), index);
+}
+
+std::int32_t Motor::set_reversed(const bool reverse, const std::uint8_t) {
+    _port = reverse ? -std::abs(_port) : std::abs(_port);
+    return 1;
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit, const std::uint8_t) const {
+    state(_port).voltageLimit = limit;
+    return 1;
+}
+
+std::int32_t Motor::set_zero_position(const double position, const std::uint8_t) const {
+    return setZero(_port, position);
+}
+
+std::int32_t Motor::tare_position(const std::uint8_t) const { return setZero(_port, 0); }
+
+std::int8_t Motor::size(void) const { return 1; }
+
+std::vector<Motor> Motor::get_all_devices() {
+    std::vector<Motor> result;
+    for (std::int8_t port = 1; port <= 21; port++) {
+        if (state(port).installed) result.emplace_back(port);
+    }
+    return result;
+}
+
+std::int8_t Motor::get_port(const std::uint8_t) const { return _port; }
+
+std::vector<double> Motor::get_target_position_all(void) const { return {get_target_position()}; }
+
+std::vector<std::int32_t> Motor::get_target_velocity_all(void) const { return {get_target_velocity()}; }
+
+std::vector<double> Motor::get_actual_velocity_all(void) const { return {get_actual_velocity()}; }
+
+std::vector<std::int32_t> Motor::get_current_draw_all(void) const { return {get_current_draw()}; }
+
+std::vector<std::int32_t> Motor::get_direction_all(void) const { return {get_direction()}; }
+
+std::vector<double> Motor::get_efficiency_all(void) const { return {get_efficiency()}; }
+
+std::vector<std::uint32_t> Motor::get_faults_all(void) const { return {get_faults()}; }
+
+std::vector<std::uint32_t> Motor::get_flags_all(void) const { return {get_flags()}; }
+
+std::vector<double> Motor::get_position_all(void) const { return {get_position()}; }
+
+std::vector<double> Motor::get_power_all(void) const { return {get_power()}; }
+
+std::vector<std::int32_t> Motor::get_raw_position_all(std::uint32_t* const timestamp) const {
+    return {get_raw_position(timestamp)};
+}
+
+std::vector<double> Motor::get_temperature_all(void) const { return {get_temperature()}; }
+
+std::vector<double> Motor::get_torque_all(void) const { return {get_torque()}; }
+
+std::vector<std::int32_t> Motor::get_voltage_all(void) const { return {get_voltage()}; }
+
+std::vector<std::int32_t> Motor::is_over_current_all(void) const { return {is_over_current()}; }
+
+std::vector<std::int32_t> Motor::is_over_temp_all(void) const { return {is_over_temp()}; }
+
+std::vector<MotorBrake> Motor::get_brake_mode_all(void) const { return {get_brake_mode()}; }
+
+std::vector<std::int32_t> Motor::get_current_limit_all(void) const { return {get_current_limit()}; }
+
+std::vector<MotorUnits> Motor::get_encoder_units_all(void) const { return {get_encoder_units()}; }
+
+std::vector<MotorGears> Motor::get_gearing_all(void) const { return {get_gearing()}; }
+
+std::vector<std::int8_t> Motor::get_port_all(void) const { return {_port}; }
+
+std::vector<std::int32_t> Motor::get_voltage_limit_all(void) const { return {get_voltage_limit()}; }
+
+std::vector<std::int32_t> Motor::is_reversed_all(void) const { return {is_reversed()}; }
+
+std::vector<MotorType> Motor::get_type_all(void) const { return {get_type()}; }
+
+std::int32_t Motor::set_brake_mode_all(const MotorBrake mode) const { return set_brake_mode(mode); }
+
+std::int32_t Motor::set_brake_mode_all(const motor_brake_mode_e_t mode) const { return set_brake_mode(mode); }
+
+std::int32_t Motor::set_current_limit_all(const std::int32_t limit) const { return set_current_limit(limit); }
+
+std::int32_t Motor::set_encoder_units_all(const MotorUnits units) const { return set_encoder_units(units); }
+
+std::int32_t Motor::set_encoder_units_all(const motor_encoder_units_e_t units) const {
+    return set_encoder_units(units);
+}
+
+std::int32_t Motor::set_gearing_all(const MotorGears gearset) const { return set_gearing(gearset); }
+
+std::int32_t Motor::set_gearing_all(const motor_gearset_e_t gearset) const { return set_gearing(gearset); }
+
+std::int32_t Motor::set_reversed_all(const bool reverse) { return set_reversed(reverse); }
+
+std::int32_t Motor::set_voltage_limit_all(const std::int32_t limit) const { return set_voltage_limit(limit); }
+
+std::int32_t Motor::set_zero_position_all(const double position) const { return set_zero_position(position); }
+
+std::int32_t Motor::tare_position_all(void) const { return tare_position(); }
+
+MotorGroup::MotorGroup(const std::initializer_list<std::int8_t> ports, const MotorGears gearset,
+                       const MotorUnits encoder_units)
+    : MotorGroup(std::vector<std::int8_t>(ports), gearset, encoder_units) {}
+
+MotorGroup::MotorGroup(const std::vector<std::int8_t>& ports, const MotorGears gearset, const MotorUnits encoder_units)
+    : _ports(ports) {
+    for (std::int8_t port : _ports) Motor(port, gearset, encoder_units);
+}
+
+MotorGroup::MotorGroup(AbstractMotor& motor_group) : _ports(motor_group.get_port_all()) {}
+
+// the single motor accessors of a group act on the motor at the given index
+#define MOTOR_AT(index) \
+    if (index >= _ports.size()) { \
+        errno = ENXIO; \
+        return PROS_ERR; \
+    } \
+    const Motor motor(_ports[index])
+
+std::int32_t MotorGroup::move(std::int32_t voltage) const {
+    return forEach(_ports, [&](std::int8_t port) { Motor(port).move(voltage); });
+}
+
+std::int32_t MotorGroup::move_absolute(const double position, const std::int32_t velocity) const {
+    return forEach(_ports, [&](std::int8_t port) { Motor(port).move_absolute(position, velocity); });
+}
+
+std::int32_t MotorGroup::move_relative(const double position, const std::int32_t velocity) const {
+    return forEach(_ports, [&](std::int8_t port) { Motor(port).move_relative(position, velocity); });
+}
+
+std::int32_t MotorGroup::move_velocity(const std::int32_t velocity) const {
+    return forEach(_ports, [&](std::int8_t port) { Motor(port).move_velocity(velocity); });
+}
+
+std::int32_t MotorGroup::move_voltage(const std::int32_t voltage) const {
+    return forEach(_ports, [&](std::int8_t port) { Motor(port).move_voltage(voltage); });
+}
+
+std::int32_t MotorGroup::brake(void) const {
+    return forEach(_ports, [&](std::int8_t port) { Motor(port).brake(); });
+}
+
+std::int32_t MotorGroup::modify_profiled_velocity(const std::int32_t velocity) const {
+    return forEach(_ports, [&](std::int8_t port) { Motor(port).modify_profiled_velocity(velocity); });
+}
+
+double MotorGroup::get_target_position(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_target_position();
+}
+
+std::int32_t MotorGroup::get_target_velocity(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_target_velocity();
+}
+
+double MotorGroup::get_actual_velocity(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_actual_velocity();
+}
+
+std::int32_t MotorGroup::get_current_draw(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_current_draw();
+}
+
+std::int32_t MotorGroup::get_direction(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_direction();
+}
+
+double MotorGroup::get_efficiency(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_efficiency();
+}
+
+std::uint32_t MotorGroup::get_faults(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_faults();
+}
+
+std::uint32_t MotorGroup::get_flags(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_flags();
+}
+
+double MotorGroup::get_position(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_position();
+}
+
+double MotorGroup::get_power(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_power();
+}
+
+std::int32_t MotorGroup::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_raw_position(timestamp);
+}
+
+double MotorGroup::get_temperature(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_temperature();
+}
+
+double MotorGroup::get_torque(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_torque();
+}
+
+std::int32_t MotorGroup::get_voltage(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_voltage();
+}
+
+std::int32_t MotorGroup::is_over_current(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.is_over_current();
+}
+
+std::int32_t MotorGroup::is_over_temp(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.is_over_temp();
+}
+
+MotorBrake MotorGroup::get_brake_mode(const std::uint8_t index) const {
+    if (index >= _ports.size()) return MotorBrake::invalid;
+    return Motor(_ports[index]).get_brake_mode();
+}
+
+std::int32_t MotorGroup::get_current_limit(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_current_limit();
+}
+
+MotorUnits MotorGroup::get_encoder_units(const std::uint8_t index) const {
+    if (index >= _ports.size()) return MotorUnits::invalid;
+    return Motor(_ports[index]).get_encoder_units();
+}
+
+MotorGears MotorGroup::get_gearing(const std::uint8_t index) const {
+    if (index >= _ports.size()) return MotorGears::invalid;
+    return Motor(_ports[index]).get_gearing();
+}
+
+std::int32_t MotorGroup::get_voltage_limit(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.get_voltage_limit();
+}
+
+std::int32_t MotorGroup::is_reversed(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.is_reversed();
+}
+
+MotorType MotorGroup::get_type(const std::uint8_t index) const {
+    if (index >= _ports.size()) return MotorType::invalid;
+    return MotorType::v5;
+}
+
+std::int32_t MotorGroup::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.set_brake_mode(mode);
+}
+
+std::int32_t MotorGroup::set_brake_mode(const motor_brake_mode_e_t mode, const std::uint8_t index) const {
+    return set_brake_mode(toBrake(mode), index);
+}
+
+std::int32_t MotorGroup::set_current_limit(const std::int32_t limit, const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.set_current_limit(limit);
+}
+
+std::int32_t MotorGroup::set_encoder_units(const MotorUnits units, const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.set_encoder_units(units);
+}
+
+std::int32_t MotorGroup::set_encoder_units(const motor_encoder_units_e_t units, const std::uint8_t index) const {
+    return set_encoder_units(toUnits(units), index);
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<motor_gearset_e_t> gearsets) const {
+    for (std::size_t i = 0; i < gearsets.size() && i < _ports.size(); i++) set_gearing(gearsets[i], i);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing(const motor_gearset_e_t gearset, const std::uint8_t index) const {
+    return set_gearing(toGears(gearset), index);
+}
+
+std::int32_t MotorGroup::set_gearing(std::vector<MotorGears> gearsets) const {
+    for (std::size_t i = 0; i < gearsets.size() && i < _ports.size(); i++) set_gearing(gearsets[i], i);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_gearing(const MotorGears gearset, const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.set_gearing(gearset);
+}
+
+std::int32_t MotorGroup::set_reversed(const bool reverse, const std::uint8_t index) {
+    if (index >= _ports.size()) {
+        errno = ENXIO;
+        return PROS_ERR;
+    }
+    _ports[index] = reverse ? -std::abs(_ports[index]) : std::abs(_ports[index]);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.set_voltage_limit(limit);
+}
+
+std::int32_t MotorGroup::set_zero_position(const double position, const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.set_zero_position(position);
+}
+
+std::int32_t MotorGroup::tare_position(const std::uint8_t index) const {
+    MOTOR_AT(index);
+    return motor.tare_position();
+}
+
+#undef MOTOR_AT
+
+std::vector<double> MotorGroup::get_target_position_all(void) const { return collect(_ports, targetPosition); }
+
+std::vector<std::int32_t> MotorGroup::get_target_velocity_all(void) const { return collect(_ports, targetVelocity); }
+
+std::vector<double> MotorGroup::get_actual_velocity_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return Motor(port).get_actual_velocity(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_draw_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return Motor(port).get_current_draw(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_direction_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return Motor(port).get_direction(); });
+}
+
+std::vector<double> MotorGroup::get_efficiency_all(void) const { return collect(_ports, efficiency); }
+
+std::vector<std::uint32_t> MotorGroup::get_faults_all(void) const { return collect(_ports, faults); }
+
+std::vector<std::uint32_t> MotorGroup::get_flags_all(void) const { return collect(_ports, flags); }
+
+std::vector<double> MotorGroup::get_position_all(void) const { return collect(_ports, position); }
+
+std::vector<double> MotorGroup::get_power_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return Motor(port).get_power(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_raw_position_all(std::uint32_t* const timestamp) const {
+    return collect(_ports, [&](std::int8_t port) { return rawPosition(port, timestamp); });
+}
+
+std::vector<double> MotorGroup::get_temperature_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return state(port).temperature; });
+}
+
+std::vector<double> MotorGroup::get_torque_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return Motor(port).get_torque(); });
+}
+
+std::vector<std::int32_t> MotorGroup::get_voltage_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return Motor(port).get_voltage(); });
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_current_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return Motor(port).is_over_current(); });
+}
+
+std::vector<std::int32_t> MotorGroup::is_over_temp_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return Motor(port).is_over_temp(); });
+}
+
+std::vector<MotorBrake> MotorGroup::get_brake_mode_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return state(port).brakeMode; });
+}
+
+std::vector<std::int32_t> MotorGroup::get_current_limit_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return state(port).currentLimit; });
+}
+
+std::vector<MotorUnits> MotorGroup::get_encoder_units_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return state(port).units; });
+}
+
+std::vector<MotorGears> MotorGroup::get_gearing_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return state(port).gearing; });
+}
+
+std::vector<std::int8_t> MotorGroup::get_port_all(void) const { return _ports; }
+
+std::vector<std::int32_t> MotorGroup::get_voltage_limit_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return state(port).voltageLimit; });
+}
+
+std::vector<std::int32_t> MotorGroup::is_reversed_all(void) const {
+    return collect(_ports, [](std::int8_t port) { return std::int32_t(port < 0); });
+}
+
+std::vector<MotorType> MotorGroup::get_type_all(void) const {
+    return collect(_ports, [](std::int8_t) { return MotorType::v5; });
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const MotorBrake mode) const {
+    return forEach(_ports, [&](std::int8_t port) { state(port).brakeMode = mode; });
+}
+
+std::int32_t MotorGroup::set_brake_mode_all(const motor_brake_mode_e_t mode) const {
+    return set_brake_mode_all(toBrake(mode));
+}
+
+std::int32_t MotorGroup::set_current_limit_all(const std::int32_t limit) const {
+    return forEach(_ports, [&](std::int8_t port) { Motor(port).set_current_limit(limit); });
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const MotorUnits units) const {
+    return forEach(_ports, [&](std::int8_t port) { state(port).units = units; });
+}
+
+std::int32_t MotorGroup::set_encoder_units_all(const motor_encoder_units_e_t units) const {
+    return set_encoder_units_all(toUnits(units));
+}
+
+std::int32_t MotorGroup::set_gearing_all(const MotorGears gearset) const {
+    return forEach(_ports, [&](std::int8_t port) { state(port).gearing = gearset; });
+}
+
+std::int32_t MotorGroup::set_gearing_all(const motor_gearset_e_t gearset) const {
+    return set_gearing_all(toGears(gearset));
+}
+
+std::int32_t MotorGroup::set_reversed_all(const bool reverse) {
+    for (std::int8_t& port : _ports) port = reverse ? -std::abs(port) : std::abs(port);
+    return 1;
+}
+
+std::int32_t MotorGroup::set_voltage_limit_all(const std::int32_t limit) const {
+    return forEach(_ports, [&](std::int8_t port) { state(port).voltageLimit = limit; });
+}
+
+std::int32_t MotorGroup::set_zero_position_all(const double position) const {
+    return forEach(_ports, [&](std::int8_t port) { setZero(port, position); });
+}
+
+std::int32_t MotorGroup::tare_position_all(void) const {
+    return forEach(_ports, [&](std::int8_t port) { setZero(port, 0); });
+}
+
+std::int8_t MotorGroup::size(void) const { return _ports.size(); }
+
+std::int8_t MotorGroup::get_port(const std::uint8_t index) const {
+    if (index >= _ports.size()) {
+        errno = ENXIO;
+        return PROS_ERR_BYTE;
+    }
+    return _ports[index];
+}
+
+void MotorGroup::operator+=(AbstractMotor& other) { append(other); }
+
+void MotorGroup::append(AbstractMotor& other) {
+    for (std::int8_t port : other.get_port_all()) _ports.push_back(port);
+}
+
+void MotorGroup::erase_port(std::int8_t port) {
+    _ports.erase(std::remove_if(_ports.begin(), _ports.end(), [&](std::int8_t p) { return std::abs(p) == std::abs(port); }),
+                 _ports.end());
+}
+} // namespace v5
+} // namespace pros
+
+namespace pros {
+namespace c {
+double motor_get_actual_velocity(int8_t port) { return sign(port) * state(port).velocity; }
+
+int32_t motor_get_current_draw(int8_t port) { return std::fabs(state(port).current); }
+
+double motor_get_efficiency(int8_t port) { return efficiency(port); }
+
+uint32_t motor_get_faults(int8_t port) { return faults(port); }
+
+double motor_get_position(int8_t port) { return position(port); }
+
+double motor_get_temperature(int8_t port) { return state(port).temperature; }
+
+double motor_get_torque(int8_t port) { return std::fabs(state(port).torque); }
+
+int32_t motor_get_voltage(int8_t port) { return sign(port) * state(port).voltage; }
+} // namespace c
+} // namespace pros
@@ -0,0 +1,39 @@
+#include "sim/config.hpp"
+
+namespace sim {
+RobotConfig robotConfig() {
+    RobotConfig config;
+    // drivetrain, see leftMotors/rightMotors and drivetrain in src/main.cpp
+    config.leftPorts = {-8, 9, -10};
+    config.rightPorts = {-14, 2, 3};
+    config.trackWidth = 13;
+    config.wheelDiameter = 3.25;
+    config.wheelRpm = 600;
+    config.cartridgeRpm = 600;
+    config.driveTimeConstant = 0.12;
+    config.length = 18;
+    config.width = 18;
+    config.imuPort = 16;
+    // tracking wheels, see verticalEnc/horizontalEnc in src/main.cpp
+    config.trackingWheels = {
+        {-17, 2, 1, true},
+        {-1, 2, -1.75, false},
+    };
+    // distance sensors, see Back/Right/Left in src/main.cpp.
+    // The mounting positions are estimates and should be measured on the robot
+    config.distanceSensors = {
+        {14, 0, -7.5, 180},
+        {15, 7.5, 0, 90},
+        {16, -7.5, 0, -90},
+    };
+    return config;
+}
+
+StartPose defaultStartPose(int auton) {
+    switch (auton) {
+        case 0: return {-24, -61, 0}; // left side
+        case 1: return {24, -61, 0}; // right side
+        default: return {-48, -61, 0}; // skills
+    }
+}
+} // namespace sim
@@ -0,0 +1,277 @@
+#include "pros/rtos.hpp"
+#include "sim/scheduler.hpp"
+#include <system_error>
+
+/**
+ * Host implementation of the PROS RTOS API on top of the simulator's cooperative scheduler.
+ * Task handles are sim::Task pointers, and mutexes are plain structs since only one task runs at a time.
+ */
+
+namespace {
+using pros::mutex_t;
+using pros::task_t;
+
+struct SimMutex {
+        sim::Task* owner = nullptr;
+        bool locked = false;
+        bool recursive = false;
+        std::uint32_t depth = 0;
+};
+
+sim::Task* toTask(task_t task) {
+    return task == nullptr ? sim::Scheduler::get().current() : static_cast<sim::Task*>(task);
+}
+
+bool takeMutex(mutex_t handle, std::uint32_t timeout) {
+    SimMutex* mutex = static_cast<SimMutex*>(handle);
+    sim::Scheduler& scheduler = sim::Scheduler::get();
+    sim::Task* self = scheduler.current();
+    const std::uint64_t start = scheduler.micros();
+    while (true) {
+        if (!mutex->locked) {
+            mutex->locked = true;
+            mutex->owner = self;
+            mutex->depth = 1;
+            return true;
+        }
+        if (mutex->recursive && mutex->owner == self) {
+            mutex->depth++;
+            return true;
+        }
+        const std::uint64_t waited = (scheduler.micros() - start) / 1000;
+        if (self == nullptr || (timeout != TIMEOUT_MAX && waited >= timeout)) return false;
+        scheduler.sleep(1);
+    }
+}
+
+bool giveMutex(mutex_t handle) {
+    SimMutex* mutex = static_cast<SimMutex*>(handle);
+    if (!mutex->locked) return false;
+    if (--mutex->depth == 0) {
+        mutex->locked = false;
+        mutex->owner = nullptr;
+    }
+    return true;
+}
+} // namespace
+
+namespace pros {
+namespace c {
+uint32_t millis(void) { return sim::Scheduler::get().micros() / 1000; }
+
+uint64_t micros(void) { return sim::Scheduler::get().micros(); }
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t, const char* const name) {
+    return sim::Scheduler::get().create(function, parameters, prio, name);
+}
+
+void task_delete(task_t task) { sim::Scheduler::get().remove(toTask(task)); }
+
+void task_delay(const uint32_t milliseconds) { sim::Scheduler::get().sleep(milliseconds); }
+
+void delay(const uint32_t milliseconds) { sim::Scheduler::get().sleep(milliseconds); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+    const uint32_t target = *prev_time + delta;
+    const uint32_t now = millis();
+    if (int32_t(target - now) > 0) delay(target - now);
+    *prev_time = target;
+}
+
+uint32_t task_get_priority(task_t task) { return toTask(task)->priority; }
+
+void task_set_priority(task_t task, uint32_t prio) { toTask(task)->priority = prio; }
+
+task_state_e_t task_get_state(task_t task) {
+    sim::Task* t = toTask(task);
+    if (t == nullptr) return E_TASK_STATE_INVALID;
+    if (t == sim::Scheduler::get().current()) return E_TASK_STATE_RUNNING;
+    switch (t->state) {
+        case sim::Task::State::READY: return E_TASK_STATE_READY;
+        case sim::Task::State::SLEEPING:
+        case sim::Task::State::WAITING: return E_TASK_STATE_BLOCKED;
+        case sim::Task::State::SUSPENDED: return E_TASK_STATE_SUSPENDED;
+        default: return E_TASK_STATE_DELETED;
+    }
+}
+
+void task_suspend(task_t task) { sim::Scheduler::get().suspend(toTask(task)); }
+
+void task_resume(task_t task) { sim::Scheduler::get().wake(toTask(task)); }
+
+uint32_t task_get_count(void) { return sim::Scheduler::get().count(); }
+
+char* task_get_name(task_t task) {
+    sim::Task* t = toTask(task);
+    return t == nullptr ? nullptr : t->name.data();
+}
+
+task_t task_get_by_name(const char* name) { return sim::Scheduler::get().find(name); }
+
+task_t task_get_current() { return sim::Scheduler::get().current(); }
+
+uint32_t task_notify(task_t task) { return task_notify_ext(task, 1, E_NOTIFY_ACTION_INCR, nullptr); }
+
+void task_join(task_t task) {
+    while (task_get_state(task) != E_TASK_STATE_DELETED) delay(1);
+}
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value) {
+    sim::Task* t = toTask(task);
+    if (prev_value != nullptr) *prev_value = t->notifyValue;
+    switch (action) {
+        case E_NOTIFY_ACTION_BITS: t->notifyValue |= value; break;
+        case E_NOTIFY_ACTION_INCR: t->notifyValue++; break;
+        case E_NOTIFY_ACTION_OWRITE: t->notifyValue = value; break;
+        case E_NOTIFY_ACTION_NO_OWRITE:
+            if (t->notifyValue != 0) return 0;
+            t->notifyValue = value;
+            break;
+        default: break;
+    }
+    if (t->state == sim::Task::State::WAITING) sim::Scheduler::get().wake(t);
+    return 1;
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+    sim::Task* self = sim::Scheduler::get().current();
+    if (self == nullptr) return 0;
+    sim::Scheduler::get().wait(timeout);
+    const uint32_t value = self->notifyValue;
+    if (value != 0) self->notifyValue = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+bool task_notify_clear(task_t task) {
+    sim::Task* t = toTask(task);
+    const bool pending = t->notifyValue != 0;
+    t->notifyValue = 0;
+    return pending;
+}
+
+mutex_t mutex_create(void) { return new SimMutex(); }
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) { return takeMutex(mutex, timeout); }
+
+bool mutex_give(mutex_t mutex) { return giveMutex(mutex); }
+
+mutex_t mutex_recursive_create(void) {
+    SimMutex* mutex = new SimMutex();
+    mutex->recursive = true;
+    return mutex;
+}
+
+bool mutex_recursive_take(mutex_t mutex, uint32_t timeout) { return takeMutex(mutex, timeout); }
+
+bool mutex_recursive_give(mutex_t mutex) { return giveMutex(mutex); }
+
+void mutex_delete(mutex_t mutex) { delete static_cast<SimMutex*>(mutex); }
+} // namespace c
+
+inline namespace rtos {
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name)
+    : task(c::task_create(function, parameters, prio, stack_depth, name)) {}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task) : task(task) {}
+
+Task Task::current() { return Task(c::task_get_current()); }
+
+Task& Task::operator=(task_t in) {
+    task = in;
+    return *this;
+}
+
+void Task::remove() { c::task_delete(task); }
+
+std::uint32_t Task::get_priority() { return c::task_get_priority(task); }
+
+void Task::set_priority(std::uint32_t prio) { c::task_set_priority(task, prio); }
+
+std::uint32_t Task::get_state() { return c::task_get_state(task); }
+
+void Task::suspend() { c::task_suspend(task); }
+
+void Task::resume() { c::task_resume(task); }
+
+const char* Task::get_name() { return c::task_get_name(task); }
+
+std::uint32_t Task::notify() { return c::task_notify(task); }
+
+void Task::join() { c::task_join(task); }
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+    return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+    return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear() { return c::task_notify_clear(task); }
+
+void Task::delay(const std::uint32_t milliseconds) { c::task_delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+    c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() { return c::task_get_count(); }
+
+Clock::time_point Clock::now() { return time_point {duration {c::millis()}}; }
+
+mutex_t Mutex::lazy_init() {
+    mutex_t current = mutex.load(std::memory_order_relaxed);
+    if (current == nullptr) {
+        mutex_t created = c::mutex_create();
+        if (mutex.compare_exchange_strong(current, created)) return created;
+        c::mutex_delete(created);
+    }
+    return current;
+}
+
+bool Mutex::take() { return take(TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) { return c::mutex_take(lazy_init(), timeout); }
+
+bool Mutex::give() { return c::mutex_give(lazy_init()); }
+
+void Mutex::lock() {
+    if (!take(TIMEOUT_MAX)) throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur));
+}
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+
+Mutex::~Mutex() { c::mutex_delete(mutex.load()); }
+
+mutex_t RecursiveMutex::lazy_init() {
+    mutex_t current = mutex.load(std::memory_order_relaxed);
+    if (current == nullptr) {
+        mutex_t created = c::mutex_recursive_create();
+        if (mutex.compare_exchange_strong(current, created)) return created;
+        c::mutex_delete(created);
+    }
+    return current;
+}
+
+bool RecursiveMutex::take() { return take(TIMEOUT_MAX); }
+
+bool RecursiveMutex::take(std::uint32_t timeout) { return c::mutex_recursive_take(lazy_init(), timeout); }
+
+bool RecursiveMutex::give() { return c::mutex_recursive_give(lazy_init()); }
+
+void RecursiveMutex::lock() {
+    if (!take(TIMEOUT_MAX)) throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur));
+}
+
+void RecursiveMutex::unlock() { give(); }
+
+bool RecursiveMutex::try_lock() { return take(0); }
+
+RecursiveMutex::~RecursiveMutex() { c::mutex_delete(mutex.load()); }
+} // namespace rtos
+} // namespace pros
@@ -0,0 +1,306 @@
+#include "sim/scenarios.hpp"
+#include "sim/config.hpp"
+#include "sim/world.hpp"
+#include "lemlib/util.hpp"
+#include "pros/rtos.hpp"
+#include "pushback/chassis.hpp"
+#include "pushback/ekf.hpp"
+#include "pushback/particleFilter.hpp"
+#include "pushback/path.hpp"
+#include "pushback/routine.hpp"
+#include "pushback/slipDetector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <vector>
+
+// defined in src/main.cpp
+extern pushback::Chassis chassis;
+extern pushback::SlipDetector slip;
+extern pros::Distance Back;
+extern pros::Distance Right;
+extern pros::Distance Left;
+
+namespace {
+/**
+ * Profiled moves and turns, one after the other. Each one reports how long it took against its timeout, so a
+ * motion that only ends on its timeout shows up straight away.
+ */
+bool profiled() {
+    constexpr int TIMEOUT = 5000;
+    chassis.setPose(0, 0, 0);
+    auto move = [](float x, float y, bool forwards) {
+        const std::uint32_t start = pros::millis();
+        chassis.moveToPointProfiled(x, y, TIMEOUT, {.forwards = forwards}, false);
+        const lemlib::Pose pose = chassis.getPose();
+        std::fprintf(stderr, "moveToPointProfiled(%.0f, %.0f): %u of %d ms, %.2f in from the target\n", x, y,
+                     pros::millis() - start, TIMEOUT, std::hypot(pose.x - x, pose.y - y));
+    };
+    auto turn = [](float theta) {
+        const std::uint32_t start = pros::millis();
+        chassis.turnToHeadingProfiled(theta, TIMEOUT, {}, false);
+        std::fprintf(stderr, "turnToHeadingProfiled(%.0f): %u of %d ms, %.2f deg from the target\n", theta,
+                     pros::millis() - start, TIMEOUT,
+                     std::fabs(lemlib::angleError(theta, chassis.getPose().theta, false)));
+    };
+    move(0, 48, true);
+    turn(90);
+    move(24, 48, true);
+    turn(-90);
+    move(48, 48, false);
+    move(0, 48, true);
+    return true;
+}
+
+/**
+ * Puts the robot at rest at a field pose, as if it was carried there. The IMU keeps its reading, so odometry only
+ * sees the pose being set. A seed other than 0 turns on sensor noise
+ */
+void place(float x, float y, float theta, std::uint32_t seed = 0) {
+    sim::World& world = sim::World::get();
+    // let the robot come to rest first
+    pros::delay(500);
+    const std::uint8_t imu = world.config().imuPort;
+    const double rotation = world.imuRotation(imu);
+    world.configure(sim::robotConfig(), {x, y, theta}, seed);
+    world.imu(imu).rotationOffset += rotation - world.imuRotation(imu);
+}
+
+/**
+ * Backs into the perimeter from across the tile, stopping the motion as soon as the impact is reported, then keeps
+ * pushing with the drive wheels spinning and drives away. Odometry only has the IMU besides the drive motors, so how
+ * far it ends up from the ground truth is what the slip detector leaves.
+ */
+bool wall() {
+    constexpr float RUN_UP = 36;
+    constexpr int PUSH_POWER = -60;
+    constexpr int PUSH_TIME = 2000;
+    // most the odometry may be off after the push and after driving away, in inches
+    constexpr double MAX_ERROR = 2;
+    const sim::World& world = sim::World::get();
+    const double limit = sim::FIELD_HALF_WIDTH - std::max(world.config().length, world.config().width) / 2;
+    place(0, -limit + RUN_UP, 0);
+    chassis.setPose(0, 0, 0);
+    bool passed = true;
+    auto report = [&](const char* phase) {
+        double x, y, theta;
+        world.relativePose(x, y, theta);
+        const lemlib::Pose pose = chassis.getPose();
+        const double error = std::hypot(pose.x - x, pose.y - y);
+        std::fprintf(stderr, "%s: odometry %.2f in from the robot, %u perimeter hits, %u impacts\n", phase, error,
+                     world.robot().collisions, unsigned(slip.getImpacts()));
+        if (error > MAX_ERROR) {
+            std::fprintf(stderr, "FAIL: odometry is more than %.0f in off\n", MAX_ERROR);
+            passed = false;
+        }
+    };
+
+    // the motion aims past the perimeter, so only the impact ends it before its timeout
+    const std::uint32_t start = pros::millis();
+    pushback::runRoutine([]() -> pushback::Routine {
+        co_await pushback::any(chassis.moveToPoint(0, -RUN_UP - 12, 3000, {.forwards = false, .maxSpeed = 80}),
+                               pushback::waitUntil([] { return slip.isActive(pushback::SlipEvent::Type::IMPACT); }));
+    }());
+    std::fprintf(stderr, "backed into the perimeter in %u ms\n", pros::millis() - start);
+
+    std::uint32_t spinning = 0;
+    chassis.tank(PUSH_POWER, PUSH_POWER, true);
+    for (int time = 0; time < PUSH_TIME; time += 10) {
+        if (slip.isActive(pushback::SlipEvent::Type::WHEEL_SPIN)) spinning += 10;
+        pros::delay(10);
+    }
+    chassis.tank(0, 0, true);
+    pros::delay(500);
+    report("pushed");
+    std::fprintf(stderr, "wheel spin reported for %u of %d ms\n", spinning, PUSH_TIME);
+    chassis.moveToPoint(0, 0, 3000, {}, false);
+    report("driven away");
+
+    pushback::SlipEvent event;
+    while (slip.poll(event)) {
+        const char* type = event.type == pushback::SlipEvent::Type::IMPACT ? "impact" : "wheel spin";
+        std::fprintf(stderr, "%s %s at %u ms\n", type, event.started ? "started" : "ended", event.time - start);
+    }
+    if (slip.getImpacts() != world.robot().collisions) {
+        std::fprintf(stderr, "FAIL: %u impacts reported for %u perimeter hits\n", unsigned(slip.getImpacts()),
+                     world.robot().collisions);
+        passed = false;
+    }
+    if (spinning < PUSH_TIME / 2) {
+        std::fprintf(stderr, "FAIL: wheel spin reported for less than half of the push\n");
+        passed = false;
+    }
+    return passed;
+}
+
+ASSET(First_Long_Turn_path);
+ASSET(Goal_To_Goal_Turn_path);
+ASSET(Second_Long_Turn_path);
+
+/**
+ * Distance from a point to the polyline through the path points, in inches
+ */
+double distanceToPath(const pushback::Path& path, double x, double y) {
+    double closest = INFINITY;
+    for (std::size_t i = 1; i < path.size(); i++) {
+        const pushback::PathPoint& a = path[i - 1];
+        const pushback::PathPoint& b = path[i];
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        const double lengthSquared = dx * dx + dy * dy;
+        const double t =
+            lengthSquared > 0 ? std::clamp(((x - a.x) * dx + (y - a.y) * dy) / lengthSquared, 0.0, 1.0) : 0;
+        closest = std::min(closest, std::hypot(x - (a.x + t * dx), y - (a.y + t * dy)));
+    }
+    return closest;
+}
+
+/**
+ * Pure pursuit and RAMSETE on each compiled path. The robot is put back on the start of the path before every run,
+ * and the ground truth pose is compared to the path, so odometry drift does not hide how far the robot strays.
+ */
+bool followers() {
+    constexpr int TIMEOUT = 8000;
+    constexpr float LOOKAHEAD = 10;
+    sim::World& world = sim::World::get();
+    struct Result {
+            std::uint32_t time;
+            double worst;
+    };
+    auto run = [&](const char* name, const asset& file, bool trajectory) {
+        const pushback::Path path(file);
+        const pushback::PathPoint& first = path[0];
+        const pushback::PathPoint& last = path[path.size() - 1];
+        const float theta = lemlib::radToDeg(std::atan2(path[1].x - first.x, path[1].y - first.y));
+        place(first.x, first.y, theta);
+        chassis.setPose(first.x, first.y, theta);
+
+        const std::uint32_t start = pros::millis();
+        if (trajectory) chassis.followTrajectory(file, TIMEOUT);
+        else chassis.followPath(file, LOOKAHEAD, TIMEOUT);
+        double worst = 0;
+        while (chassis.isInMotion()) {
+            worst = std::max(worst, distanceToPath(path, world.robot().x, world.robot().y));
+            pros::delay(10);
+        }
+        std::fprintf(stderr, "%-17s %-16s %5u ms, %.2f in max off the path, %.2f in from the end\n", name,
+                     trajectory ? "followTrajectory" : "followPath", pros::millis() - start, worst,
+                     std::hypot(world.robot().x - last.x, world.robot().y - last.y));
+        return Result {pros::millis() - start, worst};
+    };
+    const std::pair<const char*, const asset&> paths[] = {{"First_Long_Turn", First_Long_Turn_path},
+                                                          {"Goal_To_Goal_Turn", Goal_To_Goal_Turn_path},
+                                                          {"Second_Long_Turn", Second_Long_Turn_path}};
+    Result pursuit[std::size(paths)];
+    for (std::size_t i = 0; i < std::size(paths); i++) pursuit[i] = run(paths[i].first, paths[i].second, false);
+    // followTrajectory is documented as the faster and more accurate of the two
+    bool passed = true;
+    for (std::size_t i = 0; i < std::size(paths); i++) {
+        const Result ramsete = run(paths[i].first, paths[i].second, true);
+        if (ramsete.time > pursuit[i].time || ramsete.worst > pursuit[i].worst) {
+            std::fprintf(stderr, "FAIL: followTrajectory is slower or further off %s than followPath\n",
+                         paths[i].first);
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+/**
+ * Starts a filter with the odometry origin it is given off in x and y, then drives a 24 inch square. The distance
+ * sensors are noisy. Reports how far the filter's estimate and the corrected odometry are from the robot, before and
+ * after.
+ *
+ * @param originError how far off the origin is in x and in y, in inches
+ * @param start starts the filter, given the wrong origin
+ * @param estimate field pose of the filter, theta in radians
+ * @param maxError most the estimate and odometry may be off at the end, in inches
+ */
+bool localize(const char* name, float originError, const std::function<void(const lemlib::Pose& origin)>& start,
+              const std::function<lemlib::Pose()>& estimate, double maxError) {
+    constexpr float START_X = -24;
+    constexpr float START_Y = -24;
+    const sim::World& world = sim::World::get();
+    place(START_X, START_Y, 0, 1);
+    chassis.setPose(0, 0, 0);
+    const lemlib::Pose origin(START_X + originError, START_Y - originError, 0);
+    start(origin);
+    bool passed = true;
+    auto report = [&](const char* phase, bool check) {
+        const sim::RobotState& robot = world.robot();
+        const lemlib::Pose field = estimate();
+        const lemlib::Pose odom = pushback::toField(origin, chassis.getPose(true));
+        const double estimateError = std::hypot(field.x - robot.x, field.y - robot.y);
+        const double odomError = std::hypot(odom.x - robot.x, odom.y - robot.y);
+        std::fprintf(stderr, "%s %s: estimate %.2f in from the robot, odometry %.2f in\n", name, phase, estimateError,
+                     odomError);
+        if (check && std::max(estimateError, odomError) > maxError) {
+            std::fprintf(stderr, "FAIL: %s is more than %.1f in off\n", name, maxError);
+            passed = false;
+        }
+    };
+    pros::delay(100);
+    report("at the start", false);
+    for (const auto& [x, y] : {std::pair {0, 24}, {24, 24}, {24, 0}, {0, 0}}) {
+        chassis.turnToPoint(x, y, 1500, {}, false);
+        chassis.moveToPoint(x, y, 3000, {}, false);
+    }
+    pros::delay(500);
+    report("after the square", true);
+    return passed;
+}
+
+/**
+ * The EKF on the three distance sensors of the robot. It trusts the starting pose to about an inch, so the origin
+ * is only off by as much as a careless placement
+ */
+bool ekf() {
+    static std::optional<pushback::Ekf> filter;
+    return localize(
+        "Ekf", 1.5,
+        [](const lemlib::Pose& origin) {
+            filter.emplace(pushback::EkfSettings {.origin = origin}, std::vector<pushback::DistanceMount> {
+                {&Back, 0, -7.5, 180}, {&Right, 7.5, 0, 90}, {&Left, -7.5, 0, -90}});
+            filter->start();
+        },
+        [] { return filter->getFieldPose(true); }, 1.5);
+}
+
+/**
+ * The particle filter on the same sensors. The origin is off by more than the EKF can take, so the particles are
+ * scattered over the area it could be in, as after a collision
+ */
+bool particles() {
+    static std::optional<pushback::ParticleFilter> filter;
+    return localize(
+        "ParticleFilter", 4,
+        [](const lemlib::Pose& origin) {
+            filter.emplace(pushback::ParticleFilterSettings {.origin = origin, .particles = pushback::HOST_PARTICLES},
+                           std::vector<pushback::DistanceMount> {
+                               {&Back, 0, -7.5, 180}, {&Right, 7.5, 0, 90}, {&Left, -7.5, 0, -90}});
+            filter->start();
+            filter->scatter(8, 3);
+        },
+        [] { return filter->getFieldPose(true); }, 1.5);
+}
+
+const std::map<std::string, std::function<bool()>> scenarios {
+    {"profiled", profiled},
+    {"wall", wall},
+    {"followers", followers},
+    {"ekf", ekf},
+    {"particles", particles},
+};
+} // namespace
+
+namespace sim {
+std::optional<bool> runScenario(const std::string& name) {
+    const auto scenario = scenarios.find(name);
+    if (scenario == scenarios.end()) return std::nullopt;
+    return scenario->second();
+}
+} // namespace sim
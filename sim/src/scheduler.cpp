@@ -0,0 +1,185 @@
+#include "sim/scheduler.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace sim {
+// the simulated task running on this host thread
+static thread_local Task* self = nullptr;
+
+constexpr std::uint64_t FOREVER = std::numeric_limits<std::uint64_t>::max();
+
+Scheduler& Scheduler::get() {
+    static Scheduler scheduler;
+    return scheduler;
+}
+
+void Scheduler::onStep(std::function<void(double)> step) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->step = std::move(step);
+}
+
+Task* Scheduler::create(pros::task_fn_t function, void* parameters, std::uint32_t prio, const char* name) {
+    std::unique_lock<std::mutex> lock(mutex);
+    tasks.push_back(std::make_unique<Task>(Task {std::uint32_t(tasks.size() + 1), name ? name : "", prio}));
+    Task* task = tasks.back().get();
+    ready.push_back(task);
+    std::thread([this, task, function, parameters] {
+        std::unique_lock<std::mutex> lock(mutex);
+        self = task;
+        waitForTurn(lock, task);
+        lock.unlock();
+        function(parameters);
+        lock.lock();
+        finish(lock, task);
+    }).detach();
+    return task;
+}
+
+bool Scheduler::run(std::uint64_t timeLimit) {
+    std::unique_lock<std::mutex> lock(mutex);
+    limit = timeLimit * 1000;
+    started = true;
+    running = pickNext();
+    cv.notify_all();
+    cv.wait(lock, [this] { return stopped; });
+    return now < limit;
+}
+
+void Scheduler::stop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    stopped = true;
+    running = nullptr;
+    cv.notify_all();
+    // the calling task never runs again
+    cv.wait(lock, [] { return false; });
+    std::terminate();
+}
+
+std::uint64_t Scheduler::micros() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return now;
+}
+
+Task* Scheduler::current() const { return self; }
+
+void Scheduler::sleep(std::uint32_t ms) {
+    // outside of a task there is nothing to switch to
+    if (self == nullptr) return;
+    std::unique_lock<std::mutex> lock(mutex);
+    if (ms == 0) {
+        ready.push_back(self);
+    } else {
+        self->state = Task::State::SLEEPING;
+        self->wakeTime = now + std::uint64_t(ms) * 1000;
+    }
+    switchAway(lock, self);
+}
+
+void Scheduler::wait(std::uint32_t timeout) {
+    if (self == nullptr) return;
+    std::unique_lock<std::mutex> lock(mutex);
+    if (self->notifyValue != 0 || timeout == 0) return;
+    self->state = Task::State::WAITING;
+    self->wakeTime = timeout == TIMEOUT_MAX ? FOREVER : now + std::uint64_t(timeout) * 1000;
+    switchAway(lock, self);
+}
+
+void Scheduler::wake(Task* task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (task->state == Task::State::WAITING || task->state == Task::State::SUSPENDED) {
+        task->state = Task::State::READY;
+        ready.push_back(task);
+    }
+}
+
+void Scheduler::suspend(Task* task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (task->state == Task::State::DONE) return;
+    task->state = Task::State::SUSPENDED;
+    ready.erase(std::remove(ready.begin(), ready.end(), task), ready.end());
+    if (task == self) switchAway(lock, self);
+}
+
+void Scheduler::remove(Task* task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (task == self) {
+        finish(lock, task);
+        cv.wait(lock, [] { return false; });
+    }
+    task->state = Task::State::DONE;
+    ready.erase(std::remove(ready.begin(), ready.end(), task), ready.end());
+}
+
+std::uint32_t Scheduler::count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::count_if(tasks.begin(), tasks.end(),
+                         [](const std::unique_ptr<Task>& task) { return task->state != Task::State::DONE; });
+}
+
+Task* Scheduler::find(const char* name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::unique_ptr<Task>& task : tasks) {
+        if (task->state != Task::State::DONE && task->name == name) return task.get();
+    }
+    return nullptr;
+}
+
+void Scheduler::switchAway(std::unique_lock<std::mutex>& lock, Task* self) {
+    running = pickNext();
+    cv.notify_all();
+    waitForTurn(lock, self);
+}
+
+void Scheduler::waitForTurn(std::unique_lock<std::mutex>& lock, Task* self) {
+    cv.wait(lock, [this, self] { return started && running == self; });
+    self->state = Task::State::READY;
+}
+
+void Scheduler::finish(std::unique_lock<std::mutex>&, Task* self) {
+    self->state = Task::State::DONE;
+    running = pickNext();
+    cv.notify_all();
+}
+
+Task* Scheduler::pickNext() {
+    while (!stopped) {
+        if (!ready.empty()) {
+            Task* next = ready.front();
+            ready.pop_front();
+            return next;
+        }
+        // every task is blocked, so jump to the next wake time
+        std::uint64_t next = FOREVER;
+        for (const std::unique_ptr<Task>& task : tasks) {
+            if (task->state == Task::State::SLEEPING || task->state == Task::State::WAITING) {
+                next = std::min(next, task->wakeTime);
+            }
+        }
+        if (next == FOREVER) break;
+        while (now < next) {
+            if (now >= limit) {
+                stopped = true;
+                return nullptr;
+            }
+            now += 1000;
+            if (step) step(0.001);
+        }
+        // wake tasks in the order their wake times come up, and tasks due at the same time in creation order
+        std::vector<Task*> woken;
+        for (const std::unique_ptr<Task>& task : tasks) {
+            if ((task->state == Task::State::SLEEPING || task->state == Task::State::WAITING) &&
+                task->wakeTime <= now) {
+                task->state = Task::State::READY;
+                woken.push_back(task.get());
+            }
+        }
+        std::stable_sort(woken.begin(), woken.end(), [](Task* a, Task* b) { return a->wakeTime < b->wakeTime; });
+        ready.insert(ready.end(), woken.begin(), woken.end());
+    }
+    // nothing can ever run again
+    stopped = true;
+    return nullptr;
+}
+} // namespace sim
@@ -0,0 +1,236 @@
+#include "pros/distance.hpp"
+#include "pros/error.h"
+#include "pros/imu.hpp"
+#include "pros/rotation.hpp"
+#include "sim/world.hpp"
+#include <cmath>
+#include <cstdlib>
+
+/**
+ * Host implementation of the smart port sensors. Readings come from the ground truth in sim::World.
+ */
+
+namespace {
+// time the IMU takes to calibrate, in milliseconds
+constexpr std::uint32_t IMU_CALIBRATION_TIME = 2000;
+
+sim::ImuState& imuState(std::uint8_t port) { return sim::World::get().imu(port); }
+
+double imuRotation(std::uint8_t port) { return sim::World::get().imuRotation(port); }
+
+sim::RotationState& rotationState(std::uint8_t port) { return sim::World::get().rotation(port); }
+
+double rotationSign(std::uint8_t port) { return rotationState(port).reversed ? -1 : 1; }
+
+sim::DistanceState& distanceState(std::uint8_t port) { return sim::World::get().distance(port); }
+} // namespace
+
+namespace pros {
+inline namespace v5 {
+Device::Device(const std::uint8_t port) : _port(port) {}
+
+std::uint8_t Device::get_port(void) const { return _port; }
+
+bool Device::is_installed() { return get_plugged_type() != DeviceType::none; }
+
+DeviceType Device::get_plugged_type() const { return get_plugged_type(_port); }
+
+DeviceType Device::get_plugged_type(std::uint8_t port) {
+    sim::World& world = sim::World::get();
+    if (port > 21) return DeviceType::undefined;
+    if (world.motor(port).installed) return DeviceType::motor;
+    if (world.imu(port).installed) return DeviceType::imu;
+    if (world.rotation(port).installed) return DeviceType::rotation;
+    if (world.distance(port).installed) return DeviceType::distance;
+    return DeviceType::none;
+}
+
+std::vector<Device> Device::get_all_devices(DeviceType device_type) {
+    std::vector<Device> result;
+    for (std::uint8_t port = 1; port <= 21; port++) {
+        const DeviceType type = get_plugged_type(port);
+        if (type != DeviceType::none && (device_type == DeviceType::undefined || type == device_type)) {
+            result.emplace_back(port);
+        }
+    }
+    return result;
+}
+
+std::int32_t Imu::reset(bool blocking) const {
+    sim::ImuState& imu = imuState(_port);
+    sim::World::get().claim(_port, "imu");
+    imu.installed = true;
+    imu.calibratedAt = c::millis() + IMU_CALIBRATION_TIME;
+    imu.drift = 0;
+    imu.rotationOffset = -imuRotation(_port);
+    imu.headingOffset = 0;
+    if (blocking) c::delay(IMU_CALIBRATION_TIME);
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t) const { return 1; }
+
+std::vector<Imu> Imu::get_all_devices() {
+    std::vector<Imu> result;
+    for (std::uint8_t port = 1; port <= 21; port++) {
+        if (imuState(port).installed) result.emplace_back(port);
+    }
+    return result;
+}
+
+Imu Imu::get_imu() {
+    std::vector<Imu> all = get_all_devices();
+    return all.empty() ? Imu(PROS_ERR_BYTE) : all.front();
+}
+
+double Imu::get_rotation() const {
+    if (is_calibrating()) return PROS_ERR_F;
+    return imuRotation(_port);
+}
+
+double Imu::get_heading() const {
+    if (is_calibrating()) return PROS_ERR_F;
+    double heading = std::fmod(imuRotation(_port) + imuState(_port).headingOffset, 360);
+    return heading < 0 ? heading + 360 : heading;
+}
+
+quaternion_s_t Imu::get_quaternion() const {
+    const double yaw = -get_yaw() * M_PI / 180;
+    return {0, 0, std::sin(yaw / 2), std::cos(yaw / 2)};
+}
+
+euler_s_t Imu::get_euler() const { return {get_pitch(), get_roll(), get_yaw()}; }
+
+double Imu::get_pitch() const { return 0; }
+
+double Imu::get_roll() const { return 0; }
+
+double Imu::get_yaw() const {
+    const double heading = get_heading();
+    return heading > 180 ? heading - 360 : heading;
+}
+
+imu_gyro_s_t Imu::get_gyro_rate() const {
+    return {0, 0, sim::World::get().robot().angularSpeed * 180 / M_PI};
+}
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return 1; }
+
+std::int32_t Imu::tare_yaw() const { return set_heading(0); }
+
+std::int32_t Imu::tare_roll() const { return 1; }
+
+std::int32_t Imu::tare() const {
+    tare_rotation();
+    return tare_heading();
+}
+
+std::int32_t Imu::tare_euler() const { return tare_yaw(); }
+
+std::int32_t Imu::set_heading(const double target) const {
+    sim::ImuState& imu = imuState(_port);
+    imu.headingOffset += target - get_heading();
+    return 1;
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+    sim::ImuState& imu = imuState(_port);
+    imu.rotationOffset += target - imuRotation(_port);
+    return 1;
+}
+
+std::int32_t Imu::set_yaw(const double target) const { return set_heading(target < 0 ? target + 360 : target); }
+
+std::int32_t Imu::set_pitch(const double) const { return 1; }
+
+std::int32_t Imu::set_roll(const double) const { return 1; }
+
+std::int32_t Imu::set_euler(const euler_s_t target) const { return set_yaw(target.yaw); }
+
+imu_accel_s_t Imu::get_accel() const {
+    // robot frame acceleration in g, x to the right and y forwards
+    const sim::RobotState& robot = sim::World::get().robot();
+    constexpr double G = 386.09;
+    return {robot.localAccelX / G, robot.localAccelY / G, 1};
+}
+
+ImuStatus Imu::get_status() const {
+    if (!imuState(_port).installed) return ImuStatus::error;
+    return is_calibrating() ? ImuStatus::calibrating : ImuStatus::ready;
+}
+
+bool Imu::is_calibrating() const { return c::millis() < imuState(_port).calibratedAt; }
+
+imu_orientation_e_t Imu::get_physical_orientation() const { return E_IMU_Z_UP; }
+
+Rotation::Rotation(const std::int8_t port) : Device(std::abs(port), DeviceType::rotation) {
+    sim::World::get().claim(_port, "rotation sensor");
+    rotationState(_port).installed = true;
+    rotationState(_port).reversed = port < 0;
+}
+
+std::int32_t Rotation::reset() { return reset_position(); }
+
+std::int32_t Rotation::set_data_rate(std::uint32_t) const { return 1; }
+
+std::int32_t Rotation::set_position(std::int32_t position) const {
+    rotationState(_port).position = rotationSign(_port) * position;
+    return 1;
+}
+
+std::int32_t Rotation::reset_position(void) const { return set_position(0); }
+
+std::vector<Rotation> Rotation::get_all_devices() {
+    std::vector<Rotation> result;
+    for (std::uint8_t port = 1; port <= 21; port++) {
+        if (rotationState(port).installed) result.emplace_back(port);
+    }
+    return result;
+}
+
+std::int32_t Rotation::get_position() const { return rotationSign(_port) * rotationState(_port).position; }
+
+std::int32_t Rotation::get_velocity() const { return rotationSign(_port) * rotationState(_port).velocity; }
+
+std::int32_t Rotation::get_angle() const {
+    const std::int32_t angle = get_position() % 36000;
+    return angle < 0 ? angle + 36000 : angle;
+}
+
+std::int32_t Rotation::set_reversed(bool value) const {
+    rotationState(_port).reversed = value;
+    return 1;
+}
+
+std::int32_t Rotation::reverse() const { return set_reversed(!rotationState(_port).reversed); }
+
+std::int32_t Rotation::get_reversed() const { return rotationState(_port).reversed; }
+
+Distance::Distance(const std::uint8_t port) : Device(port, DeviceType::distance) {
+    sim::World::get().claim(_port, "distance sensor");
+    distanceState(_port).installed = true;
+}
+
+std::int32_t Distance::get() { return distanceState(_port).distance; }
+
+std::int32_t Distance::get_distance() { return get(); }
+
+std::vector<Distance> Distance::get_all_devices() {
+    std::vector<Distance> result;
+    for (std::uint8_t port = 1; port <= 21; port++) {
+        if (distanceState(port).installed) result.emplace_back(port);
+    }
+    return result;
+}
+
+std::int32_t Distance::get_confidence() { return distanceState(_port).confidence; }
+
+std::int32_t Distance::get_object_size() { return distanceState(_port).confidence > 0 ? 400 : -1; }
+
+double Distance::get_object_velocity() { return 0; }
+} // namespace v5
+} // namespace pros
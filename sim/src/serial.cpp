@@ -0,0 +1,12 @@
+#include "pros/apix.h"
+
+/**
+ * Host implementation of the serial driver API. stdout is already a plain byte stream, so settings are accepted and
+ * ignored.
+ */
+
+namespace pros {
+namespace c {
+int32_t serctl(const uint32_t, void* const) { return 0; }
+} // namespace c
+} // namespace pros
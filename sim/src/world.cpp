@@ -0,0 +1,297 @@
+#include "sim/world.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace sim {
+// stall current of an 11W motor at 12V, before the firmware current limit is applied
+constexpr double STALL_CURRENT = 4000;
+// winding resistance, in ohms
+constexpr double WINDING_RESISTANCE = 3;
+// thermal capacity of a motor, in joules per degree, and its cooling time constant in seconds
+constexpr double THERMAL_CAPACITY = 30;
+constexpr double THERMAL_TIME_CONSTANT = 600;
+constexpr double AMBIENT_TEMPERATURE = 25;
+// internal resistance of the battery, in ohms
+constexpr double BATTERY_RESISTANCE = 0.12;
+// time constant of an unloaded motor, in seconds
+constexpr double FREE_TIME_CONSTANT = 0.03;
+// gyro drift, in degrees per second
+constexpr double IMU_DRIFT = 0.002;
+// time constant of the low pass filter on the IMU acceleration, in seconds. A perimeter stops the robot within one
+// step, and a reading of that step alone would be missed by anything sampling every 10ms
+constexpr double IMU_ACCEL_TIME_CONSTANT = 0.01;
+// range of the distance sensor, in millimeters
+constexpr double DISTANCE_RANGE = 2000;
+// owner of a port that has already been reported as shared by two kinds of device
+static const char* const CONFLICT = "";
+
+double MotorState::freeSpeed() const {
+    switch (gearing) {
+        case pros::MotorGears::red: return 100;
+        case pros::MotorGears::blue: return 600;
+        default: return 200;
+    }
+}
+
+double MotorState::toUnits(double degrees) const {
+    switch (units) {
+        case pros::MotorUnits::rotations: return degrees / 360;
+        case pros::MotorUnits::counts: return degrees * (1800 / freeSpeed()) / 360;
+        default: return degrees;
+    }
+}
+
+double MotorState::fromUnits(double value) const {
+    switch (units) {
+        case pros::MotorUnits::rotations: return value * 360;
+        case pros::MotorUnits::counts: return value * 360 / (1800 / freeSpeed());
+        default: return value;
+    }
+}
+
+World& World::get() {
+    static World world;
+    return world;
+}
+
+void World::configure(const RobotConfig& config, StartPose start, std::uint32_t seed) {
+    cfg = config;
+    this->start = start;
+    state = RobotState();
+    state.x = start.x;
+    state.y = start.y;
+    state.theta = start.theta * M_PI / 180;
+    noisy = seed != 0;
+    rng.seed(seed);
+    for (std::int8_t port : cfg.leftPorts) motor(port).gearing = pros::MotorGears::blue;
+    for (std::int8_t port : cfg.rightPorts) motor(port).gearing = pros::MotorGears::blue;
+    stepSensors(0, 0, 0, 0);
+}
+
+void World::setBattery(double millivolts) { batteryOpenCircuit = millivolts; }
+
+double World::batteryCurrent() const {
+    double total = 0;
+    for (const MotorState& m : motors) total += std::fabs(m.current);
+    return total;
+}
+
+double World::batteryVoltage() const { return batteryOpenCircuit - batteryCurrent() * BATTERY_RESISTANCE; }
+
+MotorState& World::motor(std::int8_t port) { return motors.at(std::abs(port)); }
+
+RotationState& World::rotation(std::int8_t port) { return rotations.at(std::abs(port)); }
+
+ImuState& World::imu(std::uint8_t port) { return imus.at(port); }
+
+DistanceState& World::distance(std::uint8_t port) { return distances.at(port); }
+
+ControllerState& World::controller() { return controllerState; }
+
+std::int32_t& World::adi(std::uint8_t port) {
+    if (port >= 'a' && port <= 'h') port -= 'a' - 1;
+    if (port >= 'A' && port <= 'H') port -= 'A' - 1;
+    return adiPorts.at(port);
+}
+
+void World::claim(std::uint8_t port, const char* type) {
+    // the shims construct temporary devices, so only the first conflict on a port is reported
+    const char*& owner = owners.at(port);
+    if (owner == nullptr) {
+        owner = type;
+    } else if (owner != CONFLICT && std::strcmp(owner, type) != 0) {
+        std::fprintf(stderr, "sim: warning: port %d is used as both a %s and a %s\n", port, owner, type);
+        owner = CONFLICT;
+    }
+}
+
+double World::imuRotation(std::uint8_t port) const {
+    const ImuState& imu = imus.at(port);
+    return (state.theta - start.theta * M_PI / 180) * 180 / M_PI + imu.drift + imu.rotationOffset;
+}
+
+const RobotState& World::robot() const { return state; }
+
+const RobotConfig& World::config() const { return cfg; }
+
+void World::relativePose(double& x, double& y, double& theta) const {
+    // rotate the field displacement into the starting frame, which is what lemlib odometry reports
+    const double startTheta = start.theta * M_PI / 180;
+    const double dx = state.x - start.x;
+    const double dy = state.y - start.y;
+    x = dx * std::cos(startTheta) - dy * std::sin(startTheta);
+    y = dx * std::sin(startTheta) + dy * std::cos(startTheta);
+    theta = (state.theta - startTheta) * 180 / M_PI;
+}
+
+/**
+ * Motors are modelled as brushed DC motors behind a voltage regulator. The applied voltage is the command
+ * clamped to what the battery can supply under load, which is what makes a sagging battery slower at full power.
+ * move() is not regulated, it sets a duty cycle of whatever the battery supplies, so its speed follows the charge.
+ * The firmware current limit caps the torque, and is derated once the motor passes 55C like the real firmware.
+ */
+static double appliedVoltage(const MotorState& m, double battery) {
+    double command = 0;
+    if (m.mode == MotorMode::POWER) {
+        command = m.command / 12000 * battery;
+    } else if (m.mode == MotorMode::VOLTAGE) {
+        command = m.command;
+    } else {
+        // closed loop modes run a velocity controller on the motor
+        double target = m.command;
+        if (m.mode == MotorMode::POSITION) target = std::clamp((m.target - m.position) * 2, -m.command, m.command);
+        command = 12000 * target / m.freeSpeed() + 40 * (target - m.velocity);
+    }
+    if (m.voltageLimit > 0) command = std::clamp(command, -double(m.voltageLimit), double(m.voltageLimit));
+    return std::clamp(command, -battery, battery);
+}
+
+static double effectiveCurrentLimit(const MotorState& m) {
+    double limit = m.currentLimit;
+    if (m.temperature >= 70) return 0;
+    if (m.temperature >= 65) return limit / 8;
+    if (m.temperature >= 60) return limit / 4;
+    if (m.temperature >= 55) return limit / 2;
+    return limit;
+}
+
+/**
+ * @brief Update the electrical state of a motor, and get the resulting acceleration in rpm per second
+ */
+static double motorAcceleration(MotorState& m, double battery, double timeConstant) {
+    const double voltage = appliedVoltage(m, battery);
+    const bool braking = (m.mode == MotorMode::VOLTAGE || m.mode == MotorMode::POWER) && m.command == 0;
+    if (braking && m.brakeMode == pros::MotorBrake::coast) {
+        // open circuit, the motor only slows down due to friction
+        m.voltage = 0;
+        m.current = 0;
+        return -m.velocity / (4 * timeConstant);
+    }
+    const double backEmf = 12000 * m.velocity / m.freeSpeed();
+    double current = (voltage - backEmf) / WINDING_RESISTANCE;
+    const double limit = effectiveCurrentLimit(m);
+    current = std::clamp(current, -limit, limit);
+    m.voltage = voltage;
+    m.current = current;
+    m.torque = 2.1 * current / STALL_CURRENT * (100 / m.freeSpeed());
+    return current / STALL_CURRENT * m.freeSpeed() / timeConstant;
+}
+
+static void heat(MotorState& m, double dt) {
+    const double amps = m.current / 1000;
+    const double power = amps * amps * WINDING_RESISTANCE;
+    m.temperature += dt * (power / THERMAL_CAPACITY - (m.temperature - AMBIENT_TEMPERATURE) / THERMAL_TIME_CONSTANT);
+}
+
+void World::stepMotor(MotorState& m, double dt, double timeConstant) {
+    m.velocity += motorAcceleration(m, batteryVoltage(), timeConstant) * dt;
+    m.position += m.velocity * 6 * dt;
+    heat(m, dt);
+}
+
+void World::step(double dt) {
+    const double battery = batteryVoltage();
+    // mechanisms that are not part of the drivetrain spin freely
+    for (std::size_t port = 1; port < motors.size(); port++) {
+        const auto isDrive = [&](const std::vector<std::int8_t>& ports) {
+            return std::any_of(ports.begin(), ports.end(), [&](std::int8_t p) { return std::size_t(std::abs(p)) == port; });
+        };
+        if (!isDrive(cfg.leftPorts) && !isDrive(cfg.rightPorts)) stepMotor(motors[port], dt, FREE_TIME_CONSTANT);
+    }
+
+    // each side of the drivetrain is mechanically coupled, so the motors share one wheel speed
+    const double rpmToSpeed = cfg.wheelRpm / cfg.cartridgeRpm / 60 * M_PI * cfg.wheelDiameter;
+    const auto stepSide = [&](const std::vector<std::int8_t>& ports, double& speed) {
+        double acceleration = 0;
+        for (std::int8_t port : ports) {
+            MotorState& m = motor(port);
+            const double sign = port < 0 ? -1 : 1;
+            m.velocity = sign * speed / rpmToSpeed;
+            acceleration += sign * motorAcceleration(m, battery, cfg.driveTimeConstant);
+        }
+        speed += acceleration / ports.size() * rpmToSpeed * dt;
+        for (std::int8_t port : ports) {
+            MotorState& m = motor(port);
+            const double sign = port < 0 ? -1 : 1;
+            m.velocity = sign * speed / rpmToSpeed;
+            m.position += m.velocity * 6 * dt;
+            heat(m, dt);
+        }
+    };
+    if (!cfg.leftPorts.empty()) stepSide(cfg.leftPorts, state.leftSpeed);
+    if (!cfg.rightPorts.empty()) stepSide(cfg.rightPorts, state.rightSpeed);
+
+    // integrate the wheel speeds. Wheels keep spinning against the perimeter, which is where drive encoders slip
+    const double prevSpeed = state.speed;
+    const double omega = (state.leftSpeed - state.rightSpeed) / cfg.trackWidth;
+    const double speed = (state.leftSpeed + state.rightSpeed) / 2;
+    const double midTheta = state.theta + omega * dt / 2;
+    double x = state.x + speed * std::sin(midTheta) * dt;
+    double y = state.y + speed * std::cos(midTheta) * dt;
+    const double limit = FIELD_HALF_WIDTH - std::max(cfg.length, cfg.width) / 2;
+    const bool colliding = std::fabs(x) > limit || std::fabs(y) > limit;
+    if (colliding && !state.colliding) state.collisions++;
+    state.colliding = colliding;
+    x = std::clamp(x, -limit, limit);
+    y = std::clamp(y, -limit, limit);
+
+    // actual displacement, in the robot frame
+    const double dx = x - state.x;
+    const double dy = y - state.y;
+    const double dForward = dx * std::sin(midTheta) + dy * std::cos(midTheta);
+    const double dLateral = dx * std::cos(midTheta) - dy * std::sin(midTheta);
+    state.x = x;
+    state.y = y;
+    state.theta += omega * dt;
+    state.angularSpeed = omega;
+    state.speed = dt > 0 ? dForward / dt : 0;
+    const double accelFilter = dt / (IMU_ACCEL_TIME_CONSTANT + dt);
+    state.localAccelY += accelFilter * ((dt > 0 ? (state.speed - prevSpeed) / dt : 0) - state.localAccelY);
+    state.localAccelX += accelFilter * (state.speed * omega - state.localAccelX);
+    stepSensors(dt, omega * dt, dForward, dLateral);
+}
+
+void World::stepSensors(double dt, double dTheta, double dForward, double dLateral) {
+    std::normal_distribution<double> noise(0, 1);
+    for (const TrackingWheelConfig& wheel : cfg.trackingWheels) {
+        RotationState& sensor = rotation(wheel.port);
+        // inverse of the lemlib arc model, so a correctly configured odometry reproduces the true motion
+        const double travel = (wheel.vertical ? dForward : dLateral) - wheel.offset * dTheta;
+        const double sign = wheel.port < 0 ? -1 : 1;
+        const double centidegrees = sign * travel / (M_PI * wheel.diameter) * 36000;
+        sensor.position += centidegrees;
+        sensor.velocity = dt > 0 ? centidegrees / dt : 0;
+    }
+    for (ImuState& imu : imus) {
+        if (imu.installed) imu.drift += IMU_DRIFT * dt + (noisy ? noise(rng) * 0.001 : 0);
+    }
+    for (const DistanceSensorConfig& mount : cfg.distanceSensors) {
+        DistanceState& sensor = distance(mount.port);
+        const double x = state.x + mount.x * std::cos(state.theta) + mount.y * std::sin(state.theta);
+        const double y = state.y - mount.x * std::sin(state.theta) + mount.y * std::cos(state.theta);
+        double mm = castRay(x, y, state.theta + mount.heading * M_PI / 180) * 25.4;
+        if (noisy) mm += noise(rng) * std::max(15.0, mm * 0.05);
+        if (mm > DISTANCE_RANGE) {
+            sensor.distance = 9999;
+            sensor.confidence = 0;
+        } else {
+            sensor.distance = std::max(0, int(mm));
+            sensor.confidence = mm < 200 ? 63 : int(63 - 32 * mm / DISTANCE_RANGE);
+        }
+    }
+}
+
+double World::castRay(double x, double y, double heading) const {
+    const double dx = std::sin(heading);
+    const double dy = std::cos(heading);
+    double t = INFINITY;
+    if (dx > 1e-9) t = std::min(t, (FIELD_HALF_WIDTH - x) / dx);
+    if (dx < -1e-9) t = std::min(t, (-FIELD_HALF_WIDTH - x) / dx);
+    if (dy > 1e-9) t = std::min(t, (FIELD_HALF_WIDTH - y) / dy);
+    if (dy < -1e-9) t = std::min(t, (-FIELD_HALF_WIDTH - y) / dy);
+    return t;
+}
+} // namespace sim
@@ -0,0 +1,118 @@
+#include "pushback/byteRing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * ByteRing with one producer thread and one consumer thread, as a logging task and the task that drains it.
+ *
+ * The producer writes a million numbered messages of 22 to 111 bytes in bursts, the consumer drains whatever is
+ * queued as fast as it can. Every message that comes out must be whole and in order, and the messages delivered
+ * plus the writes the ring reports as dropped must add up to every message written, under both overflow policies.
+ * Small bursts fit in the ring, large ones overflow it.
+ */
+
+namespace {
+constexpr std::uint32_t MESSAGES = 1000000;
+constexpr std::size_t RING_SIZE = 4096;
+
+/**
+ * "sequence|length|" in hex and decimal, then a letter picked by the sequence number, repeated, then a newline
+ */
+std::string message(std::uint32_t sequence) {
+    const std::uint32_t length = sequence % 90 + 10;
+    char head[16];
+    std::snprintf(head, sizeof(head), "%08x|%02u|", sequence, length);
+    return std::string(head) + std::string(length, char('a' + sequence % 26)) + '\n';
+}
+
+/**
+ * Reassembles the drained pieces into messages, and checks each one
+ */
+struct Checker {
+        std::string partial;
+        std::uint32_t delivered = 0;
+        std::uint32_t damaged = 0;
+        std::int64_t last = -1;
+        bool ordered = true;
+
+        void feed(const std::uint8_t* data, std::size_t size) {
+            partial.append(reinterpret_cast<const char*>(data), size);
+            std::size_t start = 0;
+            std::size_t end;
+            while ((end = partial.find('\n', start)) != std::string::npos) {
+                check(std::string_view(partial).substr(start, end - start));
+                start = end + 1;
+            }
+            partial.erase(0, start);
+        }
+
+        void check(std::string_view line) {
+            delivered++;
+            unsigned sequence, length;
+            if (std::sscanf(std::string(line).c_str(), "%8x|%2u|", &sequence, &length) != 2 ||
+                line.size() != 12 + length ||
+                line.substr(12).find_first_not_of(char('a' + sequence % 26)) != std::string_view::npos) {
+                damaged++;
+                return;
+            }
+            if (std::int64_t(sequence) <= last) ordered = false;
+            last = sequence;
+        }
+};
+
+bool stress(pushback::OverflowPolicy policy, std::uint32_t burst, const std::vector<std::string>& messages) {
+    pushback::ByteRing<RING_SIZE> ring(policy);
+    Checker checker;
+    std::atomic<bool> done = false;
+    std::thread consumer([&] {
+        while (!done) {
+            ring.drain([&](const std::uint8_t* data, std::size_t size) { checker.feed(data, size); });
+            std::this_thread::yield();
+        }
+        ring.drain([&](const std::uint8_t* data, std::size_t size) { checker.feed(data, size); });
+    });
+
+    double writeTime = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < MESSAGES; i += burst) {
+        const auto burstStart = std::chrono::steady_clock::now();
+        for (std::uint32_t j = i; j < std::min(MESSAGES, i + burst); j++) {
+            ring.write(messages[j].data(), messages[j].size());
+        }
+        writeTime += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - burstStart).count();
+        std::this_thread::yield();
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    done = true;
+    consumer.join();
+
+    const bool passed = checker.damaged == 0 && checker.ordered && checker.partial.empty() &&
+                        checker.delivered + ring.getDroppedWrites() == MESSAGES;
+    std::printf("%-16s bursts of %3u: %5.1f ns/write, %.2f M messages/s, %7u delivered + %7u dropped, "
+                "%u damaged, %s\n",
+                policy == pushback::OverflowPolicy::DROP_NEWEST ? "drop newest" : "overwrite oldest", burst,
+                writeTime / MESSAGES, checker.delivered / elapsed / 1e6, checker.delivered, ring.getDroppedWrites(),
+                checker.damaged, checker.ordered ? "in order" : "OUT OF ORDER");
+    if (!passed) std::printf("FAIL\n");
+    return passed;
+}
+} // namespace
+
+int main() {
+    std::vector<std::string> messages(MESSAGES);
+    for (std::uint32_t i = 0; i < MESSAGES; i++) messages[i] = message(i);
+    bool passed = true;
+    for (std::uint32_t burst : {32, 256}) {
+        for (pushback::OverflowPolicy policy :
+             {pushback::OverflowPolicy::DROP_NEWEST, pushback::OverflowPolicy::OVERWRITE_OLDEST}) {
+            passed &= stress(policy, burst, messages);
+        }
+    }
+    return passed ? 0 : 1;
+}
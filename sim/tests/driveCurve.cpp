@@ -0,0 +1,65 @@
+#include "pushback/driveCurve.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * LutDriveCurve against the lemlib::ExpoDriveCurve it was baked from.
+ *
+ * Every stick position from -127 to 127 must give the same float, bit for bit, as the curve itself, so swapping the
+ * table in for the curve in src/main.cpp changes nothing the driver can feel. Then the time per call is measured
+ * for the curve and the table through the lemlib::DriveCurve interface, as lemlib::Chassis::tank calls them, and
+ * for the table called directly, as pushback::Chassis::tank does.
+ */
+
+namespace {
+struct CurveSettings {
+        float deadband;
+        float minOutput;
+        float curve;
+};
+
+// the curves in src/main.cpp, LemLib's default curve, and a steeper one
+constexpr CurveSettings CURVES[] = {{3, 10, 1.019}, {0, 0, 1}, {5, 20, 1.05}};
+
+constexpr int CALLS = 20000000;
+
+template <typename F> double nanosPerCall(F f) {
+    volatile float sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < CALLS; i++) sink = sink + f(i % 255 - 127);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALLS;
+}
+} // namespace
+
+int main() {
+    bool passed = true;
+    for (const CurveSettings& settings : CURVES) {
+        lemlib::ExpoDriveCurve expo(settings.deadband, settings.minOutput, settings.curve);
+        const pushback::LutDriveCurve table(expo);
+        int mismatches = 0;
+        for (int input = -127; input <= 127; input++) {
+            const float expected = expo.curve(input);
+            const float actual = table.evaluate(input);
+            if (std::memcmp(&expected, &actual, sizeof(float)) != 0) mismatches++;
+        }
+        std::printf("curve (%g, %g, %g): %d of 255 inputs differ\n", settings.deadband, settings.minOutput,
+                    settings.curve, mismatches);
+        if (mismatches > 0) passed = false;
+    }
+
+    lemlib::ExpoDriveCurve expo(CURVES[0].deadband, CURVES[0].minOutput, CURVES[0].curve);
+    pushback::LutDriveCurve table(expo);
+    lemlib::DriveCurve* virtualExpo = &expo;
+    lemlib::DriveCurve* virtualTable = &table;
+    const double expoTime = nanosPerCall([&](int input) { return virtualExpo->curve(input); });
+    const double virtualTableTime = nanosPerCall([&](int input) { return virtualTable->curve(input); });
+    const double tableTime = nanosPerCall([&](int input) { return table.evaluate(input); });
+    std::printf("ExpoDriveCurve::curve %.2f ns, LutDriveCurve::curve %.2f ns, LutDriveCurve::evaluate %.2f ns\n",
+                expoTime, virtualTableTime, tableTime);
+    if (tableTime > expoTime) {
+        std::printf("FAIL: the table is slower than the curve it replaces\n");
+        passed = false;
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "pushback/deferredLog.hpp"
+#include "lemlib/logger/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+/**
+ * Cost of a log call that is turned off, over an empty loop.
+ *
+ * Compares lemlib's info sink with DeferredLog's member functions and the PUSHBACK_LOG macros, with a cheap argument
+ * and with one that takes work to get, like a motor reading. The macros must not evaluate the arguments of a log
+ * that is off, and must cost less than a member call that does. Build with -DPUSHBACK_MIN_LOG_LEVEL=2 in
+ * SIM_CXXFLAGS to see the cost once INFO is compiled out.
+ */
+
+namespace {
+constexpr int CALLS = 1 << 22;
+constexpr int RUNS = 15;
+
+volatile int sink;
+int readings = 0;
+
+// stands in for an argument that takes work to get. Out of line, so the compiler can't drop it
+[[gnu::noinline]] float reading(int i) {
+    readings++;
+    float sum = 0;
+    for (int k = 0; k < 8; k++) sum += std::sqrt(float(i + k));
+    return sum;
+}
+
+// best time per call of a few runs, in nanoseconds
+template <typename F> double nanosPerCall(F f) {
+    double best = INFINITY;
+    for (int run = 0; run < RUNS; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < CALLS; i++) f(i);
+        best = std::min(best,
+                        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                            CALLS);
+    }
+    return best;
+}
+} // namespace
+
+int main() {
+    pushback::DeferredLog log([](const std::uint8_t*, std::size_t) {});
+    log.setEnabled(false);
+    // lemlib's sinks ignore INFO unless the lowest level is lowered
+    lemlib::infoSink()->setLowestLevel(lemlib::Level::WARN);
+
+    const double empty = nanosPerCall([](int i) { sink = i; });
+    const double lemlibInfo = nanosPerCall([](int i) {
+        sink = i;
+        lemlib::infoSink()->info("x {}", float(i));
+    });
+    const double memberCheap = nanosPerCall([&](int i) {
+        sink = i;
+        log.info("x {}", float(i));
+    });
+    readings = 0;
+    const double memberCostly = nanosPerCall([&](int i) {
+        sink = i;
+        log.info("x {}", reading(i));
+    });
+    const int memberReadings = readings;
+    readings = 0;
+    const double macroCostly = nanosPerCall([&](int i) {
+        sink = i;
+        PUSHBACK_LOG_INFO(log, "x {}", reading(i));
+    });
+    const int macroReadings = readings;
+
+    std::printf("PUSHBACK_MIN_LOG_LEVEL %d, empty loop %.2f ns. Extra per INFO call that is off:\n",
+                PUSHBACK_MIN_LOG_LEVEL, empty);
+    std::printf("  lemlib::infoSink()->info           %6.2f ns\n", lemlibInfo - empty);
+    std::printf("  DeferredLog::info, cheap argument  %6.2f ns\n", memberCheap - empty);
+    std::printf("  DeferredLog::info, costly argument %6.2f ns, %d arguments evaluated\n", memberCostly - empty,
+                memberReadings);
+    std::printf("  PUSHBACK_LOG_INFO, costly argument %6.2f ns, %d arguments evaluated\n", macroCostly - empty,
+                macroReadings);
+
+    bool passed = true;
+    if (macroReadings != 0) {
+        std::printf("FAIL: the macro evaluated the arguments of a log that is off\n");
+        passed = false;
+    }
+    if (macroCostly >= memberCostly) {
+        std::printf("FAIL: the macro is no cheaper than the member function\n");
+        passed = false;
+    }
+    // and a log that is on still evaluates them
+    log.setEnabled(true);
+    readings = 0;
+    PUSHBACK_LOG_WARN(log, "x {}", reading(0));
+    if (readings != 1) {
+        std::printf("FAIL: the macro skipped a log that is on\n");
+        passed = false;
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include "pushback/pathCursor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/**
+ * PathCursor against a full scan of the path, from 50 to 50,000 points.
+ *
+ * The robot drives along a serpentine path with a little noise. At every point the cursor is updated and asked for
+ * a lookahead point, which is what followPath does every 10ms. The full scan finds the closest point the way
+ * LemLib's follow() does. The cursor fails the test if it loses track of where the robot is on the path, or if an
+ * update on the longest path costs more than a few times one on the shortest.
+ */
+
+namespace {
+// distance between points, in inches. The same spacing as the paths in static/
+constexpr float SPACING = 0.5;
+// the robot is never further than this from where the cursor says it is along the path, in inches
+constexpr float MAX_DISTANCE_ERROR = 1;
+// an update on the longest path may cost this many times an update on the shortest one
+constexpr double MAX_SLOWDOWN = 4;
+
+/**
+ * A compiled path in memory, laid out the same way as the assets written by tools/compile_path.py
+ */
+struct TestPath {
+        std::vector<std::uint32_t> words;
+        asset data;
+
+        explicit TestPath(std::size_t count)
+            : words((sizeof(pushback::PathHeader) + count * sizeof(pushback::PathPoint)) / 4) {
+            auto* header = reinterpret_cast<pushback::PathHeader*>(words.data());
+            auto* points = reinterpret_cast<pushback::PathPoint*>(header + 1);
+            float distance = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                // a serpentine, so the path keeps coming back close to itself
+                const float s = i * SPACING;
+                const float x = 20 * std::sin(s / 15);
+                const float y = s / 10;
+                if (i > 0) distance += std::hypot(x - points[i - 1].x, y - points[i - 1].y);
+                points[i] = {x, y, 100, distance, 0, 50};
+            }
+            *header = {pushback::PATH_MAGIC, std::uint32_t(count), distance, 0};
+            data = {reinterpret_cast<std::uint8_t*>(words.data()), words.size() * 4};
+        }
+};
+
+volatile float sink;
+} // namespace
+
+int main() {
+    bool passed = true;
+    double firstUpdate = 0;
+    double lastUpdate = 0;
+    std::printf("%8s %14s %14s %16s\n", "points", "cursor us", "full scan us", "max error in");
+    for (std::size_t count : {50, 500, 5000, 50000}) {
+        const TestPath data(count);
+        const pushback::Path path(data.data);
+        pushback::PathCursor cursor(path, 10);
+
+        float maxError = 0;
+        const auto cursorStart = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; i++) {
+            const float x = path[i].x + 0.3f * std::sin(i);
+            const float y = path[i].y + 0.3f * std::cos(i);
+            cursor.update(x, y);
+            sink = cursor.lookahead(x, y, 10).x;
+            maxError = std::max(maxError, std::fabs(cursor.getDistance() - path[i].distance));
+        }
+        const double cursorTime =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - cursorStart).count() / count;
+
+        // the full scan is slow on long paths, so only time a few hundred updates
+        const std::size_t step = std::max<std::size_t>(1, count / 500);
+        std::size_t scans = 0;
+        const auto scanStart = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; i += step, scans++) {
+            float closest = INFINITY;
+            for (const pushback::PathPoint& point : path) {
+                closest = std::min(closest, std::hypot(point.x - path[i].x, point.y - path[i].y));
+            }
+            sink = closest;
+        }
+        const double scanTime =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - scanStart).count() / scans;
+
+        std::printf("%8zu %14.3f %14.3f %16.2f\n", count, cursorTime, scanTime, maxError);
+        if (maxError > MAX_DISTANCE_ERROR) {
+            std::printf("FAIL: the cursor lost track of the robot on the %zu point path\n", count);
+            passed = false;
+        }
+        if (firstUpdate == 0) firstUpdate = cursorTime;
+        lastUpdate = cursorTime;
+    }
+    if (lastUpdate > firstUpdate * MAX_SLOWDOWN) {
+        std::printf("FAIL: an update costs %.1fx more on the longest path\n", lastUpdate / firstUpdate);
+        passed = false;
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+#include "pushback/pidTuner.hpp"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/**
+ * fitFopdt against responses recorded the way Chassis::tuneLateral records them.
+ *
+ * A first order plus dead time axis is integrated finely, the power steps at a sample, and each velocity is the
+ * distance covered until the next sample. The fit has to recover the dead time to the sample, and the gain
+ * and time constant to within a few percent.
+ */
+
+namespace {
+struct Axis {
+        float gain;
+        float timeConstant;
+        float deadTime;
+};
+
+// a drivetrain like the simulated one, one with no delay at all, and one slower to respond
+constexpr Axis AXES[] = {{0.55, 0.18, 0.02}, {0.55, 0.18, 0}, {0.4, 0.3, 0.06}};
+
+// the same as TUNE_PERIOD in src/pushback/motions/tune.cpp, in seconds
+constexpr float PERIOD = 0.01;
+constexpr int REST_SAMPLES = 5;
+constexpr int SAMPLES = 120;
+constexpr float POWER = 60;
+constexpr int STEPS_PER_SAMPLE = 100;
+
+pushback::FopdtModel record(const Axis& axis) {
+    std::vector<float> powers;
+    std::vector<float> velocities;
+    const float step = PERIOD / STEPS_PER_SAMPLE;
+    float velocity = 0;
+    for (int sample = 0; sample < SAMPLES; sample++) {
+        const float output = sample < REST_SAMPLES ? 0 : POWER;
+        powers.push_back(output);
+        float distance = 0;
+        for (int i = 0; i < STEPS_PER_SAMPLE; i++) {
+            const float time = sample * PERIOD + i * step;
+            const float applied = time >= REST_SAMPLES * PERIOD + axis.deadTime - step / 2 ? POWER : 0;
+            velocity += (axis.gain * applied - velocity) * step / axis.timeConstant;
+            distance += velocity * step;
+        }
+        velocities.push_back(distance / PERIOD);
+    }
+    return pushback::fitFopdt(powers, velocities, PERIOD);
+}
+} // namespace
+
+int main() {
+    bool passed = true;
+    for (const Axis& axis : AXES) {
+        const pushback::FopdtModel model = record(axis);
+        std::printf("gain %.3f, time constant %.3f s, dead time %.3f s: fitted %.3f, %.3f s, %.3f s\n", axis.gain,
+                    axis.timeConstant, axis.deadTime, model.gain, model.timeConstant, model.deadTime);
+        if (std::fabs(model.deadTime - axis.deadTime) > PERIOD / 2 ||
+            std::fabs(model.gain / axis.gain - 1) > 0.03 ||
+            std::fabs(model.timeConstant / axis.timeConstant - 1) > 0.1) {
+            std::printf("FAIL: the fit is off\n");
+            passed = false;
+        }
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include "pushback/scheduledPid.hpp"
+#include "lemlib/pid.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/**
+ * ScheduledPID against lemlib::PID.
+ *
+ * A schedule with one row must give the same output as lemlib::PID with those gains, so moving a controller onto a
+ * schedule changes nothing until the table does. The gains must come from the distance left to the target and not
+ * from the error, and be interpolated between rows. Then the time per update is measured for lemlib::PID and for
+ * schedules with and without a speed table, through the ScheduledController interface as the chassis calls them.
+ * An update must cost less than twice as much as lemlib::PID.
+ */
+
+namespace {
+// short runs, so few are interrupted by other processes, and many of them to keep the best
+constexpr int CALLS = 1 << 16;
+constexpr int RUNS = 101;
+// inputs cycled through, a power of two
+constexpr int INPUTS = 4096;
+constexpr float MAX_RATIO = 2;
+// keeps the sums, so the calls are not optimized out
+volatile float sink = 0;
+
+// the gains of lateral_controller in src/main.cpp, as a schedule
+constexpr auto constantGains = pushback::gainTable({{0, 10, 0, 3}});
+// the lateral schedule in src/main.cpp
+constexpr auto lateralGains = pushback::gainTable({{2, 14, 0, 4}, {12, 10, 0, 3}, {48, 6, 0, 3}});
+constexpr auto lateralSpeeds = pushback::gainTable({{20, 1, 1, 1}, {60, 1, 1, 2}});
+
+// time per call of one run, in nanoseconds
+template <typename F> double nanosPerCall(F f) {
+    const auto start = std::chrono::steady_clock::now();
+    float sum = 0;
+    for (int i = 0; i < CALLS; i++) sum += f(i & (INPUTS - 1));
+    sink = sum;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALLS;
+}
+
+/**
+ * Get the kP and kD a schedule uses at a distance, from the first two updates after a reset
+ */
+void gainsAt(pushback::ScheduledController& controller, float remaining, float& kP, float& kD) {
+    controller.reset();
+    // the first update has a derivative of 1, the second one of 0
+    const float first = controller.update(1, remaining);
+    kP = controller.update(1, remaining);
+    kD = first - kP;
+}
+} // namespace
+
+int main() {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-60, 60);
+    std::vector<float> errors(INPUTS), distances(INPUTS), speeds(INPUTS);
+    for (int i = 0; i < INPUTS; i++) {
+        errors[i] = distribution(random);
+        distances[i] = distribution(random);
+        speeds[i] = distribution(random);
+    }
+
+    bool passed = true;
+    lemlib::PID plain(10, 0, 3);
+    pushback::ScheduledPID<constantGains> constant;
+    float worst = 0;
+    for (int i = 0; i < INPUTS; i++) {
+        const float expected = plain.update(errors[i]);
+        const float actual = constant.update(errors[i], distances[i], speeds[i]);
+        worst = std::max(worst, std::fabs(actual - expected) / std::max(std::fabs(expected), 1.0f));
+    }
+    std::printf("one row schedule against lemlib::PID: largest relative difference %g\n", worst);
+    if (worst > 1e-5f) {
+        std::printf("FAIL: a one row schedule does not match lemlib::PID\n");
+        passed = false;
+    }
+
+    // kP and kD expected at distances from the target, interpolated between the rows and held past the ends
+    struct Expected {
+            float remaining;
+            float kP;
+            float kD;
+    };
+    constexpr Expected EXPECTED[] = {{0, 14, 4}, {2, 14, 4}, {7, 12, 3.5}, {-7, 12, 3.5}, {30, 8, 3}, {100, 6, 3}};
+    pushback::ScheduledPID<lateralGains> schedule;
+    for (const Expected& expected : EXPECTED) {
+        float kP, kD;
+        gainsAt(schedule, expected.remaining, kP, kD);
+        std::printf("%5.0f in left: kP %.3f kD %.3f\n", expected.remaining, kP, kD);
+        if (std::fabs(kP - expected.kP) > 1e-4f || std::fabs(kD - expected.kD) > 1e-4f) {
+            std::printf("FAIL: expected kP %.3f kD %.3f\n", expected.kP, expected.kD);
+            passed = false;
+        }
+    }
+
+    pushback::ScheduledPID<lateralGains> distanceOnly;
+    pushback::ScheduledPID<lateralGains, lateralSpeeds> distanceAndSpeed;
+    pushback::ScheduledController& byDistance = distanceOnly;
+    pushback::ScheduledController& bySpeed = distanceAndSpeed;
+    // best of the runs, taking turns in each so a busy machine slows all three alike
+    double pid = INFINITY, distance = INFINITY, speed = INFINITY;
+    for (int run = 0; run < RUNS; run++) {
+        pid = std::min(pid, nanosPerCall([&](int i) { return plain.update(errors[i]); }));
+        distance = std::min(distance, nanosPerCall([&](int i) { return byDistance.update(errors[i], distances[i]); }));
+        speed = std::min(speed,
+                         nanosPerCall([&](int i) { return bySpeed.update(errors[i], distances[i], speeds[i]); }));
+    }
+    std::printf("lemlib::PID %.2f ns, ScheduledPID by distance %.2f ns (%.2fx), by distance and speed %.2f ns "
+                "(%.2fx)\n",
+                pid, distance, distance / pid, speed, speed / pid);
+    if (distance > MAX_RATIO * pid || speed > MAX_RATIO * pid) {
+        std::printf("FAIL: an update costs more than %.0fx lemlib::PID\n", MAX_RATIO);
+        passed = false;
+    }
+    return passed ? 0 : 1;
+}
@@ -3,6 +3,7 @@
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "pros/abstract_motor.hpp"
 #include "pros/adi.hpp"
+#include "pros/apix.h"
 #include "pros/device.hpp"
 #include "pros/distance.hpp"
 #include "pros/misc.h"
@@ -12,22 +13,59 @@
 #include "pros/motors.hpp"
 #include "pros/rotation.hpp"
 #include "pros/rtos.hpp"
+#include "pushback/battery.hpp"
+#include "pushback/chassis.hpp"
+#include "pushback/controllerInput.hpp"
+#include "pushback/deferredLog.hpp"
+#include "pushback/flightRecorder.hpp"
+#include "pushback/motorTelemetry.hpp"
+#include "pushback/outputCache.hpp"
+#include "pushback/poseSnapshot.hpp"
+#include "pushback/routine.hpp"
+#include "pushback/scheduledPid.hpp"
+#include "pushback/serialOutput.hpp"
+#include "pushback/slipDetector.hpp"
+#include "pushback/telemetryStream.hpp"
+#include "pushback/thermal.hpp"
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <limits>
 #include <random>
 
 // controller
 pros::Controller controller(pros::E_CONTROLLER_MASTER);
+pushback::ControllerInput input(controller);
 
 // motors/motor groups/pnuematics
-pros::MotorGroup rightMotors({-14, 2, 3}, pros::MotorGearset::blue); // left motor group
-pros::MotorGroup leftMotors({-8, 9, -10}, pros::MotorGearset::blue); // right motor group
+// filtered battery voltage, so the drivetrain drives the same on any charge
+pushback::BatteryMonitor battery;
+pushback::CompensatedMotorGroup rightMotors({-14, 2, 3}, pros::MotorGearset::blue, battery); // left motor group
+pushback::CompensatedMotorGroup leftMotors({-8, 9, -10}, pros::MotorGearset::blue, battery); // right motor group
 pros::Motor Outtake(-4);
 pros::Motor Intake(7);
 pros::adi::DigitalOut Descorer('A');
 pros::adi::DigitalOut Loader('B');
 pros::adi::DigitalOut Middle_Goal('C');
 
+// driver control commands the mechanisms through these, so only changes reach the devices
+pushback::CachedMotor intake(Intake);
+pushback::CachedMotor outtake(Outtake);
+pushback::CachedDigitalOut descorer(Descorer);
+pushback::CachedDigitalOut loader(Loader);
+pushback::CachedDigitalOut middleGoal(Middle_Goal);
+pushback::OutputBatch outputs({&intake, &outtake, &descorer, &loader, &middleGoal});
+
+// drive motor telemetry, for the brain screen
+pushback::MotorSampler leftSampler(leftMotors);
+pushback::MotorSampler rightSampler(rightMotors);
+pushback::MotorTelemetry leftTelemetry;
+pushback::MotorTelemetry rightTelemetry;
+
+// eases off the drive current before the motors overheat
+pushback::ThermalGovernor driveThermal({&leftMotors, &rightMotors});
+
 // Inertial Sensor on port 10
 pros::Imu imu(16);
 
@@ -71,13 +109,57 @@ lemlib::ControllerSettings angular_controller(1.6, // proportional gain (kP)
 );
 // sensors for odometry
 lemlib::OdomSensors sensors(nullptr, nullptr, nullptr, nullptr, &imu);
+// holds odometry through impacts, and follows the IMU while the drive wheels spin
+pushback::SlipDetector slip(imu, drivetrain);
+
+// the serial port, shared by both binary streams. Their tasks only queue frames, and its own task writes them out
+pushback::SerialOutput serial([](const std::uint8_t* data, std::size_t size) { std::fwrite(data, 1, size, stdout); });
+// telemetry, formatted on the computer by tools/decode_log.py instead of on the brain
+pushback::DeferredLog telemetry([](const std::uint8_t* data, std::size_t size) { serial.write(data, size); });
+// sampled values at 100 Hz, tabulated on the computer by tools/decode_telemetry.py
+pushback::TelemetryStream telemetryStream([](const std::uint8_t* data, std::size_t size) { serial.write(data, size); });
 
 // input curves for driver control
 lemlib::ExpoDriveCurve throttleCurve(3, 10, 1.019);
 lemlib::ExpoDriveCurve steerCurve(3, 10, 1.019);
+// the same curves baked into lookup tables
+pushback::LutDriveCurve throttleTable(throttleCurve);
+pushback::LutDriveCurve steerTable(steerCurve);
+
+// limits for profiled motions
+pushback::ProfileConstraints lateralConstraints {70, // maximum velocity, in inches per second
+                                                 140, // maximum acceleration, in inches per second squared
+                                                 700 // maximum jerk, in inches per second cubed
+};
+pushback::ProfileConstraints angularConstraints {360, // maximum velocity, in degrees per second
+                                                 720, // maximum acceleration, in degrees per second squared
+                                                 3600 // maximum jerk, in degrees per second cubed
+};
+
+// lateral gains for profiled motions by distance left to the target: as lateral_controller in the middle of a
+// move, stiffer to finish the last inches, softer on long traverses where the profile already carries the robot.
+// Only tuned in the simulator, so the match routines stay on lemlib's motions until it is tuned on the robot
+constexpr auto lateralGains = pushback::gainTable({
+    {2, 14, 0, 4}, // kP and kD at 2 inches or less
+    {12, 10, 0, 3},
+    {48, 6, 0, 3}, // at 48 inches or more
+});
+pushback::ScheduledPID<lateralGains> lateralSchedule;
+
+// drivetrain model for profiled motions, in millivolts
+pushback::FeedforwardSettings feedforward {600, // static friction (kS)
+                                           117, // per inch per second (kV)
+                                           20, // per inch per second squared (kA)
+                                           30, // velocity loop proportional gain (kP)
+                                           0 // velocity loop integral gain (kI)
+};
 
 // create the chassis
-lemlib::Chassis chassis(drivetrain, lateral_controller, angular_controller, sensors, &throttleCurve, &steerCurve);
+pushback::Chassis chassis(drivetrain, lateral_controller, angular_controller, sensors, lateralConstraints,
+                          angularConstraints, feedforward, &throttleTable, &steerTable);
+
+// records matches to the microSD card, decoded on the computer by tools/decode_flight.py
+pushback::FlightRecorder recorder(leftMotors, rightMotors, input, chassis);
 
 // single path asset
 ASSET(Lower_Red_txt);
@@ -99,14 +181,56 @@ static bool middleGoalClosed = true;
 
 void initialize() {
     pros::lcd::initialize();
+    battery.start();
     chassis.calibrate();
+    chassis.setGainSchedules(&lateralSchedule, nullptr);
+    pushback::startPosePublisher();
+    input.start();
+    driveThermal.start();
+    slip.start();
+    // the streams carry their own framing, so stdout must not be wrapped in the kernel's COBS packets as well
+    pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+    serial.start();
+    telemetry.start();
+    // channels are read in order, so y and theta come from the snapshot taken for x
+    static lemlib::Pose streamedPose(0, 0, 0);
+    telemetryStream.addChannel("x", 0.01, [] { return (streamedPose = pushback::getPoseSnapshot().pose).x; });
+    telemetryStream.addChannel("y", 0.01, [] { return streamedPose.y; });
+    telemetryStream.addChannel("theta", 0.01, [] { return streamedPose.theta; });
+    telemetryStream.addChannel("left velocity", 1, [] { return leftMotors.get_actual_velocity(); });
+    telemetryStream.addChannel("right velocity", 1, [] { return rightMotors.get_actual_velocity(); });
+    telemetryStream.addChannel("battery", 10, [] { return battery.getVoltage(); });
+    telemetryStream.addChannel("drive current limit", 10, [] { return driveThermal.getState().currentLimit; });
+    telemetryStream.start();
+    recorder.start();
 
     pros::Task screenTask([&]() {
         while (true) {
-            pros::lcd::print(0, "X: %f", chassis.getPose().x);
-            pros::lcd::print(1, "Y: %f", chassis.getPose().y);
-            pros::lcd::print(2, "Theta: %f", chassis.getPose().theta);
-            lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
+            // one snapshot per tick, so the printed x, y and theta are from the same snapshot
+            const lemlib::Pose pose = pushback::getPoseSnapshot().pose;
+            pros::lcd::print(0, "X: %f", pose.x);
+            pros::lcd::print(1, "Y: %f", pose.y);
+            pros::lcd::print(2, "Theta: %f", pose.theta);
+            pros::lcd::print(3, "Mechanism writes: %lu of %lu", outputs.getWrites(), outputs.getRequestedWrites());
+            // hottest drive motor, read without allocating
+            leftSampler.snapshot(leftTelemetry);
+            rightSampler.snapshot(rightTelemetry);
+            double hottest = 0;
+            for (const pushback::MotorTelemetry* side : {&leftTelemetry, &rightTelemetry}) {
+                for (std::size_t i = 0; i < side->count; i++) hottest = std::max(hottest, side->temperature[i]);
+            }
+            pros::lcd::print(4, "Drive temperature: %.0f C", hottest);
+            const pushback::ThermalState thermal = driveThermal.getState();
+            float timeToCutoff = std::numeric_limits<float>::infinity();
+            for (std::size_t i = 0; i < thermal.count; i++) {
+                timeToCutoff = std::min(timeToCutoff, thermal.timeToCutoff[i]);
+            }
+            pros::lcd::print(5, "Drive limit: %.0f mA, cutoff in %.0f s", thermal.currentLimit, timeToCutoff);
+            pros::lcd::print(6, "Impacts: %lu%s", slip.getImpacts(),
+                             slip.isActive(pushback::SlipEvent::Type::WHEEL_SPIN) ? ", wheels spinning" : "");
+            pros::lcd::print(7, "Battery: %.2f V", battery.getVoltage() / 1000);
+            PUSHBACK_LOG_INFO(telemetry, "Chassis pose: {}", pose);
+            PUSHBACK_LOG_INFO(telemetry, "Drive thermal: {} mA, cutoff in {} s", thermal.currentLimit, timeToCutoff);
             pros::delay(50);
         }
     });
@@ -119,6 +243,79 @@ void competition_initialize() {}
 // Global variable to track the selected autonomous mode
 int selected_auton = 2;
 
+pushback::Routine leftSide() {
+    Loader.set_value(false);
+    Middle_Goal.set_value(true);
+    Intake.move_voltage(12000);
+    co_await chassis.moveToPoint(-6, 45, 2500, {.maxSpeed=45});
+    co_await chassis.turnToHeading(-135, 500);
+    co_await chassis.moveToPoint(-31.5, 24, 1500);
+    // drop the loader while turning to face it
+    pushback::Motion faceLoader = chassis.turnToHeading(180, 500);
+    Loader.set_value(true);
+    co_await faceLoader;
+    // load for at least 2.5 seconds, counting the drive in
+    co_await pushback::all(chassis.moveToPoint(-31.5, 4, 1500, {.maxSpeed=50}), pushback::wait(2500));
+    co_await chassis.moveToPoint(-32, 49, 1500, {.forwards=false, .maxSpeed=40});
+    // score for the rest of autonomous
+    Outtake.move_voltage(12000);
+}
+
+pushback::Routine rightSide() {
+    Loader.set_value(false);
+    Middle_Goal.set_value(true);
+    Intake.move_voltage(12000);
+    co_await chassis.moveToPoint(6, 45, 2500, {.maxSpeed=45});
+    co_await chassis.turnToHeading(135, 500);
+    co_await chassis.moveToPoint(31.5, 24, 1500);
+    // drop the loader while turning to face it
+    pushback::Motion faceLoader = chassis.turnToHeading(180, 500);
+    Loader.set_value(true);
+    co_await faceLoader;
+    // load for at least 3 seconds, counting the drive in
+    co_await pushback::all(chassis.moveToPoint(32, 2.65, 1500, {.maxSpeed=60}), pushback::wait(3000));
+    co_await chassis.moveToPoint(32, 48, 1500, {.forwards=false, .maxSpeed=60});
+    // score for the rest of autonomous
+    Outtake.move_voltage(12000);
+}
+
+pushback::Routine skills() {
+    Loader.set_value(false);
+    chassis.setPose(0, 0, 0);
+    co_await chassis.moveToPoint(0, 47, 2000);
+    pushback::Motion faceLoader = chassis.turnToHeading(-90, 500);
+    Intake.move_voltage(12000);
+    Loader.set_value(true);
+    co_await faceLoader;
+    co_await pushback::all(chassis.moveToPoint(-12.5, 48, 2500), pushback::wait(4000));
+    co_await pushback::all(chassis.moveToPoint(0, 48, 1000, {.forwards=false}), pushback::wait(2500)); //Loader 1 Clear
+    Outtake.move_voltage(0);
+
+    co_await chassis.turnToHeading(180, 500);
+    co_await chassis.moveToPoint(0, 24, 1500);
+    co_await chassis.turnToHeading(90, 500);
+    co_await chassis.moveToPoint(84, 24, 3000);
+    co_await chassis.turnToHeading(0, 500);
+    co_await chassis.moveToPoint(84, 45, 3000);
+    co_await chassis.turnToHeading(90, 500);
+    // score while backing into the goal
+    pushback::Motion backIntoGoal = chassis.moveToPoint(60, 45, 3000, {.forwards=false});
+    Intake.move_voltage(12000);
+    Outtake.move_voltage(12000);
+    co_await pushback::wait(3000); //Loader 1 Scored
+    Outtake.move_voltage(0);
+
+    Intake.move_voltage(12000);
+    Loader.set_value(true);
+    co_await backIntoGoal;
+    co_await pushback::all(chassis.moveToPose(100, 47, 90, 3000, {.maxSpeed=60}), pushback::wait(2500));
+    co_await chassis.moveToPoint(60, 47, 3000, {.forwards=false, .maxSpeed=60}); // Loader 2 Clear
+
+    Outtake.move_voltage(12000);
+    co_await pushback::wait(3000);
+    Outtake.move_voltage(0); // Loader 2 Scored
+}
+
 void autonomous() {
     Descorer.set_value(descorerClosed);
     Loader.set_value(loaderClosed);
@@ -126,134 +323,85 @@ void autonomous() {
 
     if (selected_auton == 0) {
         // LEFT SIDE
-        Loader.set_value(false);
-        Middle_Goal.set_value(true);
-        Intake.move_voltage(12000);
-        chassis.moveToPoint(-6, 45, 2500, {.maxSpeed=45});
-        chassis.turnToHeading(-135, 500);
-        chassis.moveToPoint(-31.5, 24, 1500);
-        chassis.turnToHeading(180, 500);
-        Loader.set_value(true);
-        chassis.moveToPoint(-31.5, 4, 1500, {.maxSpeed=50});
-        Intake.move_voltage(12000);
-        pros::delay(2500);
-        chassis.moveToPoint(-32, 49, 1500, {.forwards=false, .maxSpeed=40}, false);
-        Outtake.move_voltage(12000);
-        pros::delay(100000);
-        Outtake.move_voltage(0);
+        pushback::runRoutine(leftSide());
     } else if (selected_auton == 1) {
         // RIGHT SIDE
-        Loader.set_value(false);
-        Middle_Goal.set_value(true);
-        Intake.move_voltage(12000);
-        chassis.moveToPoint(6, 45, 2500, {.maxSpeed=45});
-        chassis.turnToHeading(135, 500);
-        chassis.moveToPoint(31.5, 24, 1500);
-        chassis.turnToHeading(180, 500);
-        Loader.set_value(true);
-        chassis.moveToPoint(32, 2.65, 1500, {.maxSpeed=60}, true);
-        Intake.move_voltage(12000);
-        pros::delay(3000);
-        chassis.moveToPoint(32, 48, 1500, {.forwards=false, .maxSpeed=60}, false);
-        Outtake.move_voltage(12000);
-        pros::delay(100000);
-        Outtake.move_voltage(0);
+        pushback::runRoutine(rightSide());
     } else if (selected_auton == 2) {
         // SKILLS
-        Loader.set_value(false);
-        chassis.setPose(0, 0, 0);
-        chassis.moveToPoint(0, 47, 2000);
-        chassis.turnToHeading(-90, 500);
-        Intake.move_voltage(12000);
-        Loader.set_value(true);
-        chassis.moveToPoint(-12.5, 48, 2500);
-        pros::delay(4000);
-        chassis.moveToPoint(0, 48, 1000, {.forwards=false});
-        pros::delay(2500); //Loader 1 Clear
-        Outtake.move_voltage(0);
-
-        chassis.turnToHeading(180, 500);
-        chassis.moveToPoint(0, 24, 1500);
-        chassis.turnToHeading(90, 500);
-        chassis.moveToPoint(84, 24, 3000);
-        chassis.turnToHeading(0, 500);
-        chassis.moveToPoint(84, 45, 3000);
-        chassis.turnToHeading(90, 500);
-        chassis.moveToPoint(60, 45, 3000, {.forwards=false});
-        Intake.move_voltage(12000);
-        Outtake.move_voltage(12000);
-        pros::delay(3000);  //Loader 1 Scored
-        Outtake.move_voltage(0);
-
-        Intake.move_voltage(12000);
-        Loader.set_value(true);
-        chassis.moveToPose(100, 47, 90,3000, {.maxSpeed=60});
-        pros::delay(2500);
-        chassis.moveToPoint(60, 47, 3000, {.forwards=false, .maxSpeed=60}, false); // Loader 2 Clear
-
-        Outtake.move_voltage(12000);
-        pros::delay(3000);
-        Outtake.move_voltage(0); // Loader 2 Scored
-
-        
+        pushback::runRoutine(skills());
     } else if (selected_auton == 3) {
   
     }
 }
 
 void opcontrol() {
-    Descorer.set_value(descorerClosed);
-    Loader.set_value(loaderClosed);
-    Middle_Goal.set_value(middleGoalClosed);
+    // autonomous wrote to the devices directly
+    outputs.invalidate();
+    descorer.setValue(descorerClosed);
+    loader.setValue(loaderClosed);
+    middleGoal.setValue(middleGoalClosed);
+
+    // presses from before driver control started are not meant for it
+    pushback::ButtonEvent event;
+    while (input.poll(event)) {}
 
     while (true) {
-        if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
+        // every channel from the same sample
+        const pushback::ControllerSnapshot state = input.getSnapshot();
+        if (state.isPressed(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
             chassis.setPose(0, 0, 0);
-            Loader.set_value(true);
+            loader.setValue(true);
+            outputs.flush();
             chassis.moveToPoint(-14, 0, 500);
-            Intake.move_voltage(12000);
+            intake.moveVoltage(12000);
+            outputs.flush();
             pros::delay(1500);
             chassis.moveToPoint(18, 0, 1000);
-            Outtake.move_voltage(12000);
+            outtake.moveVoltage(12000);
+            outputs.flush();
             pros::delay(3000);
         } else {
-            int leftY = controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
-            int rightY = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
-            chassis.tank(leftY, rightY);
-
-            if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_L1)) {
-                Intake.move_voltage(12000);
-            } else if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_L2)) {
-                Intake.move_voltage(-12000);
-                Outtake.move_voltage(-12000);
-            } else if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_R1)) {
-                Intake.move_voltage(12000);
-                Outtake.move_voltage(12000);
-            } else if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_R2)) {
+            int leftY = state.getAnalog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+            int rightY = state.getAnalog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
+            chassis.tank(leftY, rightY, throttleTable);
+
+            if (state.isPressed(pros::E_CONTROLLER_DIGITAL_L1)) {
+                intake.moveVoltage(12000);
+            } else if (state.isPressed(pros::E_CONTROLLER_DIGITAL_L2)) {
+                intake.moveVoltage(-12000);
+                outtake.moveVoltage(-12000);
+            } else if (state.isPressed(pros::E_CONTROLLER_DIGITAL_R1)) {
+                intake.moveVoltage(12000);
+                outtake.moveVoltage(12000);
+            } else if (state.isPressed(pros::E_CONTROLLER_DIGITAL_R2)) {
                 middleGoalClosed = false;
-                Middle_Goal.set_value(middleGoalClosed);
-                Intake.move_voltage(12000);
-                Outtake.move_voltage(12000);
+                middleGoal.setValue(middleGoalClosed);
+                intake.moveVoltage(12000);
+                outtake.moveVoltage(12000);
             } else {
-                Intake.move_voltage(0);
-                Outtake.move(0);
+                intake.moveVoltage(0);
+                outtake.move(0);
                 middleGoalClosed = true;
-                Middle_Goal.set_value(middleGoalClosed);
+                middleGoal.setValue(middleGoalClosed);
             }
 
-            if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_B)) {
-                Descorer.set_value(true);
+            if (state.isPressed(pros::E_CONTROLLER_DIGITAL_B)) {
+                descorer.setValue(true);
             } else {
-                Descorer.set_value(false);
+                descorer.setValue(false);
             }
 
-            if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN)) {
-                loaderClosed = !loaderClosed;
-                Loader.set_value(loaderClosed);
+            // every press since the last tick, even ones shorter than a tick
+            while (input.poll(event)) {
+                if (event.button == pros::E_CONTROLLER_DIGITAL_DOWN && event.pressed) {
+                    loaderClosed = !loaderClosed;
+                    loader.setValue(loaderClosed);
+                }
             }
 
-            
-
+            // one write per changed device, after every command of the tick is known
+            outputs.flush();
             pros::delay(10);
         }
     }
@@ -0,0 +1,46 @@
+#include "pushback/battery.hpp"
+#include "pros/error.h"
+#include "pros/misc.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pushback {
+// time constant of the battery filter, in seconds. Long enough to ride through the sag of an acceleration
+constexpr float BATTERY_TIME_CONSTANT = 2;
+// the motors can not regulate their output all the way up to the battery voltage, in millivolts
+constexpr float REGULATOR_HEADROOM = 200;
+// voltage move_voltage takes at full power, in millivolts
+constexpr float MAX_VOLTAGE = 12000;
+
+BatteryMonitor::BatteryMonitor(std::uint32_t period)
+    : period(period) {}
+
+void BatteryMonitor::start() {
+    task.start(period, [this](std::uint32_t) { update(period / 1000.0f); });
+}
+
+float BatteryMonitor::getVoltage() const { return voltage; }
+
+void BatteryMonitor::update(float dt) {
+    const std::int32_t measured = pros::battery::get_voltage();
+    if (measured == PROS_ERR || measured <= 0) return;
+    const float filtered = voltage;
+    // start from the first reading, so the filter does not ramp up from 0
+    if (filtered == 0) voltage = measured;
+    else voltage = filtered + std::min(dt / BATTERY_TIME_CONSTANT, 1.0f) * (measured - filtered);
+}
+
+CompensatedMotorGroup::CompensatedMotorGroup(std::initializer_list<std::int8_t> ports, pros::v5::MotorGears gearset,
+                                             const BatteryMonitor& battery, float nominal)
+    : pros::MotorGroup(ports, gearset),
+      battery(battery),
+      nominal(std::min(nominal, MAX_VOLTAGE)) {}
+
+std::int32_t CompensatedMotorGroup::move(std::int32_t power) const {
+    float output = std::clamp<std::int32_t>(power, -127, 127) / 127.0f * nominal;
+    // scale every command by the same factor once the battery can not keep up, keeping the ratio between sides
+    const float available = battery.getVoltage() - REGULATOR_HEADROOM;
+    if (available > 0 && available < nominal) output *= available / nominal;
+    return move_voltage(std::lround(output));
+}
+} // namespace pushback
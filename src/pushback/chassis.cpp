@@ -0,0 +1,107 @@
+#include "pushback/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "pros/rtos.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pushback {
+// largest voltage the motors accept, in millivolts
+constexpr float MAX_VOLTAGE = 12000;
+
+Chassis::Chassis(lemlib::Drivetrain drivetrain, lemlib::ControllerSettings lateralSettings,
+                 lemlib::ControllerSettings angularSettings, lemlib::OdomSensors sensors,
+                 ProfileConstraints lateralConstraints, ProfileConstraints angularConstraints,
+                 FeedforwardSettings feedforward, lemlib::DriveCurve* throttleCurve, lemlib::DriveCurve* steerCurve)
+    : lemlib::Chassis(drivetrain, lateralSettings, angularSettings, sensors, throttleCurve, steerCurve),
+      lateralConstraints(lateralConstraints),
+      angularConstraints(angularConstraints),
+      leftVelocity(drivetrain.leftMotors, drivetrain.wheelDiameter, drivetrain.rpm, feedforward),
+      rightVelocity(drivetrain.rightMotors, drivetrain.wheelDiameter, drivetrain.rpm, feedforward) {}
+
+Motion Chassis::turnToPoint(float x, float y, int timeout, lemlib::TurnToPointParams params, bool async) {
+    lemlib::Chassis::turnToPoint(x, y, timeout, params, async);
+    return Motion(*this);
+}
+
+Motion Chassis::turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params, bool async) {
+    lemlib::Chassis::turnToHeading(theta, timeout, params, async);
+    return Motion(*this);
+}
+
+Motion Chassis::swingToHeading(float theta, lemlib::DriveSide lockedSide, int timeout,
+                               lemlib::SwingToHeadingParams params, bool async) {
+    lemlib::Chassis::swingToHeading(theta, lockedSide, timeout, params, async);
+    return Motion(*this);
+}
+
+Motion Chassis::swingToPoint(float x, float y, lemlib::DriveSide lockedSide, int timeout,
+                             lemlib::SwingToPointParams params, bool async) {
+    lemlib::Chassis::swingToPoint(x, y, lockedSide, timeout, params, async);
+    return Motion(*this);
+}
+
+Motion Chassis::moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params, bool async) {
+    lemlib::Chassis::moveToPose(x, y, theta, timeout, params, async);
+    return Motion(*this);
+}
+
+Motion Chassis::moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params, bool async) {
+    lemlib::Chassis::moveToPoint(x, y, timeout, params, async);
+    return Motion(*this);
+}
+
+Motion Chassis::follow(const asset& path, float lookahead, int timeout, bool forwards, bool async) {
+    lemlib::Chassis::follow(path, lookahead, timeout, forwards, async);
+    return Motion(*this);
+}
+
+float Chassis::getProfileTimeLeft() const {
+    const std::uint32_t end = profileEnd;
+    const std::uint32_t now = pros::millis();
+    return end > now ? (end - now) / 1000.0f : 0;
+}
+
+void Chassis::setGainSchedules(ScheduledController* lateral, ScheduledController* angular) {
+    lateralSchedule = lateral;
+    angularSchedule = angular;
+}
+
+float Chassis::updateLateral(float error, float remaining) {
+    if (lateralSchedule == nullptr) return lateralPID.update(error);
+    const lemlib::Pose speed = lemlib::getSpeed();
+    return lateralSchedule->update(error, remaining, std::hypot(speed.x, speed.y));
+}
+
+float Chassis::updateAngular(float error, float remaining) {
+    if (angularSchedule == nullptr) return angularPID.update(error);
+    return angularSchedule->update(error, remaining, lemlib::getSpeed().theta);
+}
+
+void Chassis::resetLateral() {
+    lateralPID.reset();
+    if (lateralSchedule != nullptr) lateralSchedule->reset();
+}
+
+void Chassis::resetAngular() {
+    angularPID.reset();
+    if (angularSchedule != nullptr) angularSchedule->reset();
+}
+
+float Chassis::powerToSpeed(float power) const {
+    // free speed of the wheels, in inches per second
+    const float freeSpeed = drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+    return power / 127 * freeSpeed;
+}
+
+void Chassis::driveVelocity(float left, float right, float leftAcceleration, float rightAcceleration) {
+    float leftVoltage = leftVelocity.update(left, leftAcceleration);
+    float rightVoltage = rightVelocity.update(right, rightAcceleration);
+    const float ratio = std::max(std::fabs(leftVoltage), std::fabs(rightVoltage)) / MAX_VOLTAGE;
+    if (ratio > 1) {
+        leftVoltage /= ratio;
+        rightVoltage /= ratio;
+    }
+    drivetrain.leftMotors->move_voltage(leftVoltage);
+    drivetrain.rightMotors->move_voltage(rightVoltage);
+}
+} // namespace pushback
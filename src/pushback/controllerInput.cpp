@@ -0,0 +1,51 @@
+#include "pushback/controllerInput.hpp"
+#include "pros/rtos.hpp"
+
+namespace pushback {
+ControllerInput::ControllerInput(pros::Controller& controller, std::uint32_t period)
+    : controller(controller),
+      period(period),
+      snapshot({{0, 0, 0, 0}, 0, 0}) {}
+
+void ControllerInput::start() {
+    task.start(period, [this](std::uint32_t) { update(); });
+}
+
+void ControllerInput::update() {
+    ControllerSnapshot state {{0, 0, 0, 0}, 0, pros::millis()};
+    for (int channel = pros::E_CONTROLLER_ANALOG_LEFT_X; channel <= pros::E_CONTROLLER_ANALOG_RIGHT_Y; channel++) {
+        state.analog[channel] = controller.get_analog(pros::controller_analog_e_t(channel));
+    }
+    for (int i = 0; i < CONTROLLER_BUTTONS; i++) {
+        const auto button = pros::controller_digital_e_t(pros::E_CONTROLLER_DIGITAL_L1 + i);
+        // PROS_ERR when the controller is disconnected counts as released
+        if (controller.get_digital(button) == 1) state.buttons |= 1 << i;
+    }
+    snapshot.store(state);
+
+    const std::uint16_t changed = state.buttons ^ lastButtons;
+    lastButtons = state.buttons;
+    if (changed == 0) return;
+    for (int i = 0; i < CONTROLLER_BUTTONS; i++) {
+        if (!(changed & (1 << i))) continue;
+        const bool pressed = state.buttons & (1 << i);
+        const ButtonEvent event {pros::controller_digital_e_t(pros::E_CONTROLLER_DIGITAL_L1 + i), pressed, state.time};
+        if (!events.push(event)) dropped++;
+        if (const auto& handler = handlers[i][pressed ? 0 : 1]) handler();
+    }
+}
+
+ControllerSnapshot ControllerInput::getSnapshot() const { return snapshot.load(); }
+
+bool ControllerInput::poll(ButtonEvent& event) { return events.pop(event); }
+
+void ControllerInput::onPress(pros::controller_digital_e_t button, std::function<void()> handler) {
+    handlers[button - pros::E_CONTROLLER_DIGITAL_L1][0] = std::move(handler);
+}
+
+void ControllerInput::onRelease(pros::controller_digital_e_t button, std::function<void()> handler) {
+    handlers[button - pros::E_CONTROLLER_DIGITAL_L1][1] = std::move(handler);
+}
+
+std::uint32_t ControllerInput::getDropped() const { return dropped; }
+} // namespace pushback
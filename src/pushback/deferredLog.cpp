@@ -0,0 +1,125 @@
+#include "pushback/deferredLog.hpp"
+#include <mutex>
+
+namespace pushback {
+// marks the start of a frame, so the decoder can find frames among text on the same stream
+constexpr std::uint8_t SYNC[2] = {0xA5, 0x5A};
+// type byte of each kind of frame
+constexpr std::uint8_t FORMAT_FRAME = 0;
+constexpr std::uint8_t RECORD_FRAME = 1;
+// longest format string sent, so the id and the string fit in a one byte length
+constexpr std::size_t MAX_FORMAT_SIZE = 254;
+// bytes of frames gathered before they are written
+constexpr std::size_t OUTPUT_SIZE = 512;
+// time between resends of the format strings, in milliseconds, so a decoder started late can read every record
+constexpr std::uint32_t FORMAT_INTERVAL = 2000;
+
+namespace {
+/**
+ * Gathers frames, so the output is written in a few large pieces
+ */
+class FrameWriter {
+    public:
+        FrameWriter(const std::function<void(const std::uint8_t* data, std::size_t size)>& write)
+            : write(write) {}
+
+        ~FrameWriter() { flush(); }
+
+        /**
+         * Add a frame, with its body in two parts
+         */
+        void add(std::uint8_t type, const std::uint8_t* header, std::size_t headerSize, const std::uint8_t* body,
+                 std::size_t bodySize) {
+            const std::size_t length = headerSize + bodySize;
+            if (used + length + 5 > OUTPUT_SIZE) flush();
+            std::uint8_t checksum = type + length;
+            put(SYNC, 2);
+            put(&type, 1);
+            const std::uint8_t lengthByte = length;
+            put(&lengthByte, 1);
+            for (std::size_t i = 0; i < headerSize; i++) checksum += header[i];
+            for (std::size_t i = 0; i < bodySize; i++) checksum += body[i];
+            put(header, headerSize);
+            put(body, bodySize);
+            put(&checksum, 1);
+        }
+
+        void flush() {
+            if (used > 0 && write) write(buffer.data(), used);
+            used = 0;
+        }
+    private:
+        void put(const std::uint8_t* data, std::size_t size) {
+            std::memcpy(&buffer[used], data, size);
+            used += size;
+        }
+
+        const std::function<void(const std::uint8_t* data, std::size_t size)>& write;
+        std::array<std::uint8_t, OUTPUT_SIZE> buffer;
+        std::size_t used = 0;
+};
+} // namespace
+
+DeferredLog::DeferredLog(std::function<void(const std::uint8_t* data, std::size_t size)> write, std::uint32_t period)
+    : write(std::move(write)),
+      period(period) {
+    // a slot is free for the position it is at, until it wraps around
+    for (std::size_t i = 0; i < DEFERRED_LOG_RECORDS; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+void DeferredLog::start() {
+    task.start(period, [this](std::uint32_t) { drain(); });
+}
+
+void DeferredLog::drain() {
+    FrameWriter frames(write);
+    const std::uint32_t now = pros::millis();
+    if (now - formatsSentAt >= FORMAT_INTERVAL) {
+        sent.reset();
+        formatsSentAt = now;
+    }
+    while (true) {
+        Slot& slot = slots[head % DEFERRED_LOG_RECORDS];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) break;
+
+        // send the format string before the first record that uses it since the last resend
+        if (!sent[slot.id]) {
+            const std::uint8_t id = slot.id;
+            const std::size_t size = std::min(formatSizes[id], MAX_FORMAT_SIZE);
+            frames.add(FORMAT_FRAME, &id, 1,
+                       reinterpret_cast<const std::uint8_t*>(formats[id].load(std::memory_order_acquire)), size);
+            sent[id] = true;
+        }
+
+        std::uint8_t header[6] = {slot.id, slot.level};
+        std::memcpy(&header[2], &slot.time, 4);
+        frames.add(RECORD_FRAME, header, sizeof(header), slot.args.data(), slot.size);
+        // free the slot for the next time around
+        slot.sequence.store(head + DEFERRED_LOG_RECORDS, std::memory_order_release);
+        head++;
+    }
+}
+
+void DeferredLog::setLowestLevel(lemlib::Level level) { lowestLevel = level; }
+
+void DeferredLog::setEnabled(bool enabled) { this->enabled = enabled; }
+
+std::uint32_t DeferredLog::getDropped() const { return dropped; }
+
+int DeferredLog::addFormat(std::string_view format) {
+    std::lock_guard lock(formatMutex);
+    // another task may have added it while this one waited
+    std::size_t index = hashFormat(format.data());
+    for (std::size_t probe = 0; probe < DEFERRED_LOG_FORMATS; probe++) {
+        const char* found = formats[index].load(std::memory_order_relaxed);
+        if (found == format.data()) return index;
+        if (found == nullptr) {
+            formatSizes[index] = format.size();
+            formats[index].store(format.data(), std::memory_order_release);
+            return index;
+        }
+        index = (index + 1) % DEFERRED_LOG_FORMATS;
+    }
+    return -1;
+}
+} // namespace pushback
@@ -0,0 +1,7 @@
+#include "pushback/driveCurve.hpp"
+
+namespace pushback {
+LutDriveCurve::LutDriveCurve(lemlib::DriveCurve& source) {
+    for (int input = -127; input <= 127; input++) table[input + 127] = source.curve(input);
+}
+} // namespace pushback
@@ -0,0 +1,178 @@
+#include "pushback/ekf.hpp"
+#include "lemlib/util.hpp"
+#include "pros/rtos.hpp"
+#include "pushback/odomCorrection.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace pushback {
+// the filter runs at the same rate as lemlib odometry
+constexpr std::uint32_t UPDATE_PERIOD = 10;
+// distance sensors refresh roughly every 33ms, and reusing a reading would count it twice
+constexpr std::uint32_t DISTANCE_PERIOD = 50;
+constexpr std::uint32_t GPS_PERIOD = 20;
+// an odometry jump bigger than this in a single update means the pose was set by the user
+constexpr float RESET_DISTANCE = 6;
+constexpr float RESET_ANGLE = M_PI / 6;
+constexpr float METERS_TO_INCHES = 39.3701;
+constexpr float GPS_HEADING_NOISE = M_PI / 180;
+
+Ekf::Ekf(EkfSettings settings, std::vector<DistanceMount> distanceSensors, pros::Gps* gps)
+    : settings(settings),
+      distanceSensors(std::move(distanceSensors)),
+      gps(gps),
+      estimate({{0, 0, 0}, {0, 0, 0}}) {}
+
+void Ekf::start() {
+    task.start(UPDATE_PERIOD, [this](std::uint32_t) { update(); });
+}
+
+void Ekf::update() {
+    const lemlib::Pose odom = getCorrectedPose(true);
+    const std::uint32_t now = pros::millis();
+    const lemlib::Pose delta(odom.x - lastOdom.x, odom.y - lastOdom.y, odom.theta - lastOdom.theta);
+    if (!initialized || std::hypot(delta.x, delta.y) > RESET_DISTANCE || std::fabs(delta.theta) > RESET_ANGLE) {
+        reset(odom);
+        lastUpdate = now;
+        return;
+    }
+
+    // drift grows with time even when the robot is still
+    predict(delta);
+    const float dt = (now - lastUpdate) / 1000.0f;
+    covariance(2, 2) += std::pow(lemlib::degToRad(settings.driftNoise), 2) * dt;
+    lastUpdate = now;
+    ticks++;
+
+    bool corrected = false;
+    if (ticks % (DISTANCE_PERIOD / UPDATE_PERIOD) == 0) {
+        for (const DistanceMount& mount : distanceSensors) corrected |= correctDistance(mount);
+    }
+    if (gps != nullptr && ticks % (GPS_PERIOD / UPDATE_PERIOD) == 0) corrected |= correctGps();
+    if (!corrected) {
+        lastOdom = odom;
+        publish();
+        return;
+    }
+
+    const lemlib::Pose target = toOdom(settings.origin, lemlib::Pose(state(0, 0), state(1, 0), state(2, 0)));
+    shiftPose(odom, target);
+    lastOdom = target;
+    publish();
+}
+
+void Ekf::publish() {
+    estimate.store({{state(0, 0), state(1, 0), state(2, 0)},
+                    {std::sqrt(covariance(0, 0)), std::sqrt(covariance(1, 1)),
+                     lemlib::radToDeg(std::sqrt(covariance(2, 2)))}});
+}
+
+void Ekf::reset(const lemlib::Pose& odom) {
+    const lemlib::Pose field = toField(settings.origin, odom);
+    state(0, 0) = field.x;
+    state(1, 0) = field.y;
+    state(2, 0) = field.theta;
+    // the starting pose is trusted to about an inch and a degree
+    covariance = Matrix3::identity();
+    covariance(2, 2) = std::pow(lemlib::degToRad(1), 2);
+    lastOdom = odom;
+    initialized = true;
+    publish();
+}
+
+void Ekf::predict(const lemlib::Pose& delta) {
+    // rotate the odometry displacement into the field frame
+    const float rotation = lemlib::degToRad(settings.origin.theta);
+    const float dx = delta.x * std::cos(rotation) + delta.y * std::sin(rotation);
+    const float dy = -delta.x * std::sin(rotation) + delta.y * std::cos(rotation);
+    state(0, 0) += dx;
+    state(1, 0) += dy;
+    state(2, 0) += delta.theta;
+
+    // a heading error rotates the displacement, which is how heading uncertainty turns into position uncertainty
+    Matrix3 F = Matrix3::identity();
+    F(0, 2) = dy;
+    F(1, 2) = -dx;
+    const float travel = std::hypot(dx, dy);
+    Matrix3 Q;
+    Q(0, 0) = settings.travelNoise * travel;
+    Q(1, 1) = settings.travelNoise * travel;
+    Q(2, 2) = settings.turnNoise * std::fabs(delta.theta);
+    covariance = F * covariance * F.transpose() + Q;
+}
+
+bool Ekf::correct(float innovation, const Matrix<1, 3>& H, float variance) {
+    const Matrix<3, 1> PHt = covariance * H.transpose();
+    const float S = (H * PHt)(0, 0) + variance;
+    if (innovation * innovation > settings.gate * settings.gate * S) {
+        rejected++;
+        return false;
+    }
+    const Matrix<3, 1> K = PHt * (1 / S);
+    state = state + K * innovation;
+    // Joseph form keeps the covariance symmetric and positive definite in single precision
+    const Matrix3 A = Matrix3::identity() - K * H;
+    covariance = A * covariance * A.transpose() + K * K.transpose() * variance;
+    accepted++;
+    return true;
+}
+
+bool Ekf::correctDistance(const DistanceMount& mount) {
+    if (mount.sensor->get_confidence() < settings.minConfidence) return false;
+    const float measured = mount.sensor->get_distance() / 25.4f;
+    if (measured <= 0 || measured > settings.maxDistance) return false;
+    const float expected = expectedDistance(state, mount);
+    if (!std::isfinite(expected)) return false;
+
+    // numerical jacobian, the wall that is hit changes with the pose
+    constexpr std::array<float, 3> STEP = {0.05, 0.05, 0.001};
+    Matrix<1, 3> H;
+    for (std::size_t i = 0; i < 3; i++) {
+        Vector3 high = state;
+        Vector3 low = state;
+        high(i, 0) += STEP[i];
+        low(i, 0) -= STEP[i];
+        H(0, i) = (expectedDistance(high, mount) - expectedDistance(low, mount)) / (2 * STEP[i]);
+    }
+    if (!std::isfinite(H(0, 0) + H(0, 1) + H(0, 2))) return false;
+    const float noise = std::max(settings.distanceNoise, settings.distanceNoiseRatio * measured);
+    return correct(measured - expected, H, noise * noise);
+}
+
+bool Ekf::correctGps() {
+    const double error = gps->get_error() * METERS_TO_INCHES;
+    if (!std::isfinite(error) || error > settings.maxGpsError) return false;
+    const pros::gps_position_s_t position = gps->get_position();
+    const double heading = gps->get_heading();
+    if (!std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(heading)) return false;
+
+    const float variance = std::max(error * error, 0.25);
+    bool corrected = false;
+    corrected |= correct(position.x * METERS_TO_INCHES - state(0, 0), {{1, 0, 0}}, variance);
+    corrected |= correct(position.y * METERS_TO_INCHES - state(1, 0), {{0, 1, 0}}, variance);
+    corrected |= correct(lemlib::angleError(lemlib::degToRad(heading), state(2, 0)), {{0, 0, 1}},
+                         GPS_HEADING_NOISE * GPS_HEADING_NOISE);
+    return corrected;
+}
+
+float Ekf::expectedDistance(const Vector3& pose, const DistanceMount& mount) const {
+    const float theta = pose(2, 0);
+    const float x = pose(0, 0) + mount.x * std::cos(theta) + mount.y * std::sin(theta);
+    const float y = pose(1, 0) - mount.x * std::sin(theta) + mount.y * std::cos(theta);
+    const WallHit hit = castRay(x, y, theta + lemlib::degToRad(mount.heading), settings.fieldHalfWidth);
+    if (!hit.valid || hit.distance > settings.maxDistance) return NAN;
+    return hit.distance;
+}
+
+lemlib::Pose Ekf::getFieldPose(bool radians) const {
+    const lemlib::Pose pose = estimate.load().pose;
+    return {pose.x, pose.y, radians ? pose.theta : lemlib::radToDeg(pose.theta)};
+}
+
+lemlib::Pose Ekf::getStdDev() const { return estimate.load().stdDev; }
+
+std::uint32_t Ekf::getAccepted() const { return accepted.load(std::memory_order_relaxed); }
+
+std::uint32_t Ekf::getRejected() const { return rejected.load(std::memory_order_relaxed); }
+} // namespace pushback
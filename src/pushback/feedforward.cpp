@@ -0,0 +1,63 @@
+#include "pushback/feedforward.hpp"
+#include "pros/motors.h"
+#include "pros/rtos.hpp"
+#include <cmath>
+
+namespace pushback {
+// velocity loop integral is limited to this much voltage, in millivolts
+constexpr float MAX_INTEGRAL = 3000;
+// gaps between updates longer than this mean a new motion started, in milliseconds
+constexpr std::uint32_t MAX_GAP = 50;
+
+VelocityController::VelocityController(pros::MotorGroup* motors, float wheelDiameter, float rpm,
+                                       FeedforwardSettings settings)
+    : motors(motors),
+      sampler(*motors),
+      wheelDiameter(wheelDiameter),
+      rpm(rpm),
+      settings(settings) {}
+
+float VelocityController::update(float velocity, float acceleration) {
+    const std::uint32_t now = pros::millis();
+    const float dt = now - lastTime < MAX_GAP ? (now - lastTime) / 1000.0f : 0;
+    lastTime = now;
+
+    // static friction only opposes motion the robot is asked to make
+    float out = velocity == 0 ? 0 : std::copysign(settings.kS, velocity);
+    out += settings.kV * velocity + settings.kA * acceleration;
+    if (settings.kP == 0 && settings.kI == 0) return out;
+
+    const float error = velocity - getVelocity();
+    if (settings.kI != 0) {
+        integral += error * dt;
+        const float limit = MAX_INTEGRAL / std::fabs(settings.kI);
+        integral = std::fmax(-limit, std::fmin(integral, limit));
+    }
+    return out + settings.kP * error + settings.kI * integral;
+}
+
+void VelocityController::reset() { integral = 0; }
+
+float VelocityController::getVelocity() const {
+    // velocities are reported at the output of the cartridge
+    float cartridge = 0;
+    switch (motors->get_gearing()) {
+        case pros::MotorGears::red: cartridge = 100; break;
+        case pros::MotorGears::green: cartridge = 200; break;
+        case pros::MotorGears::blue: cartridge = 600; break;
+        default: return 0;
+    }
+    // unplugged motors report PROS_ERR_F, leave them out of the average
+    double sum = 0;
+    int count = 0;
+    for (std::size_t i = 0; i < sampler.size(); i++) {
+        const double velocity = pros::c::motor_get_actual_velocity(sampler.getPort(i));
+        if (!std::isfinite(velocity)) continue;
+        sum += velocity;
+        count++;
+    }
+    if (count == 0) return 0;
+    const float motorRpm = sum / count;
+    return motorRpm * (rpm / cartridge) / 60 * M_PI * wheelDiameter;
+}
+} // namespace pushback
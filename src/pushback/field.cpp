@@ -0,0 +1,41 @@
+#include "pushback/field.hpp"
+#include "lemlib/util.hpp"
+#include <cmath>
+
+namespace pushback {
+// readings that hit the wall at a grazing angle or close to a corner are unreliable
+constexpr float MIN_INCIDENCE = 0.5;
+constexpr float CORNER_MARGIN = 4;
+
+WallHit castRay(float x, float y, float heading, float halfWidth) {
+    const float dx = std::sin(heading);
+    const float dy = std::cos(heading);
+    float distance = INFINITY;
+    float incidence = 0;
+    float along = 0;
+    if (std::fabs(dx) > 1e-6) {
+        const float t = ((dx > 0 ? halfWidth : -halfWidth) - x) / dx;
+        if (t < distance) distance = t, incidence = std::fabs(dx), along = y + t * dy;
+    }
+    if (std::fabs(dy) > 1e-6) {
+        const float t = ((dy > 0 ? halfWidth : -halfWidth) - y) / dy;
+        if (t < distance) distance = t, incidence = std::fabs(dy), along = x + t * dx;
+    }
+    const bool valid = distance > 0 && incidence > MIN_INCIDENCE && std::fabs(along) < halfWidth - CORNER_MARGIN;
+    return {distance, valid};
+}
+
+lemlib::Pose toField(const lemlib::Pose& origin, const lemlib::Pose& odom) {
+    const float rotation = lemlib::degToRad(origin.theta);
+    return {origin.x + odom.x * std::cos(rotation) + odom.y * std::sin(rotation),
+            origin.y - odom.x * std::sin(rotation) + odom.y * std::cos(rotation), rotation + odom.theta};
+}
+
+lemlib::Pose toOdom(const lemlib::Pose& origin, const lemlib::Pose& field) {
+    const float rotation = lemlib::degToRad(origin.theta);
+    const float dx = field.x - origin.x;
+    const float dy = field.y - origin.y;
+    return {dx * std::cos(rotation) - dy * std::sin(rotation), dx * std::sin(rotation) + dy * std::cos(rotation),
+            field.theta - rotation};
+}
+} // namespace pushback
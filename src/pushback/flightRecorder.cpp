@@ -0,0 +1,182 @@
+#include "pushback/flightRecorder.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+#include "pushback/poseSnapshot.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace pushback {
+// a block that has been filling this long is written even if it is not full, in milliseconds
+constexpr std::uint32_t FLIGHT_FLUSH_AGE = 1000;
+// time between checks for a full block, in milliseconds
+constexpr std::uint32_t FLIGHT_WRITE_PERIOD = 20;
+// most recordings kept on the card
+constexpr int MAX_FLIGHT_FILES = 1000;
+
+namespace {
+/**
+ * Convert a reading to a smaller integer, saturating instead of wrapping. Failed reads are PROS_ERR or PROS_ERR_F
+ */
+template <typename T> T saturate(double value) {
+    if (std::isnan(value)) return 0;
+    return std::clamp(value, double(std::numeric_limits<T>::min()), double(std::numeric_limits<T>::max()));
+}
+} // namespace
+
+FlightRecorder::FlightRecorder(const pros::MotorGroup& leftMotors, const pros::MotorGroup& rightMotors,
+                               const ControllerInput& input, const Chassis& chassis, std::uint32_t period)
+    : leftSampler(leftMotors),
+      rightSampler(rightMotors),
+      input(input),
+      chassis(chassis),
+      period(period) {}
+
+bool FlightRecorder::start() {
+    if (task.isStarted()) return true;
+    if (!pros::usd::is_installed()) {
+        lemlib::infoSink()->error("FlightRecorder needs a microSD card, nothing will be recorded");
+        return false;
+    }
+    // the first name not taken by an earlier recording
+    char name[32];
+    int index = 0;
+    for (; index < MAX_FLIGHT_FILES; index++) {
+        std::snprintf(name, sizeof(name), "/usd/flight%03d.bin", index);
+        std::FILE* existing = std::fopen(name, "rb");
+        if (existing == nullptr) break;
+        std::fclose(existing);
+    }
+    std::FILE* file = index < MAX_FLIGHT_FILES ? std::fopen(name, "wb") : nullptr;
+    if (file == nullptr) {
+        lemlib::infoSink()->error("FlightRecorder could not create a file on the microSD card");
+        return false;
+    }
+    FlightHeader header {.magic = FLIGHT_MAGIC,
+                         .period = static_cast<std::uint16_t>(period),
+                         .leftMotors = static_cast<std::uint8_t>(leftSampler.size()),
+                         .rightMotors = static_cast<std::uint8_t>(rightSampler.size()),
+                         .ports = {}};
+    for (std::size_t i = 0; i < leftSampler.size(); i++) header.ports[i] = leftSampler.getPort(i);
+    for (std::size_t i = 0; i < rightSampler.size(); i++) {
+        header.ports[leftSampler.size() + i] = rightSampler.getPort(i);
+    }
+    const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    std::fclose(file);
+    if (!written) {
+        lemlib::infoSink()->error("FlightRecorder could not write to {}", name);
+        return false;
+    }
+    path = name;
+    bytesWritten = sizeof(header);
+
+    task.start(period, [this](std::uint32_t time) { sample(time); });
+    // below the control tasks, so a slow card only delays the writes
+    pros::Task writer(
+        [this] {
+            while (true) {
+                writeBlocks();
+                pros::delay(FLIGHT_WRITE_PERIOD);
+            }
+        },
+        TASK_PRIORITY_DEFAULT - 1);
+    return true;
+}
+
+void FlightRecorder::sample(std::uint32_t time) {
+    const PoseSnapshot odom = getPoseSnapshot();
+    const FlightPose pose {odom.pose.x,     odom.pose.y,     odom.pose.theta,
+                           odom.velocity.x, odom.velocity.y, odom.velocity.theta};
+    add(FlightRecordType::POSE, time, &pose, sizeof(pose));
+
+    for (const MotorSampler* sampler : {&leftSampler, &rightSampler}) {
+        sampler->snapshot(telemetry);
+        std::array<FlightMotor, MAX_SAMPLED_MOTORS> motors;
+        for (std::size_t i = 0; i < telemetry.count; i++) {
+            motors[i] = {.position = static_cast<float>(telemetry.position[i]),
+                         .velocity = saturate<std::int16_t>(telemetry.velocity[i]),
+                         .current = saturate<std::int16_t>(telemetry.current[i]),
+                         .voltage = saturate<std::int16_t>(telemetry.voltage[i]),
+                         .temperature = saturate<std::uint8_t>(telemetry.temperature[i]),
+                         .faults = static_cast<std::uint8_t>(telemetry.faults[i])};
+        }
+        add(sampler == &leftSampler ? FlightRecordType::LEFT_MOTORS : FlightRecordType::RIGHT_MOTORS, time,
+            motors.data(), telemetry.count * sizeof(FlightMotor));
+    }
+
+    const ControllerSnapshot state = input.getSnapshot();
+    const FlightController controller {.analog = state.analog, .buttons = state.buttons, .reserved = 0};
+    add(FlightRecordType::CONTROLLER, time, &controller, sizeof(controller));
+
+    const FlightMotion motion {.inMotion = chassis.isInMotion(),
+                               .reserved = {},
+                               .profileTimeLeft = chassis.getProfileTimeLeft()};
+    add(FlightRecordType::MOTION, time, &motion, sizeof(motion));
+
+    // bound what is lost at power off when the block fills slowly
+    if (blocks[filling].size > 0 && time - fillStart >= FLIGHT_FLUSH_AGE) handOff();
+}
+
+const std::string& FlightRecorder::getPath() const { return path; }
+
+std::uint32_t FlightRecorder::getBytesWritten() const { return bytesWritten; }
+
+std::uint32_t FlightRecorder::getDropped() const { return dropped; }
+
+std::uint32_t FlightRecorder::getWriteErrors() const { return writeErrors; }
+
+void FlightRecorder::add(FlightRecordType type, std::uint32_t time, const void* data, std::size_t size) {
+    // records dropped earlier are reported just before this one
+    const std::size_t reportSize = unreported > 0 ? sizeof(FlightRecordHeader) + sizeof(std::uint32_t) : 0;
+    const std::size_t needed = reportSize + sizeof(FlightRecordHeader) + size;
+    if (blocks[filling].size + needed > FLIGHT_RECORDER_BLOCK_SIZE && !handOff()) {
+        unreported++;
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Block& block = blocks[filling];
+    if (block.size == 0) fillStart = time;
+    const auto put = [&](FlightRecordType recordType, const void* recordData, std::size_t recordSize) {
+        const FlightRecordHeader header {
+            .type = recordType, .reserved = 0, .size = static_cast<std::uint16_t>(recordSize), .time = time};
+        std::memcpy(&block.data[block.size], &header, sizeof(header));
+        std::memcpy(&block.data[block.size + sizeof(header)], recordData, recordSize);
+        block.size += sizeof(header) + recordSize;
+    };
+    if (unreported > 0) {
+        put(FlightRecordType::DROPPED, &unreported, sizeof(unreported));
+        unreported = 0;
+    }
+    put(type, data, size);
+}
+
+bool FlightRecorder::handOff() {
+    Block& next = blocks[1 - filling];
+    if (next.full.load(std::memory_order_acquire)) return false;
+    blocks[filling].full.store(true, std::memory_order_release);
+    filling = 1 - filling;
+    next.size = 0;
+    return true;
+}
+
+void FlightRecorder::writeBlocks() {
+    // only one block is full at a time, so they are written in the order they were filled
+    for (Block& block : blocks) {
+        if (!block.full.load(std::memory_order_acquire)) continue;
+        // closed after every write, so the data is on the card if the robot is turned off
+        std::FILE* file = std::fopen(path.c_str(), "ab");
+        // unbuffered, so the block reaches the card in one write instead of being copied through the stdio buffer
+        if (file != nullptr) std::setvbuf(file, nullptr, _IONBF, 0);
+        if (file != nullptr && std::fwrite(block.data.data(), 1, block.size, file) == block.size) {
+            bytesWritten.fetch_add(block.size, std::memory_order_relaxed);
+        } else {
+            writeErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (file != nullptr) std::fclose(file);
+        block.full.store(false, std::memory_order_release);
+    }
+}
+} // namespace pushback
@@ -0,0 +1,113 @@
+#include "pushback/motionPlan.hpp"
+#include "lemlib/util.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pushback {
+// moves shorter than this are dropped, in inches
+constexpr float MIN_LENGTH = 0.01;
+
+MotionPlan& MotionPlan::moveTo(float x, float y, PlanMoveParams params) {
+    steps.push_back({PlanSegment::Type::LINE, x, y, 0, params.forwards, params.maxSpeed, std::move(pending)});
+    pending.clear();
+    return *this;
+}
+
+MotionPlan& MotionPlan::turnTo(float theta, PlanTurnParams params) {
+    steps.push_back({PlanSegment::Type::TURN, 0, 0, theta, true, params.maxSpeed, std::move(pending)});
+    pending.clear();
+    return *this;
+}
+
+MotionPlan& MotionPlan::action(std::function<void()> action) {
+    pending.push_back(std::move(action));
+    return *this;
+}
+
+const std::vector<std::function<void()>>& MotionPlan::getEndActions() const { return pending; }
+
+std::vector<PlanSegment> MotionPlan::build(lemlib::Pose start, ProfileConstraints lateralConstraints,
+                                           ProfileConstraints angularConstraints) const {
+    std::vector<PlanSegment> segments;
+    float x = start.x;
+    float y = start.y;
+    float theta = start.theta;
+    // actions of dropped steps move on to the next segment
+    std::vector<std::function<void()>> carried;
+    for (const Step& step : steps) {
+        const float speed = std::clamp(step.maxSpeed, 0.0f, 127.0f) / 127;
+        carried.insert(carried.end(), step.actions.begin(), step.actions.end());
+        PlanSegment segment {step.type, x, y, x, y, theta, 0, step.forwards, 0, 0, 0, {}};
+        if (step.type == PlanSegment::Type::LINE) {
+            segment.endX = step.x;
+            segment.endY = step.y;
+            segment.length = std::hypot(step.x - x, step.y - y);
+            if (segment.length < MIN_LENGTH) continue;
+            segment.maxVelocity = lateralConstraints.maxVelocity * speed;
+            // heading the robot faces while driving the line
+            theta = lemlib::radToDeg(std::atan2(step.x - x, step.y - y)) + (step.forwards ? 0 : 180);
+            x = step.x;
+            y = step.y;
+        } else {
+            segment.endTheta = step.theta;
+            segment.length = std::fabs(lemlib::angleError(step.theta, theta, false));
+            segment.maxVelocity = angularConstraints.maxVelocity * speed;
+            theta = step.theta;
+        }
+        segment.actions = std::move(carried);
+        carried.clear();
+        segments.push_back(std::move(segment));
+    }
+
+    // speed limit at each boundary between two lines, from the corner between them
+    for (std::size_t i = 0; i + 1 < segments.size(); i++) {
+        PlanSegment& current = segments[i];
+        const PlanSegment& next = segments[i + 1];
+        if (current.type != PlanSegment::Type::LINE || next.type != PlanSegment::Type::LINE) continue;
+        if (current.forwards != next.forwards) continue;
+        const float currentAngle = std::atan2(current.endX - current.startX, current.endY - current.startY);
+        const float nextAngle = std::atan2(next.endX - next.startX, next.endY - next.startY);
+        const float corner = std::fabs(lemlib::angleError(nextAngle, currentAngle));
+        // straight through keeps full speed, a right angle or sharper stops
+        current.exitVelocity = std::min(current.maxVelocity, next.maxVelocity) * std::max(0.0f, std::cos(corner));
+    }
+
+    // forward pass, limited by how fast the robot can accelerate
+    const float acceleration = lateralConstraints.maxAcceleration;
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        PlanSegment& segment = segments[i];
+        if (segment.type != PlanSegment::Type::LINE) continue;
+        if (i > 0 && segments[i - 1].type == PlanSegment::Type::LINE) {
+            segment.entryVelocity = segments[i - 1].exitVelocity;
+        }
+        const float reachable = std::sqrt(segment.entryVelocity * segment.entryVelocity +
+                                          2 * acceleration * segment.length);
+        segment.exitVelocity = std::min(segment.exitVelocity, reachable);
+    }
+    // backward pass, limited by how fast the robot can stop
+    for (std::size_t i = segments.size(); i-- > 0;) {
+        PlanSegment& segment = segments[i];
+        if (segment.type != PlanSegment::Type::LINE) continue;
+        if (i + 1 < segments.size() && segments[i + 1].type == PlanSegment::Type::LINE) {
+            segment.exitVelocity = segments[i + 1].entryVelocity;
+        }
+        const float stoppable = std::sqrt(segment.exitVelocity * segment.exitVelocity +
+                                          2 * acceleration * segment.length);
+        segment.entryVelocity = std::min(segment.entryVelocity, stoppable);
+    }
+    return segments;
+}
+
+ProfileState sampleSegment(const PlanSegment& segment, float traveled, float maxAcceleration) {
+    const float s = std::clamp(traveled, 0.0f, segment.length);
+    const float remaining = segment.length - s;
+    const float accelerating = std::sqrt(segment.entryVelocity * segment.entryVelocity + 2 * maxAcceleration * s);
+    const float decelerating =
+        std::sqrt(segment.exitVelocity * segment.exitVelocity + 2 * maxAcceleration * remaining);
+    if (decelerating <= accelerating && decelerating < segment.maxVelocity) {
+        return {remaining, decelerating, -maxAcceleration};
+    }
+    if (accelerating < segment.maxVelocity) return {remaining, accelerating, maxAcceleration};
+    return {remaining, segment.maxVelocity, 0};
+}
+} // namespace pushback
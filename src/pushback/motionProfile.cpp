@@ -0,0 +1,77 @@
+#include "pushback/motionProfile.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pushback {
+MotionProfile::MotionProfile(float distance, ProfileConstraints constraints)
+    : distance(std::fabs(distance)),
+      sign(distance < 0 ? -1 : 1) {
+    const float maxV = std::fabs(constraints.maxVelocity);
+    const float maxA = std::fabs(constraints.maxAcceleration);
+    const float maxJ = std::fabs(constraints.maxJerk);
+    if (this->distance == 0 || maxV == 0 || maxA == 0) return;
+
+    // time to ramp from zero to peak acceleration. With no jerk limit the ramp is instant
+    const auto phaseTime = [&](float v, float a) { return maxJ > 0 ? v / a + a / maxJ : v / a; };
+    velocity = maxV;
+    acceleration = maxA;
+    // acceleration never reaches its limit if velocity gets there first
+    if (maxJ > 0 && maxV * maxJ < maxA * maxA) acceleration = std::sqrt(maxV * maxJ);
+
+    // the acceleration phase covers v * t / 2 by symmetry. If both phases are longer than the motion, lower the peak
+    if (velocity * phaseTime(velocity, acceleration) > this->distance) {
+        const float rampTime = maxJ > 0 ? maxA / maxJ : 0;
+        // solve v * (v / a + a / j) = d for v
+        velocity = (std::sqrt(rampTime * rampTime + 4 * this->distance / maxA) - rampTime) * maxA / 2;
+        acceleration = maxA;
+        if (maxJ > 0 && velocity * maxJ < maxA * maxA) {
+            // pure jerk phases: v * 2 * sqrt(v / j) = d
+            velocity = std::cbrt(this->distance * this->distance * maxJ / 4);
+            acceleration = std::sqrt(velocity * maxJ);
+        }
+    }
+
+    jerk = maxJ;
+    jerkTime = maxJ > 0 ? acceleration / maxJ : 0;
+    accelerationTime = phaseTime(velocity, acceleration);
+    cruiseTime = std::max(0.0f, (this->distance - velocity * accelerationTime) / velocity);
+}
+
+ProfileState MotionProfile::sampleAcceleration(float t) const {
+    const float constantTime = accelerationTime - 2 * jerkTime;
+    // velocity and position at the end of the first jerk segment
+    const float v1 = jerk * jerkTime * jerkTime / 2;
+    const float p1 = jerk * jerkTime * jerkTime * jerkTime / 6;
+    if (t < jerkTime) return {jerk * t * t * t / 6, jerk * t * t / 2, jerk * t};
+    if (t < jerkTime + constantTime) {
+        const float tau = t - jerkTime;
+        return {p1 + v1 * tau + acceleration * tau * tau / 2, v1 + acceleration * tau, acceleration};
+    }
+    // the last jerk segment mirrors the first
+    const float u = std::max(0.0f, accelerationTime - t);
+    const float end = velocity * accelerationTime / 2;
+    return {end - (velocity * u - jerk * u * u * u / 6), velocity - jerk * u * u / 2, jerk * u};
+}
+
+ProfileState MotionProfile::sample(float time) const {
+    const float duration = getDuration();
+    const float t = std::clamp(time, 0.0f, duration);
+    ProfileState state {0, 0, 0};
+    if (duration == 0) {
+        state = {distance, 0, 0};
+    } else if (t < accelerationTime) {
+        state = sampleAcceleration(t);
+    } else if (t < accelerationTime + cruiseTime) {
+        state = {velocity * accelerationTime / 2 + velocity * (t - accelerationTime), velocity, 0};
+    } else {
+        // deceleration is the acceleration phase played backwards
+        const ProfileState mirror = sampleAcceleration(duration - t);
+        state = {distance - mirror.position, mirror.velocity, -mirror.acceleration};
+    }
+    return {sign * state.position, sign * state.velocity, sign * state.acceleration};
+}
+
+float MotionProfile::getDuration() const { return velocity > 0 ? 2 * accelerationTime + cruiseTime : 0; }
+
+float MotionProfile::getDistance() const { return sign * distance; }
+} // namespace pushback
@@ -0,0 +1,85 @@
+#include "pushback/chassis.hpp"
+#include "pushback/pathCursor.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "pros/misc.hpp"
+#include <algorithm>
+#include <cmath>
+
+// the robot is never commanded slower than this, so it can not stall at the ends of the path, in inches per second
+constexpr float PATH_MIN_SPEED = 3;
+// the motion ends this close to the last point, in inches
+constexpr float PATH_END_TOLERANCE = 1;
+// acceleration is estimated over this much of the velocity profile ahead of the robot, in inches
+constexpr float PROFILE_STEP = 1;
+
+pushback::Motion pushback::Chassis::followPath(const asset& path, float lookahead, int timeout, bool forwards,
+                                               bool async) {
+    const Path points(path);
+    if (!points.isValid()) {
+        lemlib::infoSink()->error("Path asset is not a compiled path! Use the _path asset. Skipping motion");
+        return Motion(*this);
+    }
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return Motion(*this);
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { followPath(path, lookahead, timeout, forwards, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return Motion(*this);
+    }
+
+    leftVelocity.reset();
+    rightVelocity.reset();
+
+    const PathPoint& end = points[points.size() - 1];
+    const float direction = forwards ? 1 : -1;
+    // a robot pushed further than the lookahead from the path searches for it again
+    PathCursor cursor(points, lookahead);
+
+    lemlib::Timer timer(timeout);
+    distTraveled = 0;
+    while (!timer.isDone() && this->motionRunning) {
+        lemlib::Pose pose = getPose(true);
+        if (!forwards) pose.theta += M_PI;
+
+        cursor.update(pose.x, pose.y);
+        distTraveled = cursor.getDistance();
+        if (distTraveled >= points.getLength() || std::hypot(end.x - pose.x, end.y - pose.y) < PATH_END_TOLERANCE) {
+            break;
+        }
+        const PathPoint target = cursor.lookahead(pose.x, pose.y, lookahead);
+
+        // curvature of the arc to the lookahead point, positive to the right
+        const float dx = target.x - pose.x;
+        const float dy = target.y - pose.y;
+        const float side = dx * std::cos(pose.theta) - dy * std::sin(pose.theta);
+        const float curvature = 2 * side / std::max(dx * dx + dy * dy, 1e-6f);
+
+        // velocity and acceleration from the profile stored in the path
+        const PathPoint current = cursor.sample(distTraveled);
+        const PathPoint next = cursor.sample(distTraveled + PROFILE_STEP);
+        const float speed = std::max(current.velocity, PATH_MIN_SPEED);
+        const float ds = next.distance - current.distance;
+        const float acceleration =
+            ds > 0 ? (next.velocity * next.velocity - current.velocity * current.velocity) / (2 * ds) : 0;
+
+        // the turn is the same going backwards, because the heading was flipped
+        const float turn = speed * curvature * drivetrain.trackWidth / 2;
+        const float accelTurn = acceleration * curvature * drivetrain.trackWidth / 2;
+        driveVelocity(direction * speed + turn, direction * speed - turn, direction * acceleration + accelTurn,
+                      direction * acceleration - accelTurn);
+
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+    return Motion(*this);
+}
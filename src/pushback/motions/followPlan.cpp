@@ -0,0 +1,132 @@
+#include "pushback/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "pros/misc.hpp"
+#include <algorithm>
+#include <cmath>
+
+// the robot steers towards a point this far ahead of it on the plan, in inches
+constexpr float PLAN_LOOKAHEAD = 12;
+// the robot is never commanded slower than this on a line, so it can not stall before the end, in inches per second
+constexpr float MIN_SPEED = 3;
+// a line that ends at rest is done this close to its end, in inches
+constexpr float LINE_TOLERANCE = 0.5;
+// a turn is done once its profile is over and the heading is this close, in degrees
+constexpr float TURN_TOLERANCE = 1.5;
+
+pushback::Motion pushback::Chassis::followPlan(const MotionPlan& plan, int timeout, bool async) {
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return Motion(*this);
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { followPlan(plan, timeout, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return Motion(*this);
+    }
+
+    // reset PIDs
+    resetLateral();
+    resetAngular();
+    leftVelocity.reset();
+    rightVelocity.reset();
+
+    std::vector<PlanSegment> segments = plan.build(getPose(), lateralConstraints, angularConstraints);
+    const float acceleration = lateralConstraints.maxAcceleration;
+
+    lemlib::Timer timer(timeout);
+    distTraveled = 0;
+    float completed = 0;
+    std::size_t index = 0;
+    bool entered = false;
+    // profile of the current turn, and when it started
+    MotionProfile turnProfile(0, angularConstraints);
+    float turnStart = 0;
+    std::uint32_t turnStartTime = 0;
+    while (!timer.isDone() && this->motionRunning && index < segments.size()) {
+        PlanSegment& segment = segments[index];
+        if (!entered) {
+            entered = true;
+            for (const auto& action : segment.actions) action();
+            if (segment.type == PlanSegment::Type::TURN) {
+                resetAngular();
+                turnStart = getPose().theta;
+                ProfileConstraints constraints = angularConstraints;
+                constraints.maxVelocity = segment.maxVelocity;
+                turnProfile = MotionProfile(lemlib::angleError(segment.endTheta, turnStart, false), constraints);
+                turnStartTime = pros::millis();
+            }
+        }
+        const bool endsAtRest = index + 1 == segments.size() || segments[index + 1].type != PlanSegment::Type::LINE ||
+                                segment.exitVelocity == 0;
+
+        if (segment.type == PlanSegment::Type::LINE) {
+            const lemlib::Pose pose = getPose(true);
+            const float dirX = (segment.endX - segment.startX) / segment.length;
+            const float dirY = (segment.endY - segment.startY) / segment.length;
+            const float along = (pose.x - segment.startX) * dirX + (pose.y - segment.startY) * dirY;
+            distTraveled = completed + std::max(0.0f, along);
+            // move on once the robot passes the end of the line
+            if (along >= segment.length - (endsAtRest ? LINE_TOLERANCE : 0)) {
+                completed += segment.length;
+                index++;
+                entered = false;
+                continue;
+            }
+
+            const ProfileState state = sampleSegment(segment, along, acceleration);
+            const float direction = segment.forwards ? 1 : -1;
+            const float velocity = direction * std::max(state.velocity, MIN_SPEED);
+
+            // aim point, carried onto the next line when it is blended, and past the end of the line otherwise
+            float ahead = along + PLAN_LOOKAHEAD;
+            float aimX = segment.startX + dirX * ahead;
+            float aimY = segment.startY + dirY * ahead;
+            if (!endsAtRest && ahead > segment.length) {
+                const PlanSegment& next = segments[index + 1];
+                ahead = std::min(ahead - segment.length, next.length);
+                aimX = next.startX + (next.endX - next.startX) / next.length * ahead;
+                aimY = next.startY + (next.endY - next.startY) / next.length * ahead;
+            }
+            float targetTheta = std::atan2(aimX - pose.x, aimY - pose.y);
+            if (!segment.forwards) targetTheta += M_PI;
+            const float headingError = lemlib::radToDeg(lemlib::angleError(targetTheta, pose.theta, true));
+            const float turn = powerToSpeed(updateAngular(headingError, headingError));
+
+            const float accel = direction * state.acceleration;
+            driveVelocity(velocity + turn, velocity - turn, accel, accel);
+        } else {
+            const float heading = getPose().theta;
+            const float error = lemlib::angleError(segment.endTheta, heading, false);
+            const float time = (pros::millis() - turnStartTime) / 1000.0f;
+            if (time >= turnProfile.getDuration() && std::fabs(error) < TURN_TOLERANCE) {
+                index++;
+                entered = false;
+                continue;
+            }
+
+            const ProfileState state = turnProfile.sample(time);
+            // the wheels travel along a circle with a diameter of the track width
+            const float toWheel = lemlib::degToRad(1) * drivetrain.trackWidth / 2;
+            const float velocity =
+                state.velocity * toWheel + powerToSpeed(updateAngular(state.position - (heading - turnStart), error));
+            const float accel = state.acceleration * toWheel;
+            driveVelocity(velocity, -velocity, accel, -accel);
+        }
+
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // actions after the last move only run if the plan finished
+    if (index == segments.size()) {
+        for (const auto& action : plan.getEndActions()) action();
+    }
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+    return Motion(*this);
+}
@@ -0,0 +1,100 @@
+#include "pushback/chassis.hpp"
+#include "pushback/trajectory.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "pros/misc.hpp"
+#include <cmath>
+
+// after the trajectory ends, the robot has this long to settle on the last point, in seconds
+constexpr float TRAJECTORY_SETTLE_TIME = 0.25;
+// the motion ends early once the trajectory is over and the robot is this close to the last point, in inches
+constexpr float TRAJECTORY_END_TOLERANCE = 1;
+// how far ahead of the robot's position the velocity and turn rate are sampled, in seconds. The wheels take about
+// this long to reach a commanded speed, so without the lead the robot falls behind every change in the profile
+constexpr float TRAJECTORY_LEAD = 0.05;
+// smallest RAMSETE gain, in 1/seconds. The usual gain goes to 0 with the reference velocity, so without a floor a
+// robot that lags behind at the end of the trajectory is never pulled onto the last point
+constexpr float TRAJECTORY_MIN_GAIN = 2;
+
+pushback::Motion pushback::Chassis::followTrajectory(const asset& path, int timeout, FollowTrajectoryParams params,
+                                                     bool async) {
+    const Path points(path);
+    if (!points.isValid()) {
+        lemlib::infoSink()->error("Path asset is not a compiled path! Use the _path asset. Skipping motion");
+        return Motion(*this);
+    }
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return Motion(*this);
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { followTrajectory(path, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return Motion(*this);
+    }
+
+    leftVelocity.reset();
+    rightVelocity.reset();
+
+    Trajectory trajectory(points);
+    const float direction = params.forwards ? 1 : -1;
+    const std::uint32_t startTime = pros::millis();
+    // the trajectory runs params.speed times faster than it was compiled, which scales every time in it
+    const float duration = trajectory.getDuration() / params.speed;
+    profileEnd = startTime + std::uint32_t(duration * 1000);
+
+    lemlib::Timer timer(timeout);
+    distTraveled = 0;
+    std::uint32_t now = startTime;
+    while (!timer.isDone() && this->motionRunning) {
+        const float time = (now - startTime) / 1000.0f;
+        const TrajectoryState reference = trajectory.sample(time * params.speed);
+        const TrajectoryState ahead = trajectory.sample((time + TRAJECTORY_LEAD) * params.speed);
+        lemlib::Pose pose = getPose(true);
+        // going backwards, the robot faces away from the path
+        if (!params.forwards) pose.theta += M_PI;
+
+        // error in the robot frame, forwards and to the left
+        const float dx = reference.x - pose.x;
+        const float dy = reference.y - pose.y;
+        const float errorForward = dx * std::sin(pose.theta) + dy * std::cos(pose.theta);
+        const float errorLeft = -dx * std::cos(pose.theta) + dy * std::sin(pose.theta);
+        // counterclockwise, as in the usual statement of RAMSETE
+        const float errorTheta = -lemlib::angleError(reference.theta, pose.theta);
+        distTraveled = reference.distance;
+
+        const float overtime = time - duration;
+        if (overtime >= 0 && (std::hypot(dx, dy) < TRAJECTORY_END_TOLERANCE || overtime >= TRAJECTORY_SETTLE_TIME)) {
+            break;
+        }
+
+        // RAMSETE, with the turn rate counterclockwise
+        const float v = ahead.velocity * params.speed;
+        const float w = -ahead.angularVelocity * params.speed;
+        const float acceleration = ahead.acceleration * params.speed * params.speed;
+        const float k = std::fmax(2 * params.zeta * std::sqrt(w * w + params.b * v * v), TRAJECTORY_MIN_GAIN);
+        const float sinc = std::fabs(errorTheta) < 1e-4f ? 1 : std::sin(errorTheta) / errorTheta;
+        const float velocity = v * std::cos(errorTheta) + k * errorForward;
+        const float angularVelocity = w + k * errorTheta + params.b * v * sinc * errorLeft;
+
+        // clockwise turn rate to wheel speeds. The turn is the same going backwards, because the heading was flipped
+        const float turn = -angularVelocity * drivetrain.trackWidth / 2;
+        const float accelTurn = acceleration * -w / std::fmax(std::fabs(v), 1.0f) * drivetrain.trackWidth / 2;
+        driveVelocity(direction * velocity + turn, direction * velocity - turn, direction * acceleration + accelTurn,
+                      direction * acceleration - accelTurn);
+
+        // run at the odometry rate
+        pros::Task::delay_until(&now, 10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    profileEnd = 0;
+    this->endMotion();
+    return Motion(*this);
+}
@@ -0,0 +1,100 @@
+#include "pushback/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "pros/misc.hpp"
+#include <algorithm>
+#include <cmath>
+
+// the robot steers towards a point this far ahead of it on the line to the target, in inches
+constexpr float STEER_LOOKAHEAD = 12;
+// once the profile is done, the motion ends when the robot is this close to the target, in inches
+constexpr float EXIT_RANGE = 1;
+
+pushback::Motion pushback::Chassis::moveToPointProfiled(float x, float y, int timeout,
+                                                        MoveToPointProfiledParams params, bool async) {
+    params.earlyExitRange = std::fabs(params.earlyExitRange);
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return Motion(*this);
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { moveToPointProfiled(x, y, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return Motion(*this);
+    }
+
+    // reset PIDs and exit conditions
+    resetLateral();
+    resetAngular();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+
+    // the profile runs along the line from where the robot starts to the target
+    const lemlib::Pose start = getPose(true);
+    const float dx = x - start.x;
+    const float dy = y - start.y;
+    const float length = std::hypot(dx, dy);
+    const float dirX = length > 0 ? dx / length : 0;
+    const float dirY = length > 0 ? dy / length : 0;
+    const float direction = params.forwards ? 1 : -1;
+
+    ProfileConstraints constraints = lateralConstraints;
+    constraints.maxVelocity *= std::clamp(params.maxSpeed, 0.0f, 127.0f) / 127;
+    const MotionProfile profile(direction * length, constraints);
+    const std::uint32_t startTime = pros::millis();
+    profileEnd = startTime + std::uint32_t(profile.getDuration() * 1000);
+
+    leftVelocity.reset();
+    rightVelocity.reset();
+
+    lemlib::Timer timer(timeout);
+    distTraveled = 0;
+    while (!timer.isDone() && this->motionRunning) {
+        const lemlib::Pose pose = getPose(true);
+        // distance traveled along the line, and how far the robot is from the target
+        const float along = (pose.x - start.x) * dirX + (pose.y - start.y) * dirY;
+        const float remaining = length - along;
+        distTraveled = std::fabs(along);
+
+        const float time = (pros::millis() - startTime) / 1000.0f;
+        const ProfileState state = profile.sample(time);
+        const bool profileDone = time >= profile.getDuration();
+
+        // exit once the profile is done and the robot is close to the target or has passed it, or the lateral
+        // controller has settled
+        if (profileDone && remaining < EXIT_RANGE) break;
+        if (profileDone && (lateralSmallExit.update(remaining) || lateralLargeExit.update(remaining))) break;
+        if (params.earlyExitRange > 0 && remaining < params.earlyExitRange) break;
+
+        // velocity from the profile, corrected by PID on the difference between the profile and the robot
+        const float velocity =
+            state.velocity + powerToSpeed(updateLateral(state.position - direction * along, remaining));
+
+        // steer towards a point ahead of the robot on the line, or the target once it is close
+        const float ahead = std::min(along + STEER_LOOKAHEAD, length);
+        const float aimX = start.x + dirX * std::max(ahead, along + 1);
+        const float aimY = start.y + dirY * std::max(ahead, along + 1);
+        float targetTheta = std::atan2(aimX - pose.x, aimY - pose.y);
+        if (!params.forwards) targetTheta += M_PI;
+        // don't chase the heading in the last few inches, the line to the target swings around
+        const float headingError = lemlib::radToDeg(lemlib::angleError(targetTheta, pose.theta, true));
+        const float angularPower = remaining > 3 ? updateAngular(headingError, headingError) : 0;
+        const float turn = powerToSpeed(angularPower);
+
+        driveVelocity(velocity + turn, velocity - turn, state.acceleration, state.acceleration);
+
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    profileEnd = 0;
+    this->endMotion();
+    return Motion(*this);
+}
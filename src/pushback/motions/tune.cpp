@@ -0,0 +1,77 @@
+#include "pushback/chassis.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "pros/rtos.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// time between samples of the response, in milliseconds. The same as the odometry rate
+constexpr std::uint32_t TUNE_PERIOD = 10;
+// samples recorded at rest before the step, so the fit sees the dead time
+constexpr int REST_SAMPLES = 10;
+
+pushback::TuneResult pushback::Chassis::tuneLateral(TuneParams params) {
+    const TuneResult result = tune(false, params);
+    lemlib::infoSink()->info("Lateral model: gain {} in/s per power, time constant {} s, dead time {} s",
+                             result.model.gain, result.model.timeConstant, result.model.deadTime);
+    lemlib::infoSink()->info("Suggested lateral kP {} kD {}: settles in {} s, {} in overshoot on {} in",
+                             result.settings.kP, result.settings.kD, result.settleTime, result.overshoot,
+                             result.target);
+    return result;
+}
+
+pushback::TuneResult pushback::Chassis::tuneAngular(TuneParams params) {
+    const TuneResult result = tune(true, params);
+    lemlib::infoSink()->info("Angular model: gain {} deg/s per power, time constant {} s, dead time {} s",
+                             result.model.gain, result.model.timeConstant, result.model.deadTime);
+    lemlib::infoSink()->info("Suggested angular kP {} kD {}: settles in {} s, {} deg overshoot on {} deg",
+                             result.settings.kP, result.settings.kD, result.settleTime, result.overshoot,
+                             result.target);
+    return result;
+}
+
+pushback::TuneResult pushback::Chassis::tune(bool angular, TuneParams params) {
+    const lemlib::ControllerSettings& current = angular ? angularSettings : lateralSettings;
+    const float target = params.target > 0 ? params.target : angular ? 90 : 24;
+    const float power = std::clamp(std::fabs(params.power), 1.0f, 127.0f);
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return suggestGains({}, current, params.closedLoopTime, target);
+
+    // step the motors from rest, and record how fast the robot moves along the axis
+    const lemlib::Pose start = getPose();
+    std::vector<float> powers;
+    std::vector<float> velocities;
+    float last = 0;
+    lemlib::Timer timer(params.timeout);
+    std::uint32_t now = pros::millis();
+    for (int sample = 0; this->motionRunning; sample++) {
+        const lemlib::Pose pose = getPose();
+        const float progress = angular ? pose.theta - start.theta
+                                       : (pose.x - start.x) * std::sin(lemlib::degToRad(start.theta)) +
+                                             (pose.y - start.y) * std::cos(lemlib::degToRad(start.theta));
+        if (sample > 0) velocities.push_back((progress - last) / (TUNE_PERIOD / 1000.0f));
+        last = progress;
+        if (timer.isDone() || (!angular && std::fabs(progress) >= params.maxDistance)) break;
+
+        const float output = sample < REST_SAMPLES ? 0 : power;
+        powers.push_back(output);
+        drivetrain.leftMotors->move(output);
+        drivetrain.rightMotors->move(angular ? -output : output);
+        distTraveled = std::fabs(progress);
+        pros::Task::delay_until(&now, TUNE_PERIOD);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+
+    const FopdtModel model = fitFopdt(powers, velocities, TUNE_PERIOD / 1000.0f);
+    if (model.gain <= 0) lemlib::infoSink()->error("Step response does not fit a model, keeping the current gains");
+    return suggestGains(model, current, params.closedLoopTime, target);
+}
@@ -0,0 +1,78 @@
+#include "pushback/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "pros/misc.hpp"
+#include <algorithm>
+#include <cmath>
+
+// once the profile is done, the motion ends when the robot is this close to the target heading, in degrees
+constexpr float EXIT_RANGE = 1;
+
+pushback::Motion pushback::Chassis::turnToHeadingProfiled(float theta, int timeout,
+                                                          TurnToHeadingProfiledParams params, bool async) {
+    params.earlyExitRange = std::fabs(params.earlyExitRange);
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return Motion(*this);
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([=, this]() { turnToHeadingProfiled(theta, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return Motion(*this);
+    }
+
+    // reset PIDs and exit conditions
+    resetAngular();
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+
+    // profile the shortest turn, in degrees
+    const float startTheta = getPose().theta;
+    const float turn = lemlib::angleError(theta, startTheta, false);
+    ProfileConstraints constraints = angularConstraints;
+    constraints.maxVelocity *= std::clamp(params.maxSpeed, 0.0f, 127.0f) / 127;
+    const MotionProfile profile(turn, constraints);
+    const std::uint32_t startTime = pros::millis();
+    profileEnd = startTime + std::uint32_t(profile.getDuration() * 1000);
+
+    leftVelocity.reset();
+    rightVelocity.reset();
+
+    lemlib::Timer timer(timeout);
+    distTraveled = 0;
+    while (!timer.isDone() && this->motionRunning) {
+        const float heading = getPose().theta;
+        const float turned = heading - startTheta;
+        const float error = lemlib::angleError(theta, heading, false);
+        distTraveled = std::fabs(turned);
+
+        const float time = (pros::millis() - startTime) / 1000.0f;
+        const ProfileState state = profile.sample(time);
+        const bool profileDone = time >= profile.getDuration();
+
+        // exit once the profile is done and the robot is close to the target heading or has turned past it, or the
+        // angular controller has settled
+        if (profileDone && (std::fabs(error) < EXIT_RANGE || error * turn < 0)) break;
+        if (profileDone && (angularSmallExit.update(error) || angularLargeExit.update(error))) break;
+        if (params.earlyExitRange > 0 && std::fabs(error) < params.earlyExitRange) break;
+
+        // the wheels travel along a circle with a diameter of the track width
+        const float toWheel = lemlib::degToRad(1) * drivetrain.trackWidth / 2;
+        const float velocity = state.velocity * toWheel + powerToSpeed(updateAngular(state.position - turned, error));
+        const float acceleration = state.acceleration * toWheel;
+
+        driveVelocity(velocity, -velocity, acceleration, -acceleration);
+
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    profileEnd = 0;
+    this->endMotion();
+    return Motion(*this);
+}
@@ -0,0 +1,40 @@
+#include "pushback/motorTelemetry.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "pros/motors.h"
+#include "pros/rtos.hpp"
+#include <vector>
+
+namespace pushback {
+MotorSampler::MotorSampler(const pros::MotorGroup& motors) {
+    const std::vector<std::int8_t> groupPorts = motors.get_port_all();
+    if (groupPorts.size() > MAX_SAMPLED_MOTORS) {
+        lemlib::infoSink()->error("MotorSampler can only sample {} motors, the group has {}", MAX_SAMPLED_MOTORS,
+                                  groupPorts.size());
+    }
+    for (const std::int8_t port : groupPorts) {
+        if (count == MAX_SAMPLED_MOTORS) break;
+        ports[count++] = port;
+    }
+}
+
+void MotorSampler::snapshot(MotorTelemetry& telemetry) const {
+    telemetry.count = count;
+    telemetry.time = pros::millis();
+    for (std::size_t i = 0; i < count; i++) {
+        // the C API takes reversed motors as negative ports, like the group does
+        const std::int8_t port = ports[i];
+        telemetry.position[i] = pros::c::motor_get_position(port);
+        telemetry.velocity[i] = pros::c::motor_get_actual_velocity(port);
+        telemetry.current[i] = pros::c::motor_get_current_draw(port);
+        telemetry.voltage[i] = pros::c::motor_get_voltage(port);
+        telemetry.temperature[i] = pros::c::motor_get_temperature(port);
+        telemetry.torque[i] = pros::c::motor_get_torque(port);
+        telemetry.efficiency[i] = pros::c::motor_get_efficiency(port);
+        telemetry.faults[i] = pros::c::motor_get_faults(port);
+    }
+}
+
+std::size_t MotorSampler::size() const { return count; }
+
+std::int8_t MotorSampler::getPort(std::size_t index) const { return ports[index]; }
+} // namespace pushback
@@ -0,0 +1,57 @@
+#include "pushback/odomCorrection.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/util.hpp"
+#include "pros/rtos.hpp"
+#include "pushback/periodicTask.hpp"
+#include <cmath>
+#include <mutex>
+
+namespace pushback {
+// odometry is updated every 10ms by lemlib
+constexpr std::uint32_t CORRECTION_PERIOD = 10;
+// one above lemlib's odom task, which runs at the default priority
+constexpr std::uint32_t CORRECTION_PRIORITY = TASK_PRIORITY_DEFAULT + 1;
+// a pose this far from where the queued corrections leave it, in inches, was set in the meantime. No robot moves
+// this far in one period
+constexpr float SET_DISTANCE = 6;
+
+/** sum of the corrections queued since the last write, theta in radians */
+static lemlib::Pose pending(0, 0, 0);
+/** pose the newest queued correction left odometry at, theta in radians */
+static lemlib::Pose target(0, 0, 0);
+static bool queued = false;
+/** held while reading or changing the queue, and while writing it to odometry */
+static pros::Mutex mutex;
+static PeriodicTask writer;
+
+/**
+ * Add the queued corrections to odometry
+ */
+static void write() {
+    std::lock_guard lock(mutex);
+    if (!queued) return;
+    queued = false;
+    const lemlib::Pose current = lemlib::getPose(true);
+    const lemlib::Pose corrected(current.x + pending.x, current.y + pending.y, current.theta + pending.theta);
+    pending = lemlib::Pose(0, 0, 0);
+    if (std::hypot(corrected.x - target.x, corrected.y - target.y) > SET_DISTANCE) return;
+    lemlib::setPose(corrected, true);
+}
+
+lemlib::Pose getCorrectedPose(bool radians) {
+    std::lock_guard lock(mutex);
+    const lemlib::Pose current = lemlib::getPose(true);
+    const float theta = current.theta + pending.theta;
+    return {current.x + pending.x, current.y + pending.y, radians ? theta : lemlib::radToDeg(theta)};
+}
+
+void shiftPose(const lemlib::Pose& measured, const lemlib::Pose& corrected) {
+    writer.start(CORRECTION_PERIOD, [](std::uint32_t) { write(); }, CORRECTION_PRIORITY);
+    std::lock_guard lock(mutex);
+    pending.x += corrected.x - measured.x;
+    pending.y += corrected.y - measured.y;
+    pending.theta += corrected.theta - measured.theta;
+    target = corrected;
+    queued = true;
+}
+} // namespace pushback
@@ -0,0 +1,51 @@
+#include "pushback/outputCache.hpp"
+#include "pros/rtos.hpp"
+
+namespace pushback {
+CachedMotor::CachedMotor(pros::AbstractMotor& motor)
+    : motor(motor) {}
+
+void CachedMotor::move(std::int32_t power) { request({MotorCommand::Type::POWER, power}); }
+
+void CachedMotor::moveVoltage(std::int32_t voltage) { request({MotorCommand::Type::VOLTAGE, voltage}); }
+
+void CachedMotor::write(const MotorCommand& command) {
+    if (command.type == MotorCommand::Type::POWER) motor.move(command.value);
+    else motor.move_voltage(command.value);
+}
+
+std::uint32_t CachedMotor::ports() const { return motor.size(); }
+
+CachedDigitalOut::CachedDigitalOut(pros::adi::DigitalOut& output)
+    : output(output) {}
+
+void CachedDigitalOut::setValue(bool value) { request(value); }
+
+void CachedDigitalOut::write(const bool& value) { output.set_value(value); }
+
+std::uint32_t CachedDigitalOut::ports() const { return 1; }
+
+OutputBatch::OutputBatch(std::initializer_list<Output*> outputs)
+    : outputs(outputs) {}
+
+void OutputBatch::flush() {
+    const std::uint32_t time = pros::millis();
+    for (Output* output : outputs) output->flush(time);
+}
+
+void OutputBatch::invalidate() {
+    for (Output* output : outputs) output->invalidate();
+}
+
+std::uint32_t OutputBatch::getWrites() const {
+    std::uint32_t total = 0;
+    for (const Output* output : outputs) total += output->getWrites();
+    return total;
+}
+
+std::uint32_t OutputBatch::getRequestedWrites() const {
+    std::uint32_t total = 0;
+    for (const Output* output : outputs) total += output->getRequestedWrites();
+    return total;
+}
+} // namespace pushback
@@ -0,0 +1,246 @@
+#include "pushback/particleFilter.hpp"
+#include "lemlib/util.hpp"
+#include "pushback/odomCorrection.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace pushback {
+constexpr std::uint32_t UPDATE_PERIOD = 20;
+// distance sensors refresh roughly every 33ms, so particles are only scored every other update
+constexpr std::uint32_t WEIGH_PERIOD = 40;
+// an odometry jump bigger than this in a single update means the pose was set by the user
+constexpr float RESET_DISTANCE = 12;
+constexpr float RESET_ANGLE = M_PI / 6;
+// spread of the particles around the starting pose, in inches and degrees
+constexpr float START_RADIUS = 2;
+constexpr float START_ANGLE = 2;
+// particles can not be closer to the perimeter than half the width of the robot, in inches
+constexpr float ROBOT_HALF_WIDTH = 7;
+// below this power of two the exponential is a denormal, and the outlier probability dominates the weight anyway
+constexpr float MIN_EXPONENT = -126;
+
+/**
+ * @brief e^x for x <= 0, to a relative error of 1e-5
+ *
+ * std::exp is a library call per particle, which keeps the scoring loop from being vectorized on the host and costs
+ * far more than the ray cast on the brain. This splits x into a power of two, written straight into the exponent
+ * bits, and a fraction in (-1, 0] for a polynomial fitted at the Chebyshev nodes. Truncation rounds toward zero, so
+ * the fraction is never positive and no floor is needed
+ */
+static float expNegative(float x) {
+    const float exponent = std::max(x * static_cast<float>(M_LOG2E), MIN_EXPONENT);
+    const std::int32_t whole = static_cast<std::int32_t>(exponent);
+    const float f = exponent - whole;
+    const float fraction =
+        0.99999804f + f * (0.69304893f + f * (0.23943060f + f * (0.053213118f + f * 0.0068351547f)));
+    return fraction * std::bit_cast<float>((whole + 127) << 23);
+}
+
+ParticleFilter::ParticleFilter(ParticleFilterSettings settings, std::vector<DistanceMount> distanceSensors)
+    : settings(settings),
+      distanceSensors(std::move(distanceSensors)),
+      x(settings.particles),
+      y(settings.particles),
+      theta(settings.particles),
+      weight(settings.particles),
+      sinTheta(settings.particles),
+      cosTheta(settings.particles),
+      nextX(settings.particles),
+      nextY(settings.particles),
+      nextTheta(settings.particles),
+      published({{0, 0, 0}, 0}) {}
+
+void ParticleFilter::start() {
+    task.start(UPDATE_PERIOD, [this](std::uint32_t) { update(); });
+}
+
+void ParticleFilter::scatter(float radius, float angle) {
+    scatterAngle = angle;
+    scatterRadius = radius;
+}
+
+void ParticleFilter::update() {
+    const lemlib::Pose odom = getCorrectedPose(true);
+    const float dx = odom.x - lastOdom.x;
+    const float dy = odom.y - lastOdom.y;
+    const float turn = odom.theta - lastOdom.theta;
+    if (!initialized || std::hypot(dx, dy) > RESET_DISTANCE || std::fabs(turn) > RESET_ANGLE) {
+        reset(toField(settings.origin, odom), START_RADIUS, START_ANGLE);
+        lastOdom = odom;
+        return;
+    }
+    if (const float radius = scatterRadius.exchange(0); radius > 0) reset(fieldPose, radius, scatterAngle);
+
+    // motion in the robot frame, measured at the midpoint heading
+    const float heading = lastOdom.theta + turn / 2;
+    const float forward = dx * std::sin(heading) + dy * std::cos(heading);
+    const float lateral = dx * std::cos(heading) - dy * std::sin(heading);
+    predict(forward, lateral, turn);
+    lastOdom = odom;
+
+    if (++ticks % (WEIGH_PERIOD / UPDATE_PERIOD) != 0) return;
+    if (!weigh()) return;
+    estimate();
+    resample();
+
+    // only correct odometry once the particles agree on where the robot is
+    const lemlib::Pose odomField = toField(settings.origin, odom);
+    const float error = std::hypot(fieldPose.x - odomField.x, fieldPose.y - odomField.y);
+    if (spread > settings.maxSpread || error < settings.minCorrection) return;
+    const lemlib::Pose corrected = toOdom(settings.origin, lemlib::Pose(fieldPose.x, fieldPose.y, odomField.theta));
+    shiftPose(odom, corrected);
+    lastOdom = corrected;
+}
+
+void ParticleFilter::reset(const lemlib::Pose& center, float radius, float angle) {
+    const float angleRad = lemlib::degToRad(angle);
+    for (std::size_t i = 0; i < settings.particles; i++) {
+        // uniform over a disk
+        const float r = radius * std::sqrt(uniform());
+        const float a = 2 * M_PI * uniform();
+        x[i] = center.x + r * std::sin(a);
+        y[i] = center.y + r * std::cos(a);
+        theta[i] = center.theta + angleRad * (2 * uniform() - 1);
+        weight[i] = 1.0f / settings.particles;
+    }
+    fieldPose = center;
+    spread = radius;
+    initialized = true;
+    published.store({fieldPose, spread});
+}
+
+void ParticleFilter::predict(float forward, float lateral, float turn) {
+    const float limit = settings.fieldHalfWidth - ROBOT_HALF_WIDTH;
+    const float travel = std::hypot(forward, lateral);
+    for (std::size_t i = 0; i < settings.particles; i++) {
+        const float f = forward + gaussian() * settings.travelNoise * travel;
+        const float l = lateral + gaussian() * settings.travelNoise * travel;
+        const float t = theta[i] + turn / 2;
+        x[i] = std::clamp(x[i] + f * std::sin(t) + l * std::cos(t), -limit, limit);
+        y[i] = std::clamp(y[i] + f * std::cos(t) - l * std::sin(t), -limit, limit);
+        theta[i] += turn + gaussian() * settings.turnNoise * std::fabs(turn);
+    }
+}
+
+bool ParticleFilter::weigh() {
+    const std::size_t n = settings.particles;
+    const float halfWidth = settings.fieldHalfWidth;
+    for (std::size_t i = 0; i < n; i++) {
+        sinTheta[i] = std::sin(theta[i]);
+        cosTheta[i] = std::cos(theta[i]);
+    }
+
+    bool weighed = false;
+    for (const DistanceMount& mount : distanceSensors) {
+        if (mount.sensor->get_confidence() < settings.minConfidence) continue;
+        const float measured = mount.sensor->get_distance() / 25.4f;
+        if (measured <= 0 || measured > settings.maxDistance) continue;
+        weighed = true;
+
+        const float noise = std::max(settings.distanceNoise, settings.distanceNoiseRatio * measured);
+        const float k = -0.5f / (noise * noise);
+        const float outlier = settings.outlierProbability;
+        const float sinMount = std::sin(lemlib::degToRad(mount.heading));
+        const float cosMount = std::cos(lemlib::degToRad(mount.heading));
+        const float* px = x.data();
+        const float* py = y.data();
+        const float* s = sinTheta.data();
+        const float* c = cosTheta.data();
+        float* w = weight.data();
+        // branch free so the compiler can vectorize it. A ray parallel to a wall divides by zero, giving an
+        // infinite distance to that wall, which fminf then ignores
+        for (std::size_t i = 0; i < n; i++) {
+            const float sensorX = px[i] + mount.x * c[i] + mount.y * s[i];
+            const float sensorY = py[i] - mount.x * s[i] + mount.y * c[i];
+            const float rayX = s[i] * cosMount + c[i] * sinMount;
+            const float rayY = c[i] * cosMount - s[i] * sinMount;
+            const float toX = (std::copysign(halfWidth, rayX) - sensorX) / rayX;
+            const float toY = (std::copysign(halfWidth, rayY) - sensorY) / rayY;
+            const float error = measured - std::fmin(toX, toY);
+            w[i] *= expNegative(k * error * error) + outlier;
+        }
+    }
+    if (!weighed) return false;
+
+    float total = 0;
+    for (std::size_t i = 0; i < n; i++) total += weight[i];
+    if (!(total > 0)) {
+        // every particle disagrees with the sensors, keep the cloud and try again next time
+        std::fill(weight.begin(), weight.end(), 1.0f / n);
+        return false;
+    }
+    for (std::size_t i = 0; i < n; i++) weight[i] /= total;
+    return true;
+}
+
+void ParticleFilter::resample() {
+    const std::size_t n = settings.particles;
+    float sumSquares = 0;
+    for (std::size_t i = 0; i < n; i++) sumSquares += weight[i] * weight[i];
+    // only resample once the effective number of particles drops below half
+    if (1 / sumSquares > n / 2.0f) return;
+
+    // systematic resampling, one random offset for all particles
+    const float step = 1.0f / n;
+    float target = uniform() * step;
+    float cumulative = weight[0];
+    std::size_t source = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        while (target > cumulative && source < n - 1) cumulative += weight[++source];
+        nextX[i] = x[source];
+        nextY[i] = y[source];
+        nextTheta[i] = theta[source];
+        target += step;
+    }
+    x.swap(nextX);
+    y.swap(nextY);
+    theta.swap(nextTheta);
+    std::fill(weight.begin(), weight.end(), step);
+}
+
+void ParticleFilter::estimate() {
+    float meanX = 0;
+    float meanY = 0;
+    float meanSin = 0;
+    float meanCos = 0;
+    for (std::size_t i = 0; i < settings.particles; i++) {
+        meanX += weight[i] * x[i];
+        meanY += weight[i] * y[i];
+        meanSin += weight[i] * sinTheta[i];
+        meanCos += weight[i] * cosTheta[i];
+    }
+    float variance = 0;
+    for (std::size_t i = 0; i < settings.particles; i++) {
+        variance += weight[i] * ((x[i] - meanX) * (x[i] - meanX) + (y[i] - meanY) * (y[i] - meanY));
+    }
+    // keep the heading continuous with odometry instead of wrapping it to [-pi, pi]
+    const float meanTheta = std::atan2(meanSin, meanCos);
+    const float reference = fieldPose.theta;
+    fieldPose = lemlib::Pose(meanX, meanY, reference + lemlib::angleError(meanTheta, reference));
+    spread = std::sqrt(variance);
+    published.store({fieldPose, spread});
+}
+
+lemlib::Pose ParticleFilter::getFieldPose(bool radians) const {
+    const lemlib::Pose pose = published.load().pose;
+    return {pose.x, pose.y, radians ? pose.theta : lemlib::radToDeg(pose.theta)};
+}
+
+float ParticleFilter::getSpread() const { return published.load().spread; }
+
+float ParticleFilter::uniform() {
+    // xorshift32, plenty for sampling noise and much cheaper than std::mt19937
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (seed >> 8) * (1.0f / 16777216.0f);
+}
+
+float ParticleFilter::gaussian() {
+    // Irwin-Hall approximation, the sum of uniforms avoids the log and sqrt of Box-Muller
+    float sum = 0;
+    for (int i = 0; i < 4; i++) sum += uniform();
+    return (sum - 2) * std::sqrt(3.0f);
+}
+} // namespace pushback
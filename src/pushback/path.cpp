@@ -0,0 +1,27 @@
+#include "pushback/path.hpp"
+
+namespace pushback {
+Path::Path(const asset& path) {
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(path.buf);
+    // the build aligns path assets, a misaligned buffer is not one of them
+    if (path.size < sizeof(PathHeader) || address % alignof(PathHeader) != 0) return;
+    const PathHeader* header = reinterpret_cast<const PathHeader*>(path.buf);
+    if (header->magic != PATH_MAGIC || header->count < 2) return;
+    if (path.size < sizeof(PathHeader) + header->count * sizeof(PathPoint)) return;
+    points = reinterpret_cast<const PathPoint*>(path.buf + sizeof(PathHeader));
+    count = header->count;
+    length = header->length;
+}
+
+bool Path::isValid() const { return count > 0; }
+
+std::size_t Path::size() const { return count; }
+
+float Path::getLength() const { return length; }
+
+const PathPoint& Path::operator[](std::size_t index) const { return points[index]; }
+
+const PathPoint* Path::begin() const { return points; }
+
+const PathPoint* Path::end() const { return points + count; }
+} // namespace pushback
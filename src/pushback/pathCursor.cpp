@@ -0,0 +1,167 @@
+#include "pushback/pathCursor.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pushback {
+PathCursor::PathCursor(const Path& path, float gridCellSize)
+    : path(path),
+      cellSize(gridCellSize) {
+    if (cellSize <= 0) return;
+    float maxX = path[0].x;
+    float maxY = path[0].y;
+    minX = maxX;
+    minY = maxY;
+    for (const PathPoint& point : path) {
+        minX = std::min(minX, point.x);
+        minY = std::min(minY, point.y);
+        maxX = std::max(maxX, point.x);
+        maxY = std::max(maxY, point.y);
+    }
+    columns = std::size_t((maxX - minX) / cellSize) + 1;
+    rows = std::size_t((maxY - minY) / cellSize) + 1;
+
+    // counting pass, then fill, so every segment of a cell is contiguous
+    const auto forEachCell = [&](std::size_t i, auto&& function) {
+        const std::size_t x0 = std::size_t((std::min(path[i].x, path[i + 1].x) - minX) / cellSize);
+        const std::size_t x1 = std::size_t((std::max(path[i].x, path[i + 1].x) - minX) / cellSize);
+        const std::size_t y0 = std::size_t((std::min(path[i].y, path[i + 1].y) - minY) / cellSize);
+        const std::size_t y1 = std::size_t((std::max(path[i].y, path[i + 1].y) - minY) / cellSize);
+        for (std::size_t row = y0; row <= y1; row++) {
+            for (std::size_t column = x0; column <= x1; column++) function(row * columns + column);
+        }
+    };
+    cellStart.assign(columns * rows + 1, 0);
+    for (std::size_t i = 0; i + 1 < path.size(); i++) forEachCell(i, [&](std::size_t cell) { cellStart[cell + 1]++; });
+    for (std::size_t cell = 0; cell < columns * rows; cell++) cellStart[cell + 1] += cellStart[cell];
+    cellSegments.resize(cellStart.back());
+    std::vector<std::uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (std::size_t i = 0; i + 1 < path.size(); i++) {
+        forEachCell(i, [&](std::size_t cell) { cellSegments[fill[cell]++] = i; });
+    }
+}
+
+float PathCursor::segmentDistance(std::size_t index, float x, float y, float& t) const {
+    const PathPoint& start = path[index];
+    const PathPoint& end = path[index + 1];
+    const float dx = end.x - start.x;
+    const float dy = end.y - start.y;
+    const float lengthSquared = dx * dx + dy * dy;
+    t = lengthSquared > 0 ? std::clamp(((x - start.x) * dx + (y - start.y) * dy) / lengthSquared, 0.0f, 1.0f) : 0;
+    return std::hypot(start.x + t * dx - x, start.y + t * dy - y);
+}
+
+void PathCursor::update(float x, float y) {
+    const std::size_t last = path.size() - 2;
+    const std::size_t previous = segment;
+    float t = 0;
+    float distance = segmentDistance(segment, x, y, t);
+    // walk forward while the next segment is at least as close, which also steps over repeated points
+    while (segment < last) {
+        float nextT = 0;
+        const float next = segmentDistance(segment + 1, x, y, nextT);
+        if (next > distance) break;
+        segment++;
+        distance = next;
+        t = nextT;
+    }
+    // keep the cursor monotone within a segment too
+    fraction = segment == previous ? std::max(fraction, t) : t;
+    offset = distance;
+
+    if (cellSize > 0 && offset > cellSize && reacquire(x, y)) reacquisitions++;
+    lookaheadSegment = std::max(lookaheadSegment, segment);
+}
+
+bool PathCursor::reacquire(float x, float y) {
+    const std::size_t center = cellIndex(x, y);
+    const std::size_t row = center / columns;
+    const std::size_t column = center % columns;
+    float best = offset;
+    std::size_t bestSegment = segment;
+    float bestFraction = fraction;
+    for (std::size_t r = row > 0 ? row - 1 : 0; r <= std::min(row + 1, rows - 1); r++) {
+        for (std::size_t c = column > 0 ? column - 1 : 0; c <= std::min(column + 1, columns - 1); c++) {
+            const std::size_t cell = r * columns + c;
+            for (std::uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                const std::size_t candidate = cellSegments[i];
+                if (candidate < segment) continue;
+                float t = 0;
+                const float distance = segmentDistance(candidate, x, y, t);
+                if (distance < best) {
+                    best = distance;
+                    bestSegment = candidate;
+                    bestFraction = t;
+                }
+            }
+        }
+    }
+    if (bestSegment == segment) return false;
+    segment = bestSegment;
+    fraction = bestFraction;
+    offset = best;
+    return true;
+}
+
+std::size_t PathCursor::cellIndex(float x, float y) const {
+    const float column = std::clamp((x - minX) / cellSize, 0.0f, float(columns - 1));
+    const float row = std::clamp((y - minY) / cellSize, 0.0f, float(rows - 1));
+    return std::size_t(row) * columns + std::size_t(column);
+}
+
+PathPoint PathCursor::lookahead(float x, float y, float radius) {
+    const std::size_t last = path.size() - 1;
+    // skip the points inside the circle, the crossing is on the first segment that leaves it
+    while (lookaheadSegment + 1 < last &&
+           std::hypot(path[lookaheadSegment + 1].x - x, path[lookaheadSegment + 1].y - y) < radius) {
+        lookaheadSegment++;
+    }
+    const PathPoint& start = path[lookaheadSegment];
+    const PathPoint& end = path[lookaheadSegment + 1];
+    const float dx = end.x - start.x;
+    const float dy = end.y - start.y;
+    const float fx = start.x - x;
+    const float fy = start.y - y;
+    const float a = dx * dx + dy * dy;
+    const float b = 2 * (fx * dx + fy * dy);
+    const float c = fx * fx + fy * fy - radius * radius;
+    const float discriminant = b * b - 4 * a * c;
+    if (a > 0 && discriminant >= 0) {
+        // the furthest crossing along the segment
+        const float t = (-b + std::sqrt(discriminant)) / (2 * a);
+        if (t >= 0 && t <= 1) return sample(start.distance + t * (end.distance - start.distance));
+    }
+    // the end of the path is inside the circle, or the robot is too far off the path for it to cross
+    if (std::hypot(path[last].x - x, path[last].y - y) < radius) return path[last];
+    return sample(getDistance() + radius);
+}
+
+PathPoint PathCursor::sample(float distance) const {
+    const float s = std::clamp(distance, 0.0f, path.getLength());
+    // the first point at or past s, searched from the cursor since samples are almost always ahead of it
+    std::size_t i = segment + 1;
+    if (path[segment].distance > s) {
+        i = std::upper_bound(path.begin(), path.begin() + segment + 1, s,
+                             [](float value, const PathPoint& point) { return value < point.distance; }) -
+            path.begin();
+    }
+    while (i < path.size() - 1 && path[i].distance < s) i++;
+    i = std::max<std::size_t>(i, 1);
+    const PathPoint& start = path[i - 1];
+    const PathPoint& end = path[i];
+    const float length = end.distance - start.distance;
+    const float t = length > 0 ? (s - start.distance) / length : 0;
+    const auto lerp = [t](float a, float b) { return a + t * (b - a); };
+    return {lerp(start.x, end.x),           lerp(start.y, end.y),
+            lerp(start.speed, end.speed),   s,
+            lerp(start.curvature, end.curvature), lerp(start.velocity, end.velocity)};
+}
+
+float PathCursor::getDistance() const {
+    const PathPoint& start = path[segment];
+    return start.distance + fraction * (path[segment + 1].distance - start.distance);
+}
+
+float PathCursor::getOffset() const { return offset; }
+
+std::uint32_t PathCursor::getReacquisitions() const { return reacquisitions; }
+} // namespace pushback
@@ -0,0 +1,19 @@
+#include "pushback/periodicTask.hpp"
+#include "pros/rtos.hpp"
+
+namespace pushback {
+bool PeriodicTask::start(std::uint32_t period, std::function<void(std::uint32_t time)> function,
+                         std::uint32_t priority) {
+    if (started.exchange(true)) return false;
+    pros::Task task(
+        [period, function = std::move(function)] {
+            std::uint32_t now = pros::millis();
+            while (true) {
+                function(now);
+                pros::Task::delay_until(&now, period);
+            }
+        },
+        priority);
+    return true;
+}
+} // namespace pushback
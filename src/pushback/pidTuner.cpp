@@ -0,0 +1,91 @@
+#include "pushback/pidTuner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pushback {
+// lemlib motions update their PIDs every 10ms, and the derivative is taken per update, not per second
+constexpr float PID_PERIOD = 0.01;
+// step of the closed loop prediction, in seconds
+constexpr float PREDICTION_STEP = 0.001;
+// longest time the prediction runs for, in seconds
+constexpr float PREDICTION_TIME = 5;
+
+FopdtModel fitFopdt(const std::vector<float>& power, const std::vector<float>& velocity, float period,
+                    float maxDeadTime) {
+    const std::size_t samples = std::min(power.size(), velocity.size());
+    const std::size_t maxDelay = std::lround(maxDeadTime / period);
+    FopdtModel best;
+    float bestError = std::numeric_limits<float>::infinity();
+    for (std::size_t delay = 0; delay <= maxDelay && delay + 2 < samples; delay++) {
+        // normal equations of v[k] = a * v[k - 1] + b * u[k - delay]. A velocity is measured over the same period
+        // as the power of its sample, so with no dead time the power acts on the velocity of the same sample
+        const std::size_t first = std::max<std::size_t>(delay, 1);
+        double vv = 0, vu = 0, uu = 0, vn = 0, un = 0;
+        for (std::size_t k = first; k < samples; k++) {
+            const double v = velocity[k - 1], u = power[k - delay], next = velocity[k];
+            vv += v * v;
+            vu += v * u;
+            uu += u * u;
+            vn += v * next;
+            un += u * next;
+        }
+        const double determinant = vv * uu - vu * vu;
+        if (std::fabs(determinant) < 1e-9) continue;
+        const double a = (vn * uu - un * vu) / determinant;
+        const double b = (un * vv - vn * vu) / determinant;
+        // the response has to decay towards a steady state in the direction of the power
+        if (a <= 0 || a >= 1 || b <= 0) continue;
+
+        double squared = 0;
+        for (std::size_t k = first; k < samples; k++) {
+            const double residual = velocity[k] - a * velocity[k - 1] - b * power[k - delay];
+            squared += residual * residual;
+        }
+        const float error = std::sqrt(squared / (samples - first));
+        if (error < bestError) {
+            bestError = error;
+            best = {float(b / (1 - a)), float(-period / std::log(a)), delay * period, error};
+        }
+    }
+    return best;
+}
+
+TuneResult suggestGains(const FopdtModel& model, const lemlib::ControllerSettings& current, float closedLoopTime,
+                        float target) {
+    TuneResult result {model, current, target, 0, 0};
+    if (model.gain <= 0 || model.timeConstant <= 0) return result;
+    if (closedLoopTime <= 0) closedLoopTime = std::max(model.deadTime, model.timeConstant / 2);
+
+    // SIMC for an integrating process with a lag, in the parallel form lemlib uses
+    const float kP = 1 / (model.gain * (closedLoopTime + model.deadTime));
+    result.settings.kP = kP;
+    result.settings.kI = 0;
+    result.settings.kD = kP * model.timeConstant / PID_PERIOD;
+
+    // run the model against the suggested controller, with the output held between updates like a lemlib motion
+    const int delaySteps = std::lround(model.deadTime / PREDICTION_STEP);
+    const int pidSteps = std::lround(PID_PERIOD / PREDICTION_STEP);
+    std::vector<float> pending(delaySteps + 1, 0);
+    const float tolerance = current.smallError > 0 ? current.smallError : 1;
+    float position = 0, velocity = 0, output = 0, lastError = target;
+    float settled = 0;
+    for (int step = 0; step * PREDICTION_STEP < PREDICTION_TIME; step++) {
+        const float time = step * PREDICTION_STEP;
+        if (step % pidSteps == 0) {
+            const float error = target - position;
+            output = std::clamp(result.settings.kP * error + result.settings.kD * (error - lastError), -127.0f,
+                                127.0f);
+            lastError = error;
+        }
+        pending[step % pending.size()] = output;
+        const float applied = pending[(step + 1) % pending.size()];
+        velocity += PREDICTION_STEP * (model.gain * applied - velocity) / model.timeConstant;
+        position += PREDICTION_STEP * velocity;
+        result.overshoot = std::max(result.overshoot, position - target);
+        if (std::fabs(target - position) > tolerance) settled = time + PREDICTION_STEP;
+    }
+    result.settleTime = settled;
+    return result;
+}
+} // namespace pushback
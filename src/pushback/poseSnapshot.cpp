@@ -0,0 +1,21 @@
+#include "pushback/poseSnapshot.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "pros/rtos.hpp"
+#include "pushback/periodicTask.hpp"
+#include "pushback/seqlock.hpp"
+
+namespace pushback {
+// odometry is updated every 10ms by lemlib
+constexpr std::uint32_t PUBLISH_PERIOD = 10;
+
+static SeqLock<PoseSnapshot> snapshot({{0, 0, 0}, {0, 0, 0}, 0});
+static PeriodicTask publisher;
+
+void startPosePublisher() {
+    publisher.start(PUBLISH_PERIOD, [](std::uint32_t) {
+        snapshot.store({lemlib::getPose(), lemlib::getSpeed(), pros::millis()});
+    });
+}
+
+PoseSnapshot getPoseSnapshot() { return snapshot.load(); }
+} // namespace pushback
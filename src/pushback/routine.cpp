@@ -0,0 +1,142 @@
+#include "pushback/routine.hpp"
+#include <algorithm>
+
+namespace pushback {
+Routine::Routine(Handle handle)
+    : handle(handle) {}
+
+Routine::Routine(Routine&& other) noexcept
+    : handle(std::exchange(other.handle, nullptr)) {}
+
+Routine& Routine::operator=(Routine&& other) noexcept {
+    if (this != &other) {
+        Routine old(std::move(*this));
+        handle = std::exchange(other.handle, nullptr);
+    }
+    return *this;
+}
+
+Routine::~Routine() {
+    if (!handle) return;
+    // a routine destroyed while waiting must never be resumed. Routines it was waiting for live in its frame, and
+    // cancel themselves as it is destroyed
+    RoutineScheduler* scheduler = handle.promise().scheduler;
+    if (!handle.done() && scheduler != nullptr) scheduler->cancel(handle);
+    handle.destroy();
+}
+
+bool Routine::isDone() const { return !handle || handle.done(); }
+
+void Routine::start(RoutineScheduler* scheduler) {
+    if (!handle || handle.done()) return;
+    handle.promise().scheduler = scheduler;
+    handle.resume();
+}
+
+RoutineScheduler::RoutineScheduler(std::uint32_t period)
+    : period(period) {}
+
+void RoutineScheduler::run(Routine routine) {
+    routine.start(this);
+    std::uint32_t now = pros::millis();
+    while (!routine.isDone()) {
+        pros::Task::delay_until(&now, period);
+        update();
+    }
+}
+
+void RoutineScheduler::wait(std::coroutine_handle<> handle, std::function<bool()> condition) {
+    waiting.push_back({handle, std::move(condition)});
+}
+
+void RoutineScheduler::cancel(std::coroutine_handle<> handle) {
+    std::erase_if(waiting, [&](const Waiter& waiter) { return waiter.handle == handle; });
+}
+
+void RoutineScheduler::update() {
+    // resuming a routine can add and cancel waiters, so the list is indexed again after every resume. A waiter that
+    // moves before the index is checked again next period
+    for (std::size_t i = 0; i < waiting.size();) {
+        if (!waiting[i].condition()) {
+            i++;
+            continue;
+        }
+        const std::coroutine_handle<> handle = waiting[i].handle;
+        waiting.erase(waiting.begin() + i);
+        handle.resume();
+    }
+}
+
+Condition::Condition(std::function<bool()> condition, std::uint32_t timeout)
+    : condition(std::move(condition)),
+      timeout(timeout) {}
+
+bool Condition::await_ready() {
+    start = pros::millis();
+    met = condition();
+    return met || timeout == 0;
+}
+
+void Condition::await_suspend(Routine::Handle awaiting) {
+    awaiting.promise().scheduler->wait(awaiting, [this] {
+        met = condition();
+        return met || pros::millis() - start >= timeout;
+    });
+}
+
+Motion::Motion(lemlib::Chassis& chassis)
+    : chassis(chassis) {}
+
+Motion::~Motion() {
+    // the routine waiting for the motion was cancelled
+    if (waiting && chassis.isInMotion()) chassis.cancelMotion();
+}
+
+bool Motion::await_ready() const { return !chassis.isInMotion(); }
+
+void Motion::await_suspend(Routine::Handle awaiting) {
+    waiting = true;
+    awaiting.promise().scheduler->wait(awaiting, [this] { return !chassis.isInMotion(); });
+}
+
+Group::Group(std::vector<Routine> routines, bool waitForAll)
+    : routines(std::move(routines)),
+      waitForAll(waitForAll) {}
+
+bool Group::await_ready() const { return routines.empty(); }
+
+bool Group::await_suspend(Routine::Handle awaiting) {
+    RoutineScheduler* scheduler = awaiting.promise().scheduler;
+    for (Routine& routine : routines) {
+        routine.start(scheduler);
+        // any() is done as soon as one finishes, so the rest do not need to start
+        if (!waitForAll && routine.isDone()) break;
+    }
+    if (isDone()) return false;
+    scheduler->wait(awaiting, [this] { return isDone(); });
+    return true;
+}
+
+void Group::await_resume() {
+    // cancel the routines any() did not wait for
+    routines.clear();
+}
+
+bool Group::isDone() const {
+    if (waitForAll) return std::all_of(routines.begin(), routines.end(), [](const Routine& r) { return r.isDone(); });
+    return std::any_of(routines.begin(), routines.end(), [](const Routine& r) { return r.isDone(); });
+}
+
+Condition waitUntil(std::function<bool()> condition, std::uint32_t timeout) {
+    return Condition(std::move(condition), timeout);
+}
+
+Condition wait(std::uint32_t time) {
+    return Condition([] { return false; }, time);
+}
+
+void runRoutine(Routine routine, std::uint32_t period) {
+    RoutineScheduler scheduler(period);
+    scheduler.run(std::move(routine));
+}
+} // namespace pushback
@@ -0,0 +1,26 @@
+#include "pushback/serialOutput.hpp"
+#include <mutex>
+
+namespace pushback {
+SerialOutput::SerialOutput(std::function<void(const std::uint8_t* data, std::size_t size)> output,
+                           std::uint32_t period)
+    : output(std::move(output)),
+      period(period) {}
+
+void SerialOutput::start() {
+    task.start(period, [this](std::uint32_t) { drain(); });
+}
+
+bool SerialOutput::write(const std::uint8_t* data, std::size_t size) {
+    std::lock_guard lock(mutex);
+    return ring.write(data, size);
+}
+
+void SerialOutput::drain() {
+    ring.drain([this](const std::uint8_t* data, std::size_t size) {
+        if (output) output(data, size);
+    });
+}
+
+std::uint32_t SerialOutput::getDropped() const { return ring.getDroppedWrites(); }
+} // namespace pushback
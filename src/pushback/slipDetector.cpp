@@ -0,0 +1,172 @@
+#include "pushback/slipDetector.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/util.hpp"
+#include "pros/rtos.hpp"
+#include "pushback/odomCorrection.hpp"
+#include <cmath>
+
+namespace pushback {
+// standard gravity, in inches per second squared
+constexpr float GRAVITY = 386.09;
+// odometry is updated every 10ms by lemlib
+constexpr std::uint32_t SLIP_PERIOD = 10;
+// weight of each new sample in the acceleration filters. Odometry speed is a difference of positions sampled out of
+// phase with this task, so single samples are too noisy to compare
+constexpr float ACCELERATION_FILTER = 0.3;
+// weight of each new sample in the gravity estimate, while the robot is still
+constexpr float GRAVITY_FILTER = 0.02;
+// the robot counts as still below these wheel speeds, in inches per second, and turn rates, in degrees per second
+constexpr float STILL_SPEED = 1;
+constexpr float STILL_TURN = 2;
+// how long the robot must be still before gravity is learned, in milliseconds. The wheels also pass through zero
+// when the robot reverses, while it accelerates hard
+constexpr std::uint32_t STILL_TIME = 100;
+// time constant of the pull of the integrated IMU speed towards the wheel speed while the wheels grip, in seconds.
+// Long enough that a wheel spinning up against a goal is caught before the speed catches up with it
+constexpr float SPEED_TIME_CONSTANT = 0.5;
+
+SlipDetector::SlipDetector(pros::Imu& imu, const lemlib::Drivetrain& drivetrain, SlipSettings settings)
+    : imu(imu),
+      drivetrain(drivetrain),
+      settings(settings),
+      leftSampler(*drivetrain.leftMotors),
+      rightSampler(*drivetrain.rightMotors) {}
+
+void SlipDetector::start() {
+    task.start(SLIP_PERIOD, [this](std::uint32_t) { update(); });
+}
+
+bool SlipDetector::isActive(SlipEvent::Type type) const {
+    return type == SlipEvent::Type::IMPACT ? impact.active.load() : spin.active.load();
+}
+
+bool SlipDetector::poll(SlipEvent& event) { return events.pop(event); }
+
+std::uint32_t SlipDetector::getImpacts() const { return impacts; }
+
+float SlipDetector::wheelSpeed(const MotorSampler& sampler, const pros::MotorGroup& motors) {
+    // velocities are reported at the output of the cartridge
+    float cartridge = 0;
+    switch (motors.get_gearing()) {
+        case pros::MotorGears::red: cartridge = 100; break;
+        case pros::MotorGears::green: cartridge = 200; break;
+        case pros::MotorGears::blue: cartridge = 600; break;
+        default: return 0;
+    }
+    sampler.snapshot(telemetry);
+    double sum = 0;
+    int count = 0;
+    for (std::size_t i = 0; i < telemetry.count; i++) {
+        if (!std::isfinite(telemetry.velocity[i])) continue;
+        sum += telemetry.velocity[i];
+        count++;
+    }
+    if (count == 0) return 0;
+    return sum / count * (drivetrain.rpm / cartridge) / 60 * M_PI * drivetrain.wheelDiameter;
+}
+
+void SlipDetector::detect(Detection& detection, SlipEvent::Type type, bool over, std::uint32_t now) {
+    if (over != detection.over) {
+        detection.over = over;
+        detection.since = now;
+    }
+    const bool active = detection.active;
+    const std::uint32_t elapsed = now - detection.since;
+    if (!active && over && elapsed >= settings.debounce) {
+        detection.active = true;
+        if (type == SlipEvent::Type::IMPACT) impacts++;
+        events.push({type, true, now});
+    } else if (active && !over && elapsed >= settings.release) {
+        detection.active = false;
+        events.push({type, false, now});
+    }
+}
+
+void SlipDetector::rebase(const lemlib::Pose& pose, const lemlib::Pose& speed, std::uint32_t now) {
+    lastTime = now;
+    lastSpeed = speed;
+    lastPose = pose;
+}
+
+void SlipDetector::update() {
+    const std::uint32_t now = pros::millis();
+    const lemlib::Pose pose = getCorrectedPose(true);
+    const lemlib::Pose speed = lemlib::getSpeed(true);
+    const float dt = (now - lastTime) / 1000.0f;
+    if (lastTime == 0 || dt <= 0) {
+        rebase(pose, speed, now);
+        return;
+    }
+
+    // a jump no robot could make is the pose being set. The odometry speed of the update that made it is off, so
+    // the reading after it is only a baseline as well
+    const float freeSpeed = drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+    if (std::hypot(pose.x - lastPose.x, pose.y - lastPose.y) > 2 * freeSpeed * dt) rebaseUntil = now + SLIP_PERIOD;
+    if (std::int32_t(rebaseUntil - now) >= 0) {
+        rebase(pose, speed, now);
+        return;
+    }
+
+    const float left = wheelSpeed(leftSampler, *drivetrain.leftMotors);
+    const float right = wheelSpeed(rightSampler, *drivetrain.rightMotors);
+    const float wheels = (left + right) / 2;
+    const pros::imu_gyro_s_t gyro = imu.get_gyro_rate();
+    const pros::imu_accel_s_t accel = imu.get_accel();
+    if (std::isfinite(accel.x) && std::isfinite(accel.y) && std::isfinite(accel.z)) {
+        // while the robot is still, the IMU only measures gravity
+        const float reading[3] = {float(accel.x), float(accel.y), float(accel.z)};
+        const bool still = std::fabs(left) < STILL_SPEED && std::fabs(right) < STILL_SPEED &&
+                           (!std::isfinite(gyro.z) || std::fabs(gyro.z) < STILL_TURN);
+        if (!still) stillSince = now;
+        if (now - stillSince >= STILL_TIME) {
+            for (int i = 0; i < 3; i++) gravity[i] += GRAVITY_FILTER * (reading[i] - gravity[i]);
+        }
+        const float x = (reading[0] - gravity[0]) * GRAVITY;
+        const float y = (reading[1] - gravity[1]) * GRAVITY;
+        imuAcceleration += ACCELERATION_FILTER * (std::hypot(x, y) - imuAcceleration);
+
+        // along the front of the robot, which is imuAngle counterclockwise from the y axis of the IMU
+        const float angle = lemlib::degToRad(settings.imuAngle);
+        imuSpeed += (y * std::cos(angle) - x * std::sin(angle)) * dt;
+    }
+    if (!spin.active) imuSpeed += dt / SPEED_TIME_CONSTANT * (wheels - imuSpeed);
+    // without tracking wheels, odometry follows the wheels while they spin, so its acceleration says nothing
+    const bool wheelOdom = spin.active && !settings.trackingWheels;
+
+    // the derivative of the global velocity includes the centripetal acceleration of a turn, like the IMU
+    const float odom = std::hypot(speed.x - lastSpeed.x, speed.y - lastSpeed.y) / dt;
+    odomAcceleration += ACCELERATION_FILTER * (odom - odomAcceleration);
+    detect(impact, SlipEvent::Type::IMPACT,
+           !wheelOdom && std::fabs(imuAcceleration - odomAcceleration) > settings.impactThreshold, now);
+
+    // the wheels spin when they drive or turn the robot faster than the IMU says it moves. Both turn rates are
+    // clockwise, and converted to the surface speed of the wheels
+    const float wheelTurn = (left - right) / 2;
+    const float imuTurn = std::isfinite(gyro.z) ? lemlib::degToRad(gyro.z) * drivetrain.trackWidth / 2 : wheelTurn;
+    const bool spinning = std::fabs(wheels) - std::fabs(imuSpeed) > settings.spinThreshold ||
+                          std::fabs(wheelTurn) - std::fabs(imuTurn) > settings.spinThreshold;
+    const bool wasSpinning = spin.active;
+    detect(spin, SlipEvent::Type::WHEEL_SPIN, spinning, now);
+    // the deceleration of an impact is over too quickly for the IMU readings to integrate, so the integrated speed
+    // keeps part of the speed from before it. Wheels that start to spin during an impact are pushing against what
+    // was hit, which is not moving
+    if (spin.active && !wasSpinning && impact.active) imuSpeed = 0;
+
+    // keep only part of the translation measured during an impact. Odometry from the drive wheels counts wheel spin
+    // as travel, so while they spin the robot moves at the speed from the IMU instead
+    lemlib::Pose corrected = pose;
+    if (impact.active) {
+        corrected.x = lastPose.x + settings.odomWeight * (pose.x - lastPose.x);
+        corrected.y = lastPose.y + settings.odomWeight * (pose.y - lastPose.y);
+        shiftPose(pose, corrected);
+    } else if (wheelOdom) {
+        corrected.x = lastPose.x + imuSpeed * dt * std::sin(pose.theta);
+        corrected.y = lastPose.y + imuSpeed * dt * std::cos(pose.theta);
+        shiftPose(pose, corrected);
+    }
+
+    lastTime = now;
+    lastSpeed = speed;
+    lastPose = corrected;
+}
+} // namespace pushback
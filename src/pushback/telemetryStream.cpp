@@ -0,0 +1,185 @@
+#include "pushback/telemetryStream.hpp"
+#include "lemlib/logger/logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace pushback {
+// type byte of each kind of frame
+constexpr std::uint8_t SCHEMA_FRAME = 0;
+constexpr std::uint8_t KEY_FRAME = 1;
+constexpr std::uint8_t DELTA_FRAME = 2;
+// samples between key frames, and between schemas. The schema is always followed by a key frame
+constexpr std::uint32_t KEY_INTERVAL = 50;
+constexpr std::uint32_t SCHEMA_INTERVAL = 200;
+// longest channel name sent
+constexpr std::size_t MAX_NAME_SIZE = 31;
+// largest frame before COBS: a schema of every channel with the longest names, and the crc
+constexpr std::size_t MAX_FRAME_SIZE = 3 + MAX_TELEMETRY_CHANNELS * (5 + MAX_NAME_SIZE) + 2;
+
+namespace {
+/**
+ * Appends little endian numbers and varints to a frame
+ */
+class FrameBuilder {
+    public:
+        void byte(std::uint8_t value) { data[size++] = value; }
+
+        void varint(std::uint32_t value) {
+            while (value >= 0x80) {
+                byte(value | 0x80);
+                value >>= 7;
+            }
+            byte(value);
+        }
+
+        void signedVarint(std::int32_t value) {
+            // zigzag, so small negative numbers stay small
+            varint((static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31));
+        }
+
+        void bytes(const void* value, std::size_t length) {
+            std::memcpy(&data[size], value, length);
+            size += length;
+        }
+
+        std::array<std::uint8_t, MAX_FRAME_SIZE> data;
+        std::size_t size = 0;
+};
+
+/**
+ * CRC-16/CCITT-FALSE
+ */
+std::uint16_t crc16(const std::uint8_t* data, std::size_t size) {
+    std::uint16_t crc = 0xFFFF;
+    for (std::size_t i = 0; i < size; i++) {
+        crc ^= data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+/**
+ * Quantize a value to a whole number of resolutions, keeping the last one if it is not a number
+ */
+std::int32_t quantize(float value, float resolution, std::int32_t last) {
+    if (std::isnan(value)) return last;
+    const double steps = std::round(double(value) / resolution);
+    return std::clamp(steps, double(std::numeric_limits<std::int32_t>::min()),
+                      double(std::numeric_limits<std::int32_t>::max()));
+}
+} // namespace
+
+TelemetryStream::TelemetryStream(std::function<void(const std::uint8_t* data, std::size_t size)> write,
+                                 std::uint32_t period)
+    : write(std::move(write)),
+      period(period) {}
+
+int TelemetryStream::addChannel(std::string_view name, float resolution, std::function<float()> read) {
+    if (task.isStarted()) {
+        lemlib::infoSink()->error("Telemetry channel {} added after the stream started", name);
+        return -1;
+    }
+    if (channelCount == MAX_TELEMETRY_CHANNELS) {
+        lemlib::infoSink()->error("TelemetryStream can only carry {} channels, {} is left out", MAX_TELEMETRY_CHANNELS,
+                                  name);
+        return -1;
+    }
+    Channel& channel = channels[channelCount];
+    channel.name = name.substr(0, MAX_NAME_SIZE);
+    channel.resolution = resolution > 0 ? resolution : 1;
+    channel.read = std::move(read);
+    return channelCount++;
+}
+
+void TelemetryStream::start() {
+    task.start(period, [this](std::uint32_t time) { sample(time); });
+}
+
+void TelemetryStream::sample(std::uint32_t time) {
+    if (samples % SCHEMA_INTERVAL == 0) {
+        FrameBuilder schema;
+        schema.byte(SCHEMA_FRAME);
+        schema.byte(sequence++);
+        schema.byte(channelCount);
+        for (std::size_t i = 0; i < channelCount; i++) {
+            schema.bytes(&channels[i].resolution, 4);
+            schema.byte(channels[i].name.size());
+            schema.bytes(channels[i].name.data(), channels[i].name.size());
+        }
+        send(schema.data.data(), schema.size);
+    }
+
+    FrameBuilder frame;
+    if (samples % KEY_INTERVAL == 0) {
+        frame.byte(KEY_FRAME);
+        frame.byte(sequence++);
+        frame.varint(time);
+        for (std::size_t i = 0; i < channelCount; i++) {
+            Channel& channel = channels[i];
+            channel.last = quantize(channel.read(), channel.resolution, channel.last);
+            frame.signedVarint(channel.last);
+        }
+    } else {
+        frame.byte(DELTA_FRAME);
+        frame.byte(sequence++);
+        frame.varint(time - lastTime);
+        // the mask goes before the changes, but is only known after them
+        std::array<std::int32_t, MAX_TELEMETRY_CHANNELS> changes;
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < channelCount; i++) {
+            Channel& channel = channels[i];
+            const std::int32_t value = quantize(channel.read(), channel.resolution, channel.last);
+            // wraps the same way in the decoder
+            changes[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(value) - channel.last);
+            if (changes[i] != 0) mask |= std::uint32_t(1) << i;
+            channel.last = value;
+        }
+        frame.varint(mask);
+        for (std::size_t i = 0; i < channelCount; i++) {
+            if (changes[i] != 0) frame.signedVarint(changes[i]);
+        }
+    }
+    send(frame.data.data(), frame.size);
+    lastTime = time;
+    samples++;
+}
+
+std::uint32_t TelemetryStream::getBytesWritten() const { return bytesWritten; }
+
+void TelemetryStream::send(const std::uint8_t* frame, std::size_t size) {
+    // the frame, its crc, the COBS overhead and the delimiters
+    std::array<std::uint8_t, MAX_FRAME_SIZE + MAX_FRAME_SIZE / 254 + 4> encoded;
+    std::array<std::uint8_t, MAX_FRAME_SIZE> checked;
+    std::memcpy(checked.data(), frame, size);
+    const std::uint16_t crc = crc16(frame, size);
+    checked[size] = crc & 0xFF;
+    checked[size + 1] = crc >> 8;
+    size += 2;
+
+    // COBS: each 0x00 is replaced by the distance to the next one, so the frame only has 0x00 at its ends
+    std::size_t out = 0;
+    encoded[out++] = 0;
+    std::size_t code = out++;
+    std::uint8_t distance = 1;
+    for (std::size_t i = 0; i < size; i++) {
+        if (checked[i] == 0) {
+            encoded[code] = distance;
+            code = out++;
+            distance = 1;
+        } else {
+            encoded[out++] = checked[i];
+            if (++distance == 0xFF) {
+                encoded[code] = distance;
+                code = out++;
+                distance = 1;
+            }
+        }
+    }
+    encoded[code] = distance;
+    encoded[out++] = 0;
+    if (write) write(encoded.data(), out);
+    bytesWritten.fetch_add(out, std::memory_order_relaxed);
+}
+} // namespace pushback
@@ -0,0 +1,89 @@
+#include "pushback/thermal.hpp"
+#include "pros/error.h"
+#include "pros/rtos.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pushback {
+// the motor reports its temperature rounded down to steps this large, in degrees
+constexpr float SENSOR_RESOLUTION = 5;
+// how fast the estimate is pulled towards the reported temperature, per second
+constexpr float CORRECTION_GAIN = 0.1;
+// fastest the current limit moves, in milliamps per second. Keeps the limit from chasing its own effect on current
+constexpr float LIMIT_SLEW = 250;
+// smallest change of the current limit worth sending to the motors, in milliamps
+constexpr float LIMIT_STEP = 25;
+
+ThermalGovernor::ThermalGovernor(std::initializer_list<pros::MotorGroup*> groups, ThermalSettings settings,
+                                 std::uint32_t period)
+    : groups(groups),
+      settings(settings),
+      period(period),
+      currentLimit(settings.maxCurrent),
+      state({0, {}, {}, settings.maxCurrent, 0}) {
+    for (const pros::MotorGroup* group : groups) samplers.emplace_back(*group);
+}
+
+void ThermalGovernor::start() {
+    task.start(period, [this](std::uint32_t) { update(period / 1000.0f); });
+}
+
+ThermalState ThermalGovernor::getState() const { return state.load(); }
+
+float ThermalGovernor::predict(float temperature, float current, float time) const {
+    const float steady = settings.ambient + settings.heating * current * current / settings.cooling;
+    return steady + (temperature - steady) * std::exp(-settings.cooling * time);
+}
+
+float ThermalGovernor::timeToCutoff(float temperature, float current) const {
+    if (temperature >= settings.cutoff) return 0;
+    const float steady = settings.ambient + settings.heating * current * current / settings.cooling;
+    if (steady <= settings.cutoff) return std::numeric_limits<float>::infinity();
+    return std::log((steady - temperature) / (steady - settings.cutoff)) / settings.cooling;
+}
+
+void ThermalGovernor::update(float dt) {
+    ThermalState next {0, {}, {}, 0, pros::millis()};
+    float hottest = settings.ambient;
+    for (const MotorSampler& sampler : samplers) {
+        sampler.snapshot(telemetry);
+        for (std::size_t i = 0; i < telemetry.count && next.count < MAX_THERMAL_MOTORS; i++) {
+            const std::size_t motor = next.count++;
+            float& estimate = estimates[motor];
+            const double measured = telemetry.temperature[i];
+            // unplugged motors keep their last estimate until they come back
+            if (!std::isfinite(measured) || telemetry.current[i] == PROS_ERR) {
+                next.temperature[motor] = estimate;
+                next.timeToCutoff[motor] = std::numeric_limits<float>::infinity();
+                continue;
+            }
+            const float current = telemetry.current[i] / 1000.0f;
+            // the true temperature is somewhere in the step above the reading
+            const float middle = measured + SENSOR_RESOLUTION / 2;
+            if (estimate == 0) estimate = middle;
+            estimate += dt * (settings.heating * current * current - settings.cooling * (estimate - settings.ambient));
+            estimate += dt * CORRECTION_GAIN * (middle - estimate);
+            estimate = std::clamp<float>(estimate, measured, measured + SENSOR_RESOLUTION);
+
+            next.temperature[motor] = estimate;
+            next.timeToCutoff[motor] = timeToCutoff(estimate, current);
+            hottest = std::max(hottest, predict(estimate, current, settings.horizon));
+        }
+    }
+
+    // lower the limit as the hottest motor is predicted to go from the soft limit to the cutoff
+    const float range = std::max(settings.cutoff - settings.softLimit, 1.0f);
+    const float overheat = std::clamp((hottest - settings.softLimit) / range, 0.0f, 1.0f);
+    const float target = settings.maxCurrent * (1 - (1 - settings.minScale) * overheat);
+    const float step = LIMIT_SLEW * dt;
+    const float limit = std::clamp(target, currentLimit - step, currentLimit + step);
+    if (std::fabs(limit - currentLimit) >= LIMIT_STEP || (target == settings.maxCurrent && limit != currentLimit)) {
+        currentLimit = limit;
+        for (pros::MotorGroup* group : groups) group->set_current_limit_all(std::lround(currentLimit));
+    }
+
+    next.currentLimit = currentLimit;
+    state.store(next);
+}
+} // namespace pushback
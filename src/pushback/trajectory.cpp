@@ -0,0 +1,67 @@
+#include "pushback/trajectory.hpp"
+#include "lemlib/util.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pushback {
+// slowest average speed used to integrate time, so a path that starts and ends at rest still takes finite time, in
+// inches per second
+constexpr float MIN_AVERAGE_SPEED = 2;
+
+Trajectory::Trajectory(const Path& path)
+    : path(path),
+      times(path.size()),
+      headings(path.size()) {
+    const std::size_t last = path.size() - 1;
+    for (std::size_t i = 1; i <= last; i++) {
+        const float ds = path[i].distance - path[i - 1].distance;
+        const float speed = std::max((path[i].velocity + path[i - 1].velocity) / 2, MIN_AVERAGE_SPEED);
+        times[i] = times[i - 1] + ds / speed;
+    }
+    // tangent from the neighbouring points, repeated points keep the heading before them
+    float heading = std::atan2(path[1].x - path[0].x, path[1].y - path[0].y);
+    for (std::size_t i = 0; i <= last; i++) {
+        const PathPoint& before = path[i > 0 ? i - 1 : 0];
+        const PathPoint& after = path[std::min(i + 1, last)];
+        if (std::hypot(after.x - before.x, after.y - before.y) > 1e-4f) {
+            heading = std::atan2(after.x - before.x, after.y - before.y);
+        }
+        headings[i] = heading;
+    }
+    // unwrap so headings can be interpolated
+    for (std::size_t i = 1; i <= last; i++) {
+        headings[i] = headings[i - 1] + lemlib::angleError(headings[i], headings[i - 1]);
+    }
+}
+
+TrajectoryState Trajectory::sample(float time) {
+    const std::size_t last = path.size() - 1;
+    // at rest on the last point once the trajectory is over
+    if (time >= times[last]) return {path[last].x, path[last].y, headings[last], path[last].distance, 0, 0, 0};
+    const float t = std::max(time, 0.0f);
+    if (cursor > 0 && times[cursor] > t) {
+        cursor = std::upper_bound(times.begin(), times.end(), t) - times.begin();
+        cursor = cursor > 0 ? cursor - 1 : 0;
+    }
+    while (cursor + 1 < last && times[cursor + 1] <= t) cursor++;
+
+    const PathPoint& start = path[cursor];
+    const PathPoint& end = path[cursor + 1];
+    const float duration = times[cursor + 1] - times[cursor];
+    const float fraction = duration > 0 ? (t - times[cursor]) / duration : 0;
+    const auto lerp = [fraction](float a, float b) { return a + fraction * (b - a); };
+    const float velocity = lerp(start.velocity, end.velocity);
+    const float acceleration = duration > 0 ? (end.velocity - start.velocity) / duration : 0;
+    // turn rate from the headings rather than the stored curvature, so the two agree
+    const float angularVelocity = duration > 0 ? (headings[cursor + 1] - headings[cursor]) / duration : 0;
+    return {lerp(start.x, end.x),
+            lerp(start.y, end.y),
+            lerp(headings[cursor], headings[cursor + 1]),
+            lerp(start.distance, end.distance),
+            velocity,
+            acceleration,
+            angularVelocity};
+}
+
+float Trajectory::getDuration() const { return times.back(); }
+} // namespace pushback
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Compile a JerryIO LemLib path (static/*.txt) into the binary format read by pushback::Path.
+
+The layout must match include/pushback/path.hpp. Everything is little endian and 4 byte aligned:
+
+    header  magic "PBP1", point count (u32), total arc length (f32), reserved (u32)
+    points  x, y, speed, distance, curvature, velocity (f32 each), one per path point
+
+speed is the 0-127 value from the text file. distance is the arc length from the first point, curvature is signed
+(positive turns right, i.e. clockwise) in 1/inches, and velocity is the target speed in inches per second, limited
+by curvature and by how fast the robot can accelerate and stop.
+"""
+
+import argparse
+import math
+import struct
+import sys
+
+MAGIC = b"PBP1"
+
+
+def read_points(path):
+    points = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line == "endData" or line.startswith("#PATH"):
+                break
+            if not line:
+                continue
+            x, y, speed = (float(value) for value in line.split(",")[:3])
+            points.append((x, y, speed))
+    return strip_padding(points, path)
+
+
+def strip_padding(points, path):
+    """Drop the padding JerryIO adds past the end of the path, and refuse a path that stops before its end"""
+    # JerryIO ends the path with a point at speed 0, then repeats it and adds points past the end so LemLib's
+    # lookahead has something to aim at. The padding is not part of the path
+    moving = [i for i, (_, _, speed) in enumerate(points) if speed != 0]
+    if not moving:
+        sys.exit(f"{path}: every point has speed 0")
+    last = moving[-1]
+    stops = [i for i in range(1, last) if points[i][2] == 0]
+    if stops:
+        sys.exit(f"{path}: point {stops[0] + 1} has speed 0 before the end of the path")
+    end = last + 1
+    if end >= len(points):
+        return points
+    padding = points[end + 1 :]
+    if padding and padding[0][:2] != points[end][:2]:
+        sys.exit(f"{path}: the points after the end, point {end + 1}, are not JerryIO's padding")
+    return points[: end + 1]
+
+
+def curvature(a, b, c):
+    # circle through three points, signed so clockwise (right) turns are positive
+    cross = (b[0] - a[0]) * (c[1] - b[1]) - (b[1] - a[1]) * (c[0] - b[0])
+    product = math.dist(a, b) * math.dist(b, c) * math.dist(a, c)
+    return 0.0 if product < 1e-9 else -2 * cross / product
+
+
+def compile_path(points, free_speed, max_accel, max_lateral_accel):
+    distances = [0.0]
+    for a, b in zip(points, points[1:]):
+        distances.append(distances[-1] + math.dist(a[:2], b[:2]))
+    curvatures = [0.0] * len(points)
+    for i in range(1, len(points) - 1):
+        curvatures[i] = curvature(points[i - 1][:2], points[i][:2], points[i + 1][:2])
+
+    velocities = []
+    for (_, _, speed), k in zip(points, curvatures):
+        velocity = speed / 127 * free_speed
+        if abs(k) > 1e-6:
+            velocity = min(velocity, math.sqrt(max_lateral_accel / abs(k)))
+        velocities.append(velocity)
+    # start and end at rest
+    velocities[0] = 0.0
+    velocities[-1] = 0.0
+    for i in range(1, len(points)):
+        ds = distances[i] - distances[i - 1]
+        velocities[i] = min(velocities[i], math.sqrt(velocities[i - 1] ** 2 + 2 * max_accel * ds))
+    for i in range(len(points) - 2, -1, -1):
+        ds = distances[i + 1] - distances[i]
+        velocities[i] = min(velocities[i], math.sqrt(velocities[i + 1] ** 2 + 2 * max_accel * ds))
+
+    data = bytearray(MAGIC)
+    data += struct.pack("<IfI", len(points), distances[-1], 0)
+    for (x, y, speed), distance, k, velocity in zip(points, distances, curvatures, velocities):
+        data += struct.pack("<6f", x, y, speed, distance, k, velocity)
+    return bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="JerryIO path file")
+    parser.add_argument("output", help="binary path file")
+    # no defaults, the build passes the drivetrain's limits from the Makefile
+    parser.add_argument("--free-speed", type=float, required=True, help="wheel speed at 127 power, in/s")
+    parser.add_argument("--max-accel", type=float, required=True, help="in/s^2")
+    parser.add_argument("--max-lateral-accel", type=float, required=True, help="in/s^2")
+    args = parser.parse_args()
+
+    points = read_points(args.input)
+    if len(points) < 2:
+        sys.exit(f"{args.input}: a path needs at least 2 points")
+    data = compile_path(points, args.free_speed, args.max_accel, args.max_lateral_accel)
+    with open(args.output, "wb") as f:
+        f.write(data)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Decode a pushback::FlightRecorder recording (/usd/flightNNN.bin) into CSV files.
+
+The layout must match include/pushback/flightRecorder.hpp. Everything is little endian:
+
+    header   magic "PBF1", period (u16), left motor count (u8), right motor count (u8), 16 ports (i8 each)
+    records  type (u8), reserved (u8), data size (u16), time in milliseconds (u32), then the data:
+             0 pose        x, y, theta, x velocity, y velocity, theta velocity (f32 each)
+             1 left motors / 2 right motors
+                           per motor: position (f32), velocity, current, voltage (i16 each), temperature, faults (u8)
+             3 controller  left x, left y, right x, right y (i8 each), buttons (u16), reserved (u16)
+             4 motion      in motion (u8), reserved (3 bytes), profile time left (f32)
+             5 dropped     number of records dropped just before this one (u32)
+
+One CSV is written per kind of record: <prefix>_pose.csv, <prefix>_motors.csv, <prefix>_controller.csv and
+<prefix>_motion.csv. The prefix is the input without its extension by default.
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+MAGIC = b"PBF1"
+HEADER = struct.Struct("<4sHBB16b")
+RECORD = struct.Struct("<BBHI")
+POSE = struct.Struct("<6f")
+MOTOR = struct.Struct("<fhhhBB")
+CONTROLLER = struct.Struct("<4bHH")
+MOTION = struct.Struct("<B3xf")
+
+BUTTONS = ["L1", "L2", "R1", "R2", "UP", "DOWN", "LEFT", "RIGHT", "X", "B", "Y", "A"]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="recording copied from the card")
+    parser.add_argument("-o", "--output", help="prefix of the CSV files")
+    args = parser.parse_args()
+    prefix = args.output or os.path.splitext(args.input)[0]
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size or data[:4] != MAGIC:
+        sys.exit("%s is not a flight recording" % args.input)
+    header = HEADER.unpack_from(data)
+    period, left, right = header[1], header[2], header[3]
+    ports = {1: header[4 : 4 + left], 2: header[4 + left : 4 + left + right]}
+
+    files = {}
+    writers = {}
+    for name, columns in [
+        ("pose", ["time", "x", "y", "theta", "x velocity", "y velocity", "theta velocity"]),
+        ("motors", ["time", "side", "port", "position", "velocity", "current", "voltage", "temperature", "faults"]),
+        ("controller", ["time", "left x", "left y", "right x", "right y"] + BUTTONS),
+        ("motion", ["time", "in motion", "profile time left"]),
+    ]:
+        files[name] = open("%s_%s.csv" % (prefix, name), "w", newline="")
+        writers[name] = csv.writer(files[name])
+        writers[name].writerow(columns)
+
+    records = dropped = 0
+    i = HEADER.size
+    while i + RECORD.size <= len(data):
+        kind, _, size, time = RECORD.unpack_from(data, i)
+        body = data[i + RECORD.size : i + RECORD.size + size]
+        if len(body) < size:
+            # cut short by the card being pulled, or the robot turned off mid-write
+            break
+        i += RECORD.size + size
+        records += 1
+        if kind == 0:
+            writers["pose"].writerow([time] + ["%.3f" % value for value in POSE.unpack(body)])
+        elif kind in (1, 2):
+            for index, motor in enumerate(MOTOR.iter_unpack(body)):
+                port = ports[kind][index] if index < len(ports[kind]) else ""
+                side = "left" if kind == 1 else "right"
+                writers["motors"].writerow([time, side, port, "%.1f" % motor[0]] + list(motor[1:]))
+        elif kind == 3:
+            analog = CONTROLLER.unpack(body)
+            buttons = [analog[4] >> bit & 1 for bit in range(len(BUTTONS))]
+            writers["controller"].writerow([time] + list(analog[:4]) + buttons)
+        elif kind == 4:
+            in_motion, time_left = MOTION.unpack(body)
+            writers["motion"].writerow([time, in_motion, "%.3f" % time_left])
+        elif kind == 5:
+            (count,) = struct.unpack("<I", body)
+            dropped += count
+            sys.stderr.write("%d records dropped before %d ms\n" % (count, time))
+
+    for f in files.values():
+        f.close()
+    sys.stderr.write(
+        "%d records every %d ms, %d dropped, %d bytes left over\n" % (records, period, dropped, len(data) - i)
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+"""Decode the binary records of a pushback::DeferredLog back into text.
+
+The format is documented on pushback::DeferredLog in include/pushback/deferredLog.hpp. Frames are found by their sync
+bytes and checked against their checksum; anything between frames, like the text of the lemlib sinks on the same
+serial stream, is passed through unchanged, except for the frames of a pushback::TelemetryStream, which are between
+0x00 bytes and are left to tools/decode_telemetry.py. Bytes between 0x00 that do not decode and pass the CRC of a
+telemetry frame are read as text.
+
+usage: pros terminal --raw | python3 tools/decode_log.py
+       python3 tools/decode_log.py capture.bin
+"""
+
+import argparse
+import decimal
+import math
+import struct
+import sys
+
+from decode_telemetry import cobs_decode, crc16
+
+SYNC = b"\xa5\x5a"
+FORMAT_FRAME = 0
+RECORD_FRAME = 1
+
+# most bytes between the 0x00 around a TelemetryStream frame, see MAX_FRAME_SIZE in src/pushback/telemetryStream.cpp
+MAX_TELEMETRY_FRAME = 1162
+
+# lemlib::Level, in the order of the enum
+LEVELS = ["INFO", "DEBUG", "WARN", "ERROR", "FATAL"]
+
+
+class Number:
+    """A float printed the way fmt prints it: the shortest digits that read back as the same value"""
+
+    def __init__(self, value, code):
+        self.value = value
+        self.code = code
+
+    def __format__(self, spec):
+        if spec or not math.isfinite(self.value):
+            return format(self.value, spec)
+        for precision in range(17):
+            text = "%.*e" % (precision, self.value)
+            if struct.unpack(self.code, struct.pack(self.code, float(text)))[0] == self.value:
+                break
+        mantissa, exponent = text.split("e")
+        # like fmt, fixed notation unless the exponent is below -4 or from 16 up
+        if -4 <= int(exponent) < 16:
+            text = format(decimal.Decimal(text), "f")
+            return text.rstrip("0").rstrip(".") if "." in text else text
+        return "%se%s%02d" % (mantissa, "-" if int(exponent) < 0 else "+", abs(int(exponent)))
+
+
+class Pose:
+    """A lemlib::Pose, printed the way lemlib's format_as prints it"""
+
+    def __init__(self, x, y, theta):
+        self.x, self.y, self.theta = x, y, theta
+
+    def __format__(self, spec):
+        x, y, theta = (Number(value, "<f") for value in (self.x, self.y, self.theta))
+        return format("lemlib::Pose {{ x: {}, y: {}, theta: {} }}".format(x, y, theta), spec)
+
+
+def read_args(body):
+    """Read the tagged arguments of a record"""
+    args = []
+    i = 0
+    while i < len(body):
+        tag = body[i]
+        i += 1
+        if tag == 0:
+            args.append("true" if body[i] else "false")
+            i += 1
+        elif tag in (1, 2, 3, 4):
+            code, size = {1: ("<i", 4), 2: ("<I", 4), 3: ("<q", 8), 4: ("<Q", 8)}[tag]
+            args.append(struct.unpack_from(code, body, i)[0])
+            i += size
+        elif tag == 5:
+            args.append(Number(struct.unpack_from("<f", body, i)[0], "<f"))
+            i += 4
+        elif tag == 6:
+            args.append(Number(struct.unpack_from("<d", body, i)[0], "<d"))
+            i += 8
+        elif tag == 7:
+            length = body[i]
+            args.append(body[i + 1 : i + 1 + length].decode("utf-8", "replace"))
+            i += 1 + length
+        elif tag == 8:
+            args.append(Pose(*struct.unpack_from("<3f", body, i)))
+            i += 12
+        elif tag == 9:
+            args.append(chr(body[i]))
+            i += 1
+        else:
+            break
+    return args
+
+
+def is_telemetry(chunk):
+    """Check whether the bytes between two 0x00 are a frame of a pushback::TelemetryStream, as decode_telemetry.py
+    reads them"""
+    frame = cobs_decode(chunk)
+    if frame is None or len(frame) < 4:
+        return False
+    return crc16(frame[:-2]) == struct.unpack_from("<H", frame, len(frame) - 2)[0]
+
+
+class Missing:
+    """Stands in for an argument that did not fit in the record"""
+
+    def __format__(self, spec):
+        return "?"
+
+
+class Decoder:
+    def __init__(self, out):
+        self.out = out
+        self.formats = {}
+        self.pending = b""
+
+    def feed(self, data):
+        self.pending += data
+        while True:
+            start = self.pending.find(SYNC)
+            delimiter = self.pending.find(b"\0")
+            if delimiter >= 0 and (start < 0 or delimiter < start):
+                self.text(self.pending[:delimiter])
+                self.pending = self.pending[delimiter:]
+                end = self.pending.find(b"\0", 1)
+                if end < 0 and len(self.pending) - 1 <= MAX_TELEMETRY_FRAME:
+                    # the rest of the telemetry frame may still be on its way
+                    return
+                if end >= 0 and is_telemetry(self.pending[1:end]):
+                    self.pending = self.pending[end + 1 :]
+                else:
+                    # not a telemetry frame, the 0x00 is read past like text
+                    self.pending = self.pending[1:]
+                continue
+            if start < 0:
+                # keep a trailing first sync byte, it may start a frame
+                keep = 1 if self.pending.endswith(SYNC[:1]) else 0
+                self.text(self.pending[: len(self.pending) - keep])
+                self.pending = self.pending[len(self.pending) - keep :]
+                return
+            self.text(self.pending[:start])
+            self.pending = self.pending[start:]
+            if len(self.pending) < 4 or len(self.pending) < 5 + self.pending[3]:
+                return
+            kind, length = self.pending[2], self.pending[3]
+            body = self.pending[4 : 4 + length]
+            if (kind + length + sum(body)) & 0xFF != self.pending[4 + length]:
+                # not a frame, the sync bytes were part of the text
+                self.text(self.pending[:1])
+                self.pending = self.pending[1:]
+                continue
+            self.frame(kind, body)
+            self.pending = self.pending[5 + length :]
+
+    def text(self, data):
+        if data:
+            self.out.write(data.decode("utf-8", "replace"))
+
+    def frame(self, kind, body):
+        if kind == FORMAT_FRAME:
+            self.formats[body[0]] = body[1:].decode("utf-8", "replace")
+        elif kind == RECORD_FRAME and len(body) >= 6:
+            ident, level = body[0], body[1]
+            (time,) = struct.unpack_from("<I", body, 2)
+            try:
+                args = read_args(body[6:])
+            except (IndexError, struct.error):
+                args = []
+            fmt = self.formats.get(ident)
+            if fmt is None:
+                message = "<unknown format %d> %s" % (ident, " ".join(format(arg) for arg in args))
+            else:
+                try:
+                    message = fmt.format(*args, *[Missing()] * fmt.count("{"))
+                except (ValueError, IndexError, KeyError) as error:
+                    message = "<%s: %s> %s" % (error, fmt, " ".join(format(arg) for arg in args))
+            name = LEVELS[level] if level < len(LEVELS) else str(level)
+            self.out.write("[%d] %s: %s\n" % (time, name, message))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", help="captured stream, stdin by default")
+    args = parser.parse_args()
+    stream = open(args.input, "rb") if args.input else sys.stdin.buffer
+    decoder = Decoder(sys.stdout)
+    while True:
+        data = stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+        if not data:
+            break
+        decoder.feed(data)
+        sys.stdout.flush()
+    decoder.text(decoder.pending)
+
+
+if __name__ == "__main__":
+    main()
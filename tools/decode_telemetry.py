@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""Decode the frames of a pushback::TelemetryStream into a table, one row per sample.
+
+The format is documented on pushback::TelemetryStream in include/pushback/telemetryStream.hpp. Frames are the bytes
+between two 0x00 delimiters; anything that does not decode and pass its CRC, like text on the same serial stream, is
+skipped. After a lost frame, noticed by a gap in the sequence numbers, samples are skipped until the next key frame.
+
+The table is written as CSV, with a time column in milliseconds then a column per channel. With --parquet, it is also
+written as a Parquet file, if pyarrow is installed.
+
+usage: pros terminal --raw | python3 tools/decode_telemetry.py -o run.csv
+       python3 tools/decode_telemetry.py capture.bin --parquet run.parquet
+"""
+
+import argparse
+import csv
+import math
+import struct
+import sys
+
+SCHEMA_FRAME = 0
+KEY_FRAME = 1
+DELTA_FRAME = 2
+
+
+def cobs_decode(data):
+    """Undo COBS, or return None if the data is not valid COBS"""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1 : i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+class Reader:
+    """Reads the varints of a frame body"""
+
+    def __init__(self, data):
+        self.data = data
+        self.i = 0
+
+    def byte(self):
+        value = self.data[self.i]
+        self.i += 1
+        return value
+
+    def varint(self):
+        value = shift = 0
+        while True:
+            byte = self.byte()
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value & 0xFFFFFFFF
+
+    def signed(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+
+def wrap(value):
+    """Wrap to an int32, like the brain does"""
+    return (value + 2**31) % 2**32 - 2**31
+
+
+class Decoder:
+    def __init__(self, row):
+        self.row = row
+        self.names = None
+        self.resolutions = None
+        self.values = None
+        self.time = 0
+        self.sequence = None
+        self.pending = b""
+        self.frames = 0
+        self.skipped = 0
+        self.lost = 0
+        self.samples = 0
+
+    def feed(self, data):
+        chunks = (self.pending + data).split(b"\0")
+        self.pending = chunks.pop()
+        for chunk in chunks:
+            if chunk:
+                self.chunk(chunk)
+
+    def chunk(self, chunk):
+        frame = cobs_decode(chunk)
+        if frame is None or len(frame) < 4 or crc16(frame[:-2]) != struct.unpack_from("<H", frame, len(frame) - 2)[0]:
+            # text, or a damaged frame. A lost frame shows up as a gap in the sequence
+            self.skipped += 1
+            return
+        self.frames += 1
+        kind, sequence, body = frame[0], frame[1], frame[2:-2]
+        if self.sequence is not None and sequence != (self.sequence + 1) & 0xFF:
+            # the values can not be followed through the lost frame
+            self.lost += (sequence - self.sequence - 1) & 0xFF
+            self.values = None
+        self.sequence = sequence
+        try:
+            self.frame(kind, Reader(body))
+        except IndexError:
+            self.values = None
+
+    def frame(self, kind, reader):
+        if kind == SCHEMA_FRAME:
+            count = reader.byte()
+            names, resolutions = [], []
+            for _ in range(count):
+                resolutions.append(struct.unpack("<f", bytes(reader.byte() for _ in range(4)))[0])
+                length = reader.byte()
+                names.append(bytes(reader.byte() for _ in range(length)).decode("utf-8", "replace"))
+            self.names, self.resolutions = names, resolutions
+        elif self.names is None:
+            return
+        elif kind == KEY_FRAME:
+            self.time = reader.varint()
+            self.values = [reader.signed() for _ in self.names]
+            self.emit()
+        elif kind == DELTA_FRAME and self.values is not None:
+            self.time = (self.time + reader.varint()) & 0xFFFFFFFF
+            mask = reader.varint()
+            for i in range(len(self.values)):
+                if mask >> i & 1:
+                    self.values[i] = wrap(self.values[i] + reader.signed())
+            self.emit()
+
+    def emit(self):
+        self.samples += 1
+        values = [value * resolution for value, resolution in zip(self.values, self.resolutions)]
+        self.row(self.names, self.resolutions, self.time, values)
+
+
+class Table:
+    """Collects the rows, writing the CSV as they come and keeping columns for Parquet"""
+
+    def __init__(self, out, columnar):
+        self.writer = csv.writer(out)
+        self.names = None
+        self.resolutions = None
+        self.decimals = None
+        self.columns = {} if columnar else None
+
+    def row(self, names, resolutions, time, values):
+        if names != self.names:
+            self.names = names
+            self.writer.writerow(["time"] + names)
+        if resolutions != self.resolutions:
+            # enough decimals to show the resolution of each channel
+            self.resolutions = resolutions
+            self.decimals = [max(0, math.ceil(-math.log10(res) - 1e-6)) for res in resolutions]
+        self.writer.writerow([time] + ["%.*f" % (decimals, value) for decimals, value in zip(self.decimals, values)])
+        if self.columns is not None:
+            self.columns.setdefault("time", []).append(time)
+            for name, value in zip(names, values):
+                column = self.columns.setdefault(name, [None] * (len(self.columns["time"]) - 1))
+                column.append(value)
+            # channels missing from this schema stay empty
+            for column in self.columns.values():
+                column.extend([None] * (len(self.columns["time"]) - len(column)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", help="captured stream, stdin by default")
+    parser.add_argument("-o", "--output", help="CSV file, stdout by default")
+    parser.add_argument("--parquet", help="also write the table to this Parquet file")
+    args = parser.parse_args()
+
+    if args.parquet:
+        try:
+            import pyarrow
+            import pyarrow.parquet
+        except ImportError:
+            parser.error("--parquet needs pyarrow: pip install pyarrow")
+
+    stream = open(args.input, "rb") if args.input else sys.stdin.buffer
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    table = Table(out, args.parquet is not None)
+    decoder = Decoder(table.row)
+    while True:
+        data = stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+        if not data:
+            break
+        decoder.feed(data)
+        out.flush()
+    if args.output:
+        out.close()
+
+    if args.parquet and table.columns:
+        pyarrow.parquet.write_table(pyarrow.table(table.columns), args.parquet)
+    sys.stderr.write(
+        "%d samples from %d frames, %d frames lost, %d pieces of text or damaged frames skipped\n"
+        % (decoder.samples, decoder.frames, decoder.lost, decoder.skipped)
+    )
+
+
+if __name__ == "__main__":
+    main()